@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "diagnostics.h"
+#include "assembler_api.h"
+
+/*
+Test of the embeddable assembler (make api-test), linked against lib/libassembler.a:
+assembles a good & a bad source held in memory with one context, and checks their outputs & diagnostics,
+then checks that a source name with no room for an extension is rejected.
+*/
+
+static const char good_source[] =
+    ".entry MAIN\n"
+    ".extern FN\n"
+    "MAIN:   inc r1\n"
+    "        jsr FN\n"
+    "        stop\n"
+    "NUM:    .data 7\n";
+
+static const char good_object[] =
+    "bb b\n"
+    "bcba bdada\n"
+    "bcbb aaaba\n"
+    "bcbc cdaba\n"
+    "bcbd aaaab\n"
+    "bcca ddaaa\n"
+    "bccb aaabd\n";
+
+static const char good_entries[] = "MAIN bcba\n";
+
+static const char good_externs[] = "FN bcbd\n";
+
+static const char bad_source[] =
+    "MAIN:   inc r1\n"
+    "        jmp\n"
+    "X:      .data 3\n";
+
+#define BAD_LINE 2                   /* line of the jmp without an operand */
+#define LONG_NAME_LENGTH 200         /* source name with no room for an extension */
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to check that an output of the last assembled source holds the expected text.
+Receives: const AssemblerContext *context - Context that assembled the source
+          int output - Output to check (ASSEMBLER_OUTPUT_*)
+          const char *expected - Expected text, NULL if the output must not be produced
+Returns: int - TRUE if output matches, FALSE otherwise (reported)
+*/
+static int check_output(const AssemblerContext *context, int output, const char *expected) {
+    size_t length;
+    const char *text = get_assembler_output(context, output, &length);
+
+    if (!expected && !text)
+        return TRUE;
+
+    if (expected && text && (length == strlen(expected)) && (memcmp(text, expected, length) == 0))
+        return TRUE;
+
+    printf("FAIL: output %d is %s%c", output, text ? text : "(not produced)", NEWLINE);
+    return FALSE;
+}
+
+/*
+Function to assemble the good source: its .ob/.ent/.ext outputs match the command line assembler, with no diagnostics.
+Receives: AssemblerContext *context - Context to assemble with
+Returns: int - TRUE if all checks passed, FALSE otherwise
+*/
+static int test_good_source(AssemblerContext *context) {
+    int result = TRUE;
+
+    if (!assemble_source_buffer(context, "prog", good_source, strlen(good_source))) {
+        printf("FAIL: good source was not assembled%c", NEWLINE);
+        return FALSE;
+    }
+    if (get_diagnostic_count(context) != 0) {
+        printf("FAIL: good source has %d diagnostics%c", get_diagnostic_count(context), NEWLINE);
+        result = FALSE;
+    }
+    return check_output(context, ASSEMBLER_OUTPUT_OBJECT, good_object) &&
+           check_output(context, ASSEMBLER_OUTPUT_ENTRY, good_entries) &&
+           check_output(context, ASSEMBLER_OUTPUT_EXTERN, good_externs) && result;
+}
+
+/*
+Function to assemble the bad source after the good one: no object is produced,
+and its errors are reported at the offending line (none is left from the good source).
+Receives: AssemblerContext *context - Context that assembled the good source
+Returns: int - TRUE if all checks passed, FALSE otherwise
+*/
+static int test_bad_source(AssemblerContext *context) {
+    const Diagnostic *diagnostic;
+    int i, count, result = TRUE;
+
+    if (assemble_source_buffer(context, "bad", bad_source, strlen(bad_source))) {
+        printf("FAIL: bad source was assembled%c", NEWLINE);
+        return FALSE;
+    }
+    count = get_diagnostic_count(context);
+
+    if (count != 2) {
+        printf("FAIL: bad source has %d diagnostics, expected 2%c", count, NEWLINE);
+        result = FALSE;
+    }
+    for (i = 0; i < count; i++) {
+        diagnostic = get_diagnostic(context, i);
+
+        if ((diagnostic->severity != DIAGNOSTIC_ERROR) || (diagnostic->line_num != BAD_LINE)) {
+            printf("FAIL: unexpected diagnostic %s at line %d%c", diagnostic->message, diagnostic->line_num, NEWLINE);
+            result = FALSE;
+        }
+    }
+    return check_output(context, ASSEMBLER_OUTPUT_OBJECT, NULL) && result;
+}
+
+/*
+Function to assemble a source whose name leaves no room for an extension: it is rejected with a single error.
+Receives: AssemblerContext *context - Context to assemble with
+Returns: int - TRUE if all checks passed, FALSE otherwise
+*/
+static int test_long_name(AssemblerContext *context) {
+    char name[LONG_NAME_LENGTH + 1];
+
+    memset(name, 'a', LONG_NAME_LENGTH);
+    name[LONG_NAME_LENGTH] = NULL_TERMINATOR;
+
+    if (assemble_source_buffer(context, name, good_source, strlen(good_source)) || (get_diagnostic_count(context) != 1)) {
+        printf("FAIL: source with a too long name was not rejected%c", NEWLINE);
+        return FALSE;
+    }
+    return check_output(context, ASSEMBLER_OUTPUT_OBJECT, NULL);
+}
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point to the library test.
+Returns: int - 0 if all checks passed, 1 otherwise
+*/
+int main(void) {
+    AssemblerContext *context = create_assembler_context();
+    int result;
+
+    if (!context)
+        return 1;
+
+    result = test_good_source(context) && test_bad_source(context) && test_long_name(context);
+    free_assembler_context(context);
+
+    if (!result)
+        return 1;
+
+    printf("Library tests passed%c", NEWLINE);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "diagnostics.h"
+#include "binary_object.h"
+#include "archive.h"
+
+/*
+Archiver of binary objects (./assembler --binary) into a static library for the linker (-l).
+Bundles the objects into a single .lib file, with an index of the entry symbols of all members,
+so the linker reads only the index and the members it needs.
+*/
+
+#define ARCHIVER_OPTION_LIST "-t"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to print the members and the symbol index of an archive.
+Receives: const char *base_filename - Archive filename without extension
+Returns: int - TRUE if archive was listed, FALSE if missing / invalid
+*/
+static int list_archive(const char *base_filename) {
+    const unsigned char *directory;
+    unsigned long i, record, name;
+    Archive archive;
+
+    if (!open_archive(&archive, base_filename))
+        return FALSE;
+
+    directory = ARCHIVE_DIRECTORY(&archive);
+    print_message("%s%s: %lu members, %lu index slots%c", base_filename, FILE_EXT_ARCHIVE,
+                  archive.member_count, archive.slot_count, NEWLINE);
+
+    for (i = 0, record = archive.members_offset; i < archive.member_count; i++, record += ARCHIVE_MEMBER_SIZE) {
+        print_message("member %s (%lu bytes)%c", get_archive_member_name(&archive, i),
+                      BINARY_U32(directory, record + ARCHIVE_MEMBER_LENGTH), NEWLINE);
+    }
+    for (i = 0, record = archive.index_offset; i < archive.slot_count; i++, record += ARCHIVE_SLOT_SIZE) {
+        name = BINARY_U32(directory, record + ARCHIVE_SLOT_NAME);
+
+        if (name != ARCHIVE_EMPTY_SLOT)
+            print_message("symbol %s -> %s%c", archive.directory.text + archive.strings_offset + name,
+                          get_archive_member_name(&archive, BINARY_U32(directory, record + ARCHIVE_SLOT_MEMBER)), NEWLINE);
+    }
+    close_archive(&archive);
+    return TRUE;
+}
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point to the archiver program.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments (archive & object base filenames, or -t & archive)
+Returns: int - 0 if archive was written / listed, 1 otherwise
+*/
+int main(int argc, char *argv[]) {
+    if ((argc == 3) && (strcmp(argv[1], ARCHIVER_OPTION_LIST) == 0))
+        return list_archive(argv[2]) ? 0 : 1;
+
+    if ((argc < 3) || (argv[1][0] == '-')) {
+        print_error("Expected different app call", "./archiver <archive> <object1> [object2] ... | ./archiver -t <archive>");
+        return 1;
+    }
+    if (!write_archive(argv[1], argv + 2, argc - 2))
+        return 1;
+
+    print_message("Archived %d objects into %s%s%c", argc - 2, argv[1], FILE_EXT_ARCHIVE, NEWLINE);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,400 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Deterministic generator of synthetic .as workloads for the benchmark suite.
+Every generated file assembles without errors: word costing statements stop once
+the memory budget of the 10-bit machine (IC / DC limits) is spent, the remaining
+lines become comments, extern declarations & macro definitions (table & preprocessing load).
+*/
+
+#define FALSE 0
+#define TRUE 1
+
+/* Memory budget, kept under the assembler IC (156) & DC (100) limits */
+#define IC_BUDGET 150
+#define DC_BUDGET 95
+
+#define MACRO_LINE_WORDS 2    /* "inc rN" body line: instruction + register word */
+
+#define MAX_PATH_LENGTH 256
+#define PERCENT 100
+
+/* 31-bit linear congruential generator (same sequence on every libc) */
+#define LCG_MULTIPLIER 1103515245UL
+#define LCG_INCREMENT 12345UL
+#define LCG_MASK 0x7FFFFFFFUL
+
+/* Generator parameters (command line) */
+typedef struct {
+    long files;                  /* -f number of files */
+    long lines;                  /* -l lines per file */
+    int label_percent;           /* -L statements carrying a label */
+    long macros;                 /* -m macro definitions per file */
+    int macro_body;              /* -b lines per macro body */
+    int extern_percent;          /* -x lines that are .extern declarations */
+    int entry_percent;           /* -e labels exported with .entry */
+    int data_percent;            /* -d statements that are .data / .string / .mat */
+    unsigned long seed;          /* -s random seed */
+    const char *prefix;          /* output path prefix (<prefix>_<n>.as) */
+} WorkloadOptions;
+
+/* State of the file being generated */
+typedef struct {
+    FILE *fp;
+    unsigned long random;
+    long lines;                  /* lines written */
+    int ic, dc;                  /* memory words spent */
+    long code_labels, data_labels, matrix_labels, externs;
+} Workload;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to draw the next pseudo random number.
+Receives: Workload *work - Generator state
+          long limit - Exclusive upper bound (> 0)
+Returns: long - Number in 0..limit-1
+*/
+static long next_random(Workload *work, long limit) {
+    work->random = (work->random * LCG_MULTIPLIER + LCG_INCREMENT) & LCG_MASK;
+
+    return (long)((work->random >> 8) % (unsigned long)limit);
+}
+
+/*
+Function to test a percentage chance.
+Receives: Workload *work - Generator state
+          int percent - Chance in percent
+Returns: int - TRUE with the given chance
+*/
+static int chance(Workload *work, int percent) {
+    return next_random(work, PERCENT) < percent;
+}
+
+/*
+Function to write a random register name (r0-r7).
+Receives: Workload *work - Generator state
+          char *buffer - Output buffer
+*/
+static void random_register(Workload *work, char *buffer) {
+    sprintf(buffer, "r%ld", next_random(work, 8));
+}
+
+/*
+Function to write a random direct operand: an earlier code label, a data label or an extern.
+Receives: Workload *work - Generator state
+          char *buffer - Output buffer
+Returns: int - TRUE if the operand is an extern reference
+*/
+static int random_label(Workload *work, char *buffer) {
+    long kinds = 1 + (work->code_labels > 0) + (work->data_labels > 0) + (work->externs > 0);
+    long kind = next_random(work, kinds);
+
+    if ((work->code_labels > 0) && (kind-- == 1)) {
+        sprintf(buffer, "L_%ld", next_random(work, work->code_labels));
+        return FALSE;
+    }
+    if ((work->data_labels > 0) && (kind-- == 1)) {
+        sprintf(buffer, "D_%ld", next_random(work, work->data_labels));
+        return FALSE;
+    }
+    if ((work->externs > 0) && (kind == 1)) {
+        sprintf(buffer, "X_%ld", next_random(work, work->externs));
+        return TRUE;
+    }
+    strcpy(buffer, "END"); /* forward reference, defined by the last statement */
+    return FALSE;
+}
+
+/*
+Function to write an optional label in front of a statement.
+Receives: Workload *work - Generator state
+          const WorkloadOptions *options - Generator parameters
+          char prefix - 'L' for code, 'D' for data, 'M' for matrix labels
+*/
+static void write_label(Workload *work, const WorkloadOptions *options, char prefix) {
+    if (!chance(work, options->label_percent) && (prefix != 'M'))
+        return;
+
+    if (prefix == 'L')
+        fprintf(work->fp, "L_%ld: ", work->code_labels++);
+    else if (prefix == 'D')
+        fprintf(work->fp, "D_%ld: ", work->data_labels++);
+    else
+        fprintf(work->fp, "M_%ld: ", work->matrix_labels++);
+}
+
+/*
+Function to write a random instruction statement, if the IC budget allows.
+Receives: Workload *work - Generator state
+          const WorkloadOptions *options - Generator parameters
+Returns: int - TRUE if written, FALSE if the budget is spent
+*/
+static int write_instruction(Workload *work, const WorkloadOptions *options) {
+    char a[64], b[64];
+    long kind = next_random(work, 8);
+
+    if (work->ic + 4 > IC_BUDGET) /* largest instruction */
+        return FALSE;
+
+    write_label(work, options, 'L');
+
+    switch (kind) {
+        case 0:
+            random_register(work, b);
+            fprintf(work->fp, "mov #%ld, %s\n", next_random(work, 200) - 100, b);
+            work->ic += 3;
+            break;
+        case 1:
+            random_register(work, a);
+            random_register(work, b);
+            fprintf(work->fp, "add %s, %s\n", a, b);
+            work->ic += 2;
+            break;
+        case 2:
+            random_label(work, a);
+            fprintf(work->fp, "cmp %s, #%ld\n", a, next_random(work, 200) - 100);
+            work->ic += 3;
+            break;
+        case 3:
+            random_label(work, a);
+            random_register(work, b);
+            fprintf(work->fp, "sub %s, %s\n", a, b);
+            work->ic += 3;
+            break;
+        case 4:
+            random_label(work, a);
+            fprintf(work->fp, "jmp %s\n", a);
+            work->ic += 2;
+            break;
+        case 5:
+            fprintf(work->fp, "prn #%ld\n", next_random(work, 200) - 100);
+            work->ic += 2;
+            break;
+        case 6:
+            random_label(work, a);
+            fprintf(work->fp, "inc %s\n", a);
+            work->ic += 2;
+            break;
+        default:
+            random_register(work, b);
+
+            if (work->matrix_labels > 0)
+                fprintf(work->fp, "mov M_%ld[r1][r2], %s\n", next_random(work, work->matrix_labels), b);
+            else
+                fprintf(work->fp, "lea END, %s\n", b);
+
+            work->ic += (work->matrix_labels > 0) ? 4 : 3;
+            break;
+    }
+    work->lines++;
+    return TRUE;
+}
+
+/*
+Function to write a random data statement (.data / .string / .mat), if the DC budget allows.
+Receives: Workload *work - Generator state
+          const WorkloadOptions *options - Generator parameters
+Returns: int - TRUE if written, FALSE if the budget is spent
+*/
+static int write_data(Workload *work, const WorkloadOptions *options) {
+    long i, count, kind = next_random(work, 3);
+
+    if (kind == 0) {
+        count = 1 + next_random(work, 5);
+
+        if (work->dc + count > DC_BUDGET)
+            return FALSE;
+
+        write_label(work, options, 'D');
+        fprintf(work->fp, ".data %ld", next_random(work, 1000) - 500);
+
+        for (i = 1; i < count; i++) {
+            fprintf(work->fp, ", %ld", next_random(work, 1000) - 500);
+        }
+        fprintf(work->fp, "\n");
+        work->dc += count;
+    }
+    else if (kind == 1) {
+        if (work->dc + 7 > DC_BUDGET)
+            return FALSE;
+
+        write_label(work, options, 'D');
+        fprintf(work->fp, ".string \"abc%03ld\"\n", next_random(work, 1000));
+        work->dc += 7;
+    }
+    else {
+        if (work->dc + 4 > DC_BUDGET)
+            return FALSE;
+
+        write_label(work, options, 'M');
+        fprintf(work->fp, ".mat [2][2] %ld, %ld, %ld, %ld\n", next_random(work, 9), next_random(work, 9),
+                next_random(work, 9), next_random(work, 9));
+        work->dc += 4;
+    }
+    work->lines++;
+    return TRUE;
+}
+
+/*
+Function to write the macro definitions of a file.
+Receives: Workload *work - Generator state
+          const WorkloadOptions *options - Generator parameters
+*/
+static void write_macros(Workload *work, const WorkloadOptions *options) {
+    long i;
+    int j;
+
+    for (i = 0; i < options->macros; i++) {
+        fprintf(work->fp, "mcro m_%ld\n", i);
+
+        for (j = 0; j < options->macro_body; j++) {
+            fprintf(work->fp, "    inc r%ld\n", next_random(work, 8));
+        }
+        fprintf(work->fp, "mcroend\n");
+        work->lines += options->macro_body + 2;
+    }
+}
+
+/*
+Function to write one synthetic source file.
+Receives: const WorkloadOptions *options - Generator parameters
+          long file_number - Index of file (part of name & seed)
+Returns: int - TRUE if file was written, FALSE on I/O error
+*/
+static int write_workload_file(const WorkloadOptions *options, long file_number) {
+    char path[MAX_PATH_LENGTH];
+    Workload work;
+    long i, statements, extern_count = options->lines * options->extern_percent / PERCENT;
+
+    sprintf(path, "%.200s_%ld.as", options->prefix, file_number);
+    work.fp = fopen(path, "w");
+
+    if (!work.fp) {
+        fprintf(stderr, "Error: Failed to write to file (%s)\n", path);
+        return FALSE;
+    }
+    work.random = (options->seed + (unsigned long)file_number * 7919UL) & LCG_MASK;
+    work.lines = 0;
+    work.ic = 1; /* reserved for the final "END: stop" */
+    work.dc = 0;
+    work.code_labels = work.data_labels = work.matrix_labels = 0;
+    work.externs = 0;
+
+    fprintf(work.fp, "; synthetic workload %ld (seed %lu)\n", file_number, options->seed);
+    work.lines++;
+
+    for (work.externs = 0; work.externs < extern_count; work.externs++) {
+        fprintf(work.fp, ".extern X_%ld\n", work.externs);
+    }
+    work.lines += extern_count;
+    write_macros(&work, options);
+
+    /* Statements, then macro calls & comments once the memory budget is spent */
+    statements = options->lines - work.lines - 1;
+
+    for (i = 0; i < statements; i++) {
+        if (chance(&work, options->data_percent) && write_data(&work, options))
+            continue;
+        if (write_instruction(&work, options))
+            continue;
+
+        if ((options->macros > 0) && (work.ic + MACRO_LINE_WORDS * options->macro_body <= IC_BUDGET)) {
+            fprintf(work.fp, "m_%ld\n", next_random(&work, options->macros));
+            work.ic += MACRO_LINE_WORDS * options->macro_body;
+        }
+        else
+            fprintf(work.fp, "; filler %ld\n", i);
+
+        work.lines++;
+    }
+    fprintf(work.fp, "END: stop\n");
+
+    for (i = 0; i < work.code_labels; i++) {
+        if (chance(&work, options->entry_percent))
+            fprintf(work.fp, ".entry L_%ld\n", i);
+    }
+    if (fclose(work.fp) != 0) {
+        fprintf(stderr, "Error: Failed to write to file (%s)\n", path);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to parse the generator command line.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments
+          WorkloadOptions *options - Output parameters
+Returns: int - TRUE if arguments are valid, FALSE otherwise
+*/
+static int parse_workload_options(int argc, char *argv[], WorkloadOptions *options) {
+    int i;
+    long value;
+
+    options->files = 1;
+    options->lines = 100;
+    options->label_percent = 30;
+    options->macros = 2;
+    options->macro_body = 3;
+    options->extern_percent = 5;
+    options->entry_percent = 20;
+    options->data_percent = 20;
+    options->seed = 1;
+    options->prefix = NULL;
+
+    for (i = 1; i < argc; i++) {
+        if ((argv[i][0] != '-') || (argv[i][1] == '\0')) {
+            options->prefix = argv[i];
+            continue;
+        }
+        if ((argv[i][2] != '\0') || (i + 1 >= argc))
+            return FALSE;
+
+        value = atol(argv[++i]);
+
+        if (value < 0)
+            return FALSE;
+
+        switch (argv[i - 1][1]) {
+            case 'f': options->files = value; break;
+            case 'l': options->lines = value; break;
+            case 'L': options->label_percent = (int)value; break;
+            case 'm': options->macros = value; break;
+            case 'b': options->macro_body = (int)value; break;
+            case 'x': options->extern_percent = (int)value; break;
+            case 'e': options->entry_percent = (int)value; break;
+            case 'd': options->data_percent = (int)value; break;
+            case 's': options->seed = (unsigned long)value; break;
+            default: return FALSE;
+        }
+    }
+    return (options->prefix != NULL);
+}
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point of the workload generator.
+Writes <prefix>_0.as ... <prefix>_<files-1>.as, the same output for the same parameters.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments
+Returns: int - 0 if all files were written, 1 otherwise
+*/
+int main(int argc, char *argv[]) {
+    WorkloadOptions options;
+    long i;
+
+    if (!parse_workload_options(argc, argv, &options)) {
+        fprintf(stderr, "Usage: gen_workload [-f files] [-l lines] [-L label%%] [-m macros] [-b body lines]\n"
+                        "                    [-x extern%%] [-e entry%%] [-d data%%] [-s seed] <output_prefix>\n");
+        return 1;
+    }
+    for (i = 0; i < options.files; i++) {
+        if (!write_workload_file(&options, i))
+            return 1;
+    }
+    return 0;
+}
\ No newline at end of file
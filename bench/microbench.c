@@ -0,0 +1,391 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "tokenizer.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "macro_table.h"
+#include "source_buffer.h"
+#include "fixup_table.h"
+#include "instructions.h"
+#include "statement.h"
+#include "encoder.h"
+#include "diagnostics.h"
+#include "stats.h"
+#include "file_io.h"
+#include "keywords.h"
+
+/*
+Microbenchmark of the hot assembler kernels, isolated from file I/O.
+A source file is preprocessed & first-passed once (untimed), its lines, names & operands
+are recorded, then every kernel is replayed over the recording with warmup & repetitions.
+*/
+
+#define DEFAULT_WARMUP 3
+#define DEFAULT_REPETITIONS 50
+#define BASE4_VALUES 1024        /* every 10-bit word value */
+
+/* Data recorded from the source, replayed by the kernels */
+typedef struct {
+    FileTables tables;           /* tables filled by preprocessing & first pass */
+    const char **lines;          /* expanded (.am) lines, spans of tables.am_source */
+    size_t *line_lengths;        /* length of every line */
+    const char **names;          /* label & direct operand names (symbol lookups) */
+    const char **words;          /* first word of each line, and macro names (macro lookups) */
+    int line_count, name_count, word_count;
+    Arena text;                  /* storage of recorded names */
+    Arena scratch_arena;         /* tokens of tokenizer kernel */
+    FixupTable scratch_fixups;   /* fixups of encoder kernel */
+    MemoryImage scratch_memory;  /* words of encoder kernel */
+} Recording;
+
+/* A timed kernel: runs one pass over the recording, returns the number of operations */
+typedef long (*Kernel)(Recording *recording);
+
+typedef struct {
+    const char *name;
+    Kernel run;
+} KernelEntry;
+
+/* Consumed kernel results, so the calls can't be optimized away */
+static unsigned long sink;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to parse every recorded line into tokens.
+Receives: Recording *recording - Recorded data
+Returns: long - Number of parsed lines
+*/
+static long run_tokenizer(Recording *recording) {
+    Token *tokens;
+    int i, count;
+
+    for (i = 0; i < recording->line_count; i++) {
+        reset_arena(&recording->scratch_arena);
+
+        if (parse_tokens(recording->lines[i], recording->line_lengths[i], &recording->scratch_arena, &tokens, &count))
+            sink += count;
+    }
+    return recording->line_count;
+}
+
+/*
+Function to look up every recorded label & operand name in the symbol table.
+Receives: Recording *recording - Recorded data
+Returns: long - Number of lookups
+*/
+static long run_find_symbol(Recording *recording) {
+    int i;
+
+    for (i = 0; i < recording->name_count; i++) {
+        sink += (find_symbol(&recording->tables.symtab, recording->names[i]) != NULL);
+    }
+    return recording->name_count;
+}
+
+/*
+Function to look up every recorded first word & macro name in the macro table.
+Receives: Recording *recording - Recorded data
+Returns: long - Number of lookups
+*/
+static long run_find_macro(Recording *recording) {
+    int i;
+
+    for (i = 0; i < recording->word_count; i++) {
+        sink += (find_macro(&recording->tables.macrotab, recording->words[i]) != NULL);
+    }
+    return recording->word_count;
+}
+
+/*
+Function to look up the name of every statement as an instruction.
+Receives: Recording *recording - Recorded data
+Returns: long - Number of lookups
+*/
+static long run_get_instruction(Recording *recording) {
+    const StatementTable *statements = &recording->tables.statements;
+    int i;
+
+    for (i = 0; i < statements->count; i++) {
+        sink += (get_instruction(statements->statements[i].name) != NULL);
+    }
+    return statements->count;
+}
+
+/*
+Function to classify the addressing mode of every instruction operand.
+Receives: Recording *recording - Recorded data
+Returns: long - Number of classified operands
+*/
+static long run_addressing_mode(Recording *recording) {
+    const StatementTable *statements = &recording->tables.statements;
+    const Statement *statement;
+    long count = 0;
+    int i, j;
+
+    for (i = 0; i < statements->count; i++) {
+        statement = &statements->statements[i];
+
+        if (statement->kind != STATEMENT_INSTRUCTION)
+            continue;
+
+        for (j = 0; j < statement->operand_count; j++) {
+            sink += get_addressing_mode(STATEMENT_OPERANDS(statements, statement)[j].text);
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+Function to encode the operands of every instruction statement into scratch memory.
+Receives: Recording *recording - Recorded data
+Returns: long - Number of encoded instructions
+*/
+static long run_encode_operands(Recording *recording) {
+    const StatementTable *statements = &recording->tables.statements;
+    const Statement *statement;
+    MemoryWord instruction_word;
+    int i, current_ic = 0;
+    long count = 0;
+
+    reset_fixup_table(&recording->scratch_fixups);
+    recording->scratch_memory.ic = 0;
+
+    for (i = 0; i < statements->count; i++) {
+        statement = &statements->statements[i];
+
+        if ((statement->kind != STATEMENT_INSTRUCTION) || !statement->inst)
+            continue;
+
+        instruction_word = 0;
+        current_ic++;
+        sink += encode_operands(statement->inst, STATEMENT_OPERANDS(statements, statement), statement->operand_count,
+                                &recording->scratch_fixups, &recording->scratch_memory, &current_ic,
+                                &instruction_word, statement->line_num);
+        count++;
+    }
+    return count;
+}
+
+/*
+Function to convert every 10-bit word value to base-4.
+Receives: Recording *recording - Recorded data (unused)
+Returns: long - Number of conversions
+*/
+static long run_base4_word(Recording *recording) {
+    char result[WORD_LENGTH];
+    int i;
+
+    for (i = 0; i < BASE4_VALUES; i++) {
+        convert_to_base4_word(i, result);
+        sink += result[0];
+    }
+    return BASE4_VALUES;
+}
+
+/*
+Function to record the expanded lines as spans, and collect the names looked up by the kernels.
+Receives: Recording *recording - Recording with filled tables
+Returns: int - TRUE if recorded, FALSE on memory error
+*/
+static int record_source(Recording *recording) {
+    FileTables *tables = &recording->tables;
+    const StatementTable *statements = &tables->statements;
+    const Statement *statement;
+    const Operand *operands;
+    const char *line;
+    size_t length, position = 0;
+    Token *tokens;
+    int i, j, count, max_names = statements->count + statements->operand_count;
+
+    recording->line_count = (int)count_source_lines(&tables->am_source);
+    recording->lines = malloc((recording->line_count + 1) * sizeof(char*));
+    recording->line_lengths = malloc((recording->line_count + 1) * sizeof(size_t));
+    recording->words = malloc((recording->line_count + tables->macrotab.count + 1) * sizeof(char*));
+    recording->names = malloc((max_names + 1) * sizeof(char*));
+
+    if (!recording->lines || !recording->line_lengths || !recording->words || !recording->names)
+        return FALSE;
+
+    recording->line_count = recording->word_count = recording->name_count = 0;
+
+    while (next_source_line(&tables->am_source, &position, &line, &length)) {
+        recording->lines[recording->line_count] = line;
+        recording->line_lengths[recording->line_count++] = length;
+        reset_arena(&recording->scratch_arena);
+
+        if (parse_tokens(line, length, &recording->scratch_arena, &tokens, &count) && (count > 0))
+            recording->words[recording->word_count++] = arena_copy_span(&recording->text, tokens[0].start, tokens[0].length);
+    }
+    for (i = 0; i < tables->macrotab.count; i++) {
+        recording->words[recording->word_count++] = tables->macrotab.macros[i].name;
+    }
+    for (i = 0; i < statements->count; i++) {
+        statement = &statements->statements[i];
+        operands = STATEMENT_OPERANDS(statements, statement);
+
+        if (HAS_LABEL(statement))
+            recording->names[recording->name_count++] = arena_copy_span(&recording->text, statement->label, strlen(statement->label) - 1);
+
+        for (j = 0; (statement->kind == STATEMENT_INSTRUCTION) && (j < statement->operand_count); j++) {
+            if (operands[j].mode == ADDR_MODE_DIRECT)
+                recording->names[recording->name_count++] = operands[j].text;
+        }
+    }
+    return TRUE;
+}
+
+/*
+Function to fill the recording from a source file: preprocessing, first pass & name collection.
+Their messages are kept in a log, printed only if recording fails.
+Receives: Recording *recording - Recording to fill
+          const char *base_filename - Source filename without .as extension
+Returns: int - TRUE if recorded, FALSE on any error
+*/
+static int load_recording(Recording *recording, const char *base_filename) {
+    char input_file[MAX_FILENAME_LENGTH], am_file[MAX_FILENAME_LENGTH];
+    SourceBuffer log;
+    int result = FALSE;
+
+    if (!init_file_tables(&recording->tables) || !init_source_buffer(&log) ||
+        !init_arena(&recording->text, TEXT_ARENA_SIZE) || !init_arena(&recording->scratch_arena, LINE_ARENA_SIZE) ||
+        !init_fixup_table(&recording->scratch_fixups))
+        return FALSE;
+
+    init_memory(&recording->scratch_memory);
+    sprintf(input_file, "%.90s%s", base_filename, FILE_EXT_INPUT);
+    sprintf(am_file, "%.90s%s", base_filename, FILE_EXT_PREPROC);
+
+    set_diagnostic_log(&log);
+
+    if (read_source_file(&recording->tables.as_source, input_file) &&
+        (preprocess_macros(&recording->tables.as_source, &recording->tables.am_source, &recording->tables.macrotab) != PASS_ERROR) &&
+        (first_pass(am_file, &recording->tables.am_source, &recording->tables.statements, &recording->tables.symtab,
+                    &recording->tables.memory, &recording->tables.fixups, &recording->tables.line_arena) != PASS_ERROR))
+        result = record_source(recording);
+
+    set_diagnostic_log(NULL);
+
+    if (!result)
+        printf("%s", log.text);
+
+    free_source_buffer(&log);
+    return result;
+}
+
+/*
+Function to order samples ascending, for qsort.
+Receives: const void *a - First sample (double)
+          const void *b - Second sample (double)
+Returns: int - Negative, zero or positive
+*/
+static int compare_samples(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+/*
+Function to time a kernel: warmup passes, then timed repetitions, reported as ns per operation.
+Receives: const KernelEntry *kernel - Kernel to run
+          Recording *recording - Recorded data
+          int warmup - Untimed passes
+          int repetitions - Timed passes
+          double *samples - Scratch array of repetitions size
+*/
+static void bench_kernel(const KernelEntry *kernel, Recording *recording, int warmup, int repetitions, double *samples) {
+    Timestamp start, end;
+    double mean = 0;
+    long operations = 0;
+    int i;
+
+    for (i = 0; i < warmup; i++) {
+        kernel->run(recording);
+    }
+    for (i = 0; i < repetitions; i++) {
+        get_timestamp(&start);
+        operations = kernel->run(recording);
+        get_timestamp(&end);
+
+        samples[i] = (operations > 0) ? ((end.wall - start.wall) * NANOSECONDS_PER_SECOND / operations) : 0;
+        mean += samples[i];
+    }
+    qsort(samples, repetitions, sizeof(double), compare_samples);
+
+    printf("%-20s %8ld %9.1f %9.1f %9.1f %9.1f %9.1f%c", kernel->name, operations, samples[0],
+           samples[(repetitions - 1) * 50 / 100], samples[(repetitions - 1) * 90 / 100],
+           samples[(repetitions - 1) * 99 / 100], mean / repetitions, NEWLINE);
+}
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point of the microbenchmark.
+Usage: microbench [-w warmup] [-r repetitions] <file_name> (without .as extension)
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments
+Returns: int - 0 if all kernels ran, 1 otherwise
+*/
+int main(int argc, char *argv[]) {
+    static const KernelEntry kernels[] = {
+        {"parse_tokens", run_tokenizer},
+        {"find_symbol", run_find_symbol},
+        {"find_macro", run_find_macro},
+        {"get_instruction", run_get_instruction},
+        {"get_addressing_mode", run_addressing_mode},
+        {"encode_operands", run_encode_operands},
+        {"convert_to_base4_word", run_base4_word}
+    };
+    Recording recording;
+    double *samples;
+    const char *filename = NULL;
+    int i, warmup = DEFAULT_WARMUP, repetitions = DEFAULT_REPETITIONS;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc))
+            warmup = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+            repetitions = atoi(argv[++i]);
+        else
+            filename = argv[i];
+    }
+    if (!filename || (warmup < 0) || (repetitions < 1)) {
+        print_error("Expected different app call", "./microbench [-w warmup] [-r repetitions] <filename>");
+        return 1;
+    }
+    if (!check_keyword_slots()) {
+        print_error("Keyword perfect hash table is out of date", "make keyword-slots");
+        return 1;
+    }
+    memset(&recording, 0, sizeof(Recording));
+    samples = malloc(repetitions * sizeof(double));
+
+    if (!samples || !load_recording(&recording, filename)) {
+        print_error("Failed to record source", filename);
+        return 1;
+    }
+    printf("%d lines, %d statements, %d symbols, %d macros, %d warmup, %d repetitions%c%c",
+           recording.line_count, recording.tables.statements.count, recording.tables.symtab.count,
+           recording.tables.macrotab.count, warmup, repetitions, NEWLINE, NEWLINE);
+    printf("%-20s %8s %9s %9s %9s %9s %9s%c", "kernel (ns/op)", "ops", "min", "p50", "p90", "p99", "mean", NEWLINE);
+
+    for (i = 0; i < (int)(sizeof(kernels) / sizeof(kernels[0])); i++) {
+        bench_kernel(&kernels[i], &recording, warmup, repetitions, samples);
+    }
+    free(samples);
+    free(recording.lines);
+    free(recording.line_lengths);
+    free(recording.words);
+    free(recording.names);
+    free_arena(&recording.text);
+    free_arena(&recording.scratch_arena);
+    free_fixup_table(&recording.scratch_fixups);
+    free_file_tables(&recording.tables);
+
+    return (sink == 0);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#!/bin/sh
+# End-to-end scaling benchmark: generates synthetic corpora with gen_workload,
+# assembles them, and records throughput (--stats) & peak memory (instrumented build).
+# Run from the repository root (make bench), results go to bench/results/results.csv
+
+ROOT=$(pwd)
+ASSEMBLER="$ROOT/assembler"
+INSTRUMENTED="$ROOT/assembler_instrumented"
+GENERATOR="$ROOT/bench/gen_workload"
+WORK_DIR="$ROOT/bench/results/corpus"
+RESULTS="$ROOT/bench/results/results.csv"
+
+for tool in "$ASSEMBLER" "$INSTRUMENTED" "$GENERATOR"; do
+    if [ ! -x "$tool" ]; then
+        echo "Error: Missing $tool (run: make bench)"
+        exit 1
+    fi
+done
+
+mkdir -p "$WORK_DIR"
+echo "scenario,value,files,jobs,lines,elapsed_sec,lines_per_sec,words,peak_bytes" > "$RESULTS"
+
+# Generate a corpus, assemble it, and append one result row
+# Usage: run_case <scenario> <value> <jobs> <generator arguments...>
+run_case() {
+    scenario=$1
+    value=$2
+    jobs=$3
+    shift 3
+
+    rm -f "$WORK_DIR"/*
+    "$GENERATOR" "$@" "$WORK_DIR/w" || exit 1
+
+    cd "$WORK_DIR" || exit 1
+    files=$(ls *.as | sed 's/\.as$//')
+    count=$(echo "$files" | wc -l | tr -d ' ')
+
+    stats=$("$ASSEMBLER" --stats -j "$jobs" $files | sed -n '/^Stats for all files:/,$p')
+    peak=$("$INSTRUMENTED" $files | sed -n 's/^  all .* peak \([0-9]*\)$/\1/p')
+    cd "$ROOT" || exit 1
+
+    elapsed=$(echo "$stats" | sed -n 's/.*(elapsed \([0-9.]*\) s).*/\1/p')
+    lines=$(echo "$stats" | sed -n 's/.*, lines \([0-9]*\) (.*/\1/p')
+    rate=$(echo "$stats" | sed -n 's/.*(\([0-9]*\) lines\/sec).*/\1/p')
+    words=$(echo "$stats" | sed -n 's/.*words emitted \([0-9]*\).*/\1/p')
+
+    echo "$scenario,$value,$count,$jobs,$lines,$elapsed,$rate,$words,$peak" | tee -a "$RESULTS"
+}
+
+# Lines per file (code is capped by the 256 words memory, extra lines are tables & comments)
+for lines in 100 1000 10000 50000; do
+    run_case lines "$lines" 1 -f 50 -l "$lines" -m 10 -x 10
+done
+
+# Macro count (table size & expansion lookups)
+for macros in 10 100 1000 5000; do
+    run_case macros "$macros" 1 -f 10 -l $((macros * 5 + 500)) -m "$macros" -b 3 -x 0
+done
+
+# Extern declarations (symbol table size)
+for externs in 10 30 60; do
+    run_case externs "$externs" 1 -f 10 -l 20000 -m 10 -x "$externs"
+done
+
+# Label density & data volume
+for percent in 10 50 90; do
+    run_case labels "$percent" 1 -f 200 -l 300 -L "$percent" -d "$percent" -e 50
+done
+
+# Worker threads over a large corpus
+for jobs in 1 2 4 8; do
+    run_case jobs "$jobs" "$jobs" -f 2000 -l 300 -m 10 -x 10
+done
+
+rm -rf "$WORK_DIR"
+echo "Results written to $RESULTS"
@@ -0,0 +1,241 @@
+/* Sockets & getcwd() are POSIX, not part of C90 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "options.h"
+#include "file_io.h"
+#include "protocol.h"
+
+/*
+Thin client of the resident assembler (./assembler --serve PATH).
+Takes the same command line as ./assembler, sends it to the server with the working directory,
+and prints the returned messages & exit code as if the assembler ran in-process.
+With --in-memory the sources are sent in the request, and the output files are written by the client.
+*/
+
+#define CLIENT_OPTION_SOCKET "--socket"
+#define CLIENT_OPTION_IN_MEMORY "--in-memory"
+#define CLIENT_OPTION_STOP "--stop"
+
+/* Client flags, and the command line forwarded to the server */
+typedef struct {
+    const char *socket_path;
+    int in_memory;               /* 'boolean' flag, send sources & receive outputs */
+    int stop;                    /* 'boolean' flag, ask the server to stop */
+    char **args;                 /* forwarded arguments, args[0] is the program name */
+    int arg_count;
+} ClientOptions;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to split the command line into client flags and the forwarded assembler command line.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments
+          ClientOptions *client - Output client options
+Returns: int - TRUE if arguments are valid, FALSE otherwise
+*/
+static int parse_client_options(int argc, char *argv[], ClientOptions *client) {
+    int i;
+
+    client->socket_path = DEFAULT_SOCKET_PATH;
+    client->in_memory = FALSE;
+    client->stop = FALSE;
+    client->arg_count = 1;
+    client->args = malloc((argc + 1) * sizeof(char *));
+
+    if (!client->args) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to parse command line");
+        return FALSE;
+    }
+    client->args[0] = argv[0];
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], CLIENT_OPTION_SOCKET) == 0) {
+            if ((i + 1 >= argc) || (strlen(argv[i + 1]) >= MAX_SOCKET_PATH_LENGTH)) {
+                print_error("Invalid socket path", (i + 1 < argc) ? argv[i + 1] : CLIENT_OPTION_SOCKET);
+                return FALSE;
+            }
+            client->socket_path = argv[++i];
+        }
+        else if (strcmp(argv[i], CLIENT_OPTION_IN_MEMORY) == 0)
+            client->in_memory = TRUE;
+
+        else if (strcmp(argv[i], CLIENT_OPTION_STOP) == 0)
+            client->stop = TRUE;
+
+        else
+            client->args[client->arg_count++] = argv[i];
+    }
+    client->args[client->arg_count] = NULL;
+
+    return TRUE;
+}
+
+/*
+Function to add the sources of all files of the command line to the request.
+Receives: ClientOptions *client - Client options, with the forwarded command line
+          SourceBuffer *request - Request being built
+          SourceBuffer *source - Buffer each source is read into
+Returns: int - TRUE if all sources were added, FALSE otherwise
+*/
+static int add_input_records(ClientOptions *client, SourceBuffer *request, SourceBuffer *source) {
+    char input_file[MAX_FILENAME_LENGTH];
+    AssemblerOptions options;
+    int i, result = TRUE;
+
+    if (!parse_options(client->arg_count, client->args, &options))
+        return FALSE;
+
+    for (i = 0; result && (i < options.file_count); i++) {
+        sprintf(input_file, "%s%s", options.files[i], FILE_EXT_INPUT); /* length checked by parse_options */
+
+        /* A missing source is left out, and reported by the server like the assembler would */
+        if ((get_file_size(input_file) >= 0) &&
+            (!read_source_file(source, input_file) ||
+             !append_record(request, RECORD_INPUT, input_file, strlen(input_file), source->text, source->length)))
+            result = FALSE;
+    }
+    free_options(&options);
+
+    return result;
+}
+
+/*
+Function to build the request: working directory, forwarded arguments, and sources (--in-memory),
+or a stop request (--stop).
+Receives: ClientOptions *client - Client options
+          SourceBuffer *request - Output request
+          SourceBuffer *source - Scratch buffer for sources
+Returns: int - TRUE if request was built, FALSE otherwise
+*/
+static int build_request(ClientOptions *client, SourceBuffer *request, SourceBuffer *source) {
+    char cwd[MAX_CWD_LENGTH];
+    int i;
+
+    if (client->stop)
+        return append_record(request, RECORD_STOP, NULL, 0, NULL, 0);
+
+    if (!getcwd(cwd, sizeof(cwd))) {
+        print_error("Failed to get working directory", NULL);
+        return FALSE;
+    }
+    if (!append_record(request, RECORD_CWD, NULL, 0, cwd, strlen(cwd)))
+        return FALSE;
+
+    for (i = 1; i < client->arg_count; i++) {
+        if (!append_record(request, RECORD_ARG, NULL, 0, client->args[i], strlen(client->args[i])))
+            return FALSE;
+    }
+    return !client->in_memory || add_input_records(client, request, source);
+}
+
+/*
+Function to send a request to the server, and receive its whole response.
+Receives: const char *socket_path - Path of the server socket
+          const SourceBuffer *request - Request to send
+          SourceBuffer *response - Output response
+Returns: int - TRUE if a response was received, FALSE otherwise
+*/
+static int exchange(const char *socket_path, const SourceBuffer *request, SourceBuffer *response) {
+    struct sockaddr_un address;
+    int result, fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        print_error("Failed to create socket", NULL);
+        return FALSE;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        print_error("Failed to connect to server", socket_path);
+        close(fd);
+        return FALSE;
+    }
+    result = write_socket(fd, request->text, request->length) &&
+             (shutdown(fd, SHUT_WR) == 0) &&
+             read_socket(fd, response);
+
+    close(fd);
+    return result;
+}
+
+/*
+Function to replay a response: print the messages, write the returned output files, and take the exit code.
+Receives: const SourceBuffer *response - Response of the server
+Returns: int - Exit code of the request, 1 on a malformed response
+*/
+static int handle_response(const SourceBuffer *response) {
+    char filename[MAX_FILENAME_LENGTH];
+    size_t position = 0;
+    Record record;
+    int exit_code = 1;
+
+    while (position < response->length) {
+        if (!next_record(response, &position, &record)) {
+            print_error("Malformed response", NULL);
+            return 1;
+        }
+        if (IS_RECORD(&record, RECORD_LOG))
+            fwrite(record.data, 1, record.data_length, stdout);
+
+        else if (IS_RECORD(&record, RECORD_OUTPUT) && (record.name_length < MAX_FILENAME_LENGTH)) {
+            memcpy(filename, record.name, record.name_length);
+            filename[record.name_length] = NULL_TERMINATOR;
+            write_text_file(filename, record.data, record.data_length);
+        }
+        else if (IS_RECORD(&record, RECORD_EXIT))
+            exit_code = atoi(record.data);
+    }
+    return exit_code;
+}
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point to the assembler client.
+Receives: int argc - Number of command line arguments
+          char *argv[] - [--socket PATH] [--in-memory] [--stop], then the ./assembler command line
+Returns: int - Exit code of the request, 1 on a client error
+*/
+int main(int argc, char *argv[]) {
+    ClientOptions client;
+    SourceBuffer request, response, source;
+    int request_ok, response_ok, source_ok, result = 1;
+
+    if (!parse_client_options(argc, argv, &client)) {
+        free(client.args);
+        return 1;
+    }
+    request_ok = init_source_buffer(&request);
+    response_ok = init_source_buffer(&response);
+    source_ok = init_source_buffer(&source);
+
+    if (request_ok && response_ok && source_ok &&
+        build_request(&client, &request, &source) &&
+        exchange(client.socket_path, &request, &response))
+        result = handle_response(&response);
+
+    if (request_ok)
+        free_source_buffer(&request);
+    if (response_ok)
+        free_source_buffer(&response);
+    if (source_ok)
+        free_source_buffer(&source);
+
+    free(client.args);
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#!/bin/sh
+# Resident server tests: starts ./assembler --serve with a relative socket path, sends a request
+# from another directory, stops the server, and checks that only the server's own socket was removed.
+# Run from the repository root (make server-test)
+
+ROOT=$(pwd)
+ASSEMBLER="$ROOT/assembler"
+CLIENT="$ROOT/assembler_client"
+WORK_DIR="$ROOT/client/results"
+
+for tool in "$ASSEMBLER" "$CLIENT"; do
+    if [ ! -x "$tool" ]; then
+        echo "Error: Missing $tool (run: make)"
+        exit 1
+    fi
+done
+
+rm -rf "$WORK_DIR"
+mkdir -p "$WORK_DIR/server" "$WORK_DIR/project"
+cp "$ROOT/good_tests/goodtest1.as" "$WORK_DIR/project"
+SOCKET="$WORK_DIR/server/srv.sock"
+failed=0
+
+cd "$WORK_DIR/server" || exit 1
+"$ASSEMBLER" --serve srv.sock > server.log 2>&1 &
+server_pid=$!
+
+# Wait for the server to listen
+tries=0
+while [ ! -S "$SOCKET" ] && [ "$tries" -lt 50 ]; do
+    sleep 0.1
+    tries=$((tries + 1))
+done
+
+# A file named as the socket in the client's directory must be left alone
+cd "$WORK_DIR/project" || exit 1
+echo "not a socket" > srv.sock
+
+if ! "$CLIENT" --socket "$SOCKET" goodtest1 > client.log; then
+    echo "FAIL: request from another directory"
+    cat client.log
+    failed=1
+fi
+if [ ! -f goodtest1.ob ]; then
+    echo "FAIL: goodtest1.ob was not written to the client's directory"
+    failed=1
+fi
+"$CLIENT" --socket "$SOCKET" --stop > /dev/null
+wait "$server_pid"
+
+if [ ! -f srv.sock ]; then
+    echo "FAIL: server removed srv.sock from the client's directory"
+    failed=1
+fi
+if [ -e "$SOCKET" ]; then
+    echo "FAIL: server left its socket behind"
+    failed=1
+fi
+cd "$ROOT" || exit 1
+
+if [ "$failed" -ne 0 ]; then
+    exit 1
+fi
+rm -rf "$WORK_DIR"
+echo "Server tests passed"
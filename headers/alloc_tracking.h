@@ -0,0 +1,72 @@
+#ifndef ALLOC_TRACKING_H
+#define ALLOC_TRACKING_H
+
+#include <stdlib.h>
+
+#include "utils.h"
+#include "stats.h"
+
+/* Allocation sites (the table owning the memory) */
+#define ALLOC_SITE_OTHER 0
+#define ALLOC_SITE_SYMBOLS 1
+#define ALLOC_SITE_SYMBOL_INDEX 2
+#define ALLOC_SITE_MACROS 3
+#define ALLOC_SITE_MACRO_BODIES 4
+#define ALLOC_SITE_MACRO_INDEX 5
+#define ALLOC_SITE_ARENAS 6
+#define ALLOC_SITE_SOURCES 7
+#define ALLOC_SITE_STATEMENTS 8
+#define ALLOC_SITE_FIXUPS 9
+#define ALLOC_SITE_SCHEDULER 10
+#define ALLOC_SITE_CACHE 11
+#define ALLOC_SITE_COUNT 12
+
+/* Allocation phases: the timed PHASE_* of a file, and setup (outside any file phase) */
+#define ALLOC_PHASE_SETUP PHASE_COUNT
+#define ALLOC_PHASE_COUNT (PHASE_COUNT + 1)
+
+/* Counters of one allocation site or phase */
+typedef struct {
+    long allocations;            /* malloc / calloc calls, and realloc of NULL */
+    long reallocations;          /* realloc calls of existing blocks */
+    long frees;
+    long bytes;                  /* bytes requested by all calls */
+    long copies;                 /* reallocations that moved the block */
+    long copied_bytes;           /* bytes moved by those reallocations */
+    long live_bytes;             /* bytes currently allocated */
+    long peak_bytes;             /* peak of live_bytes */
+} AllocCounters;
+
+/*
+Allocation wrappers, counting per site & phase in the instrumented build (make instrumented).
+In the normal build they are the plain C library calls.
+*/
+#ifdef TRACK_ALLOCATIONS
+#define ALLOC(size, site) tracked_alloc((size), (site), FALSE)
+#define ALLOC_ZEROED(count, size, site) tracked_alloc((count) * (size), (site), TRUE)
+#define REALLOC(ptr, size, site) tracked_realloc((ptr), (size), (site))
+#define FREE(ptr) tracked_free(ptr)
+#define SET_ALLOCATION_PHASE(phase) set_allocation_phase(phase)
+#define PRINT_ALLOCATION_REPORT() print_allocation_report()
+#else
+#define ALLOC(size, site) malloc(size)
+#define ALLOC_ZEROED(count, size, site) calloc((count), (size))
+#define REALLOC(ptr, size, site) realloc((ptr), (size))
+#define FREE(ptr) free(ptr)
+#define SET_ALLOCATION_PHASE(phase)
+#define PRINT_ALLOCATION_REPORT()
+#endif
+
+/* Function prototypes */
+
+void *tracked_alloc(size_t size, int site, int zeroed);
+
+void *tracked_realloc(void *ptr, size_t size, int site);
+
+void tracked_free(void *ptr);
+
+void set_allocation_phase(int phase);
+
+void print_allocation_report(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdio.h>
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "binary_object.h"
+
+/*
+Object archive (static library) file, all fields little endian:
+- Header (ARCHIVE_HEADER_SIZE bytes), fields at the ARCHIVE_*_FIELD offsets
+- Member table: one ARCHIVE_MEMBER_SIZE record per binary object
+- Symbol index: open-addressing hash table (power of 2 slots, at most half full) of the entry
+  symbols of all members, probed linearly from the 32-bit FNV-1a hash of the name (hash_string)
+- Strings: null terminated member & symbol names
+- Member data: the binary objects (.bin), 4-byte aligned
+The header, member table, index & strings form the directory, read alone when opening the archive.
+*/
+#define ARCHIVE_MAGIC "AARC"
+#define ARCHIVE_MAGIC_LENGTH 4
+#define ARCHIVE_VERSION 1
+
+/* Header fields (byte offsets) */
+#define ARCHIVE_VERSION_FIELD 4      /* u16 format version */
+#define ARCHIVE_MEMBERS_FIELD 8      /* u32 offset of member table, followed by u32 member count */
+#define ARCHIVE_INDEX_FIELD 16       /* u32 offset of symbol index, followed by u32 slot count */
+#define ARCHIVE_STRINGS_FIELD 24     /* u32 offset of strings, followed by u32 length */
+#define ARCHIVE_HEADER_SIZE 32
+
+/* Member record layout (byte offsets) */
+#define ARCHIVE_MEMBER_NAME 0        /* u32 name offset in strings */
+#define ARCHIVE_MEMBER_DATA 4        /* u32 offset of binary object in archive */
+#define ARCHIVE_MEMBER_LENGTH 8      /* u32 length of binary object */
+#define ARCHIVE_MEMBER_SIZE 12
+
+/* Index slot layout (byte offsets) */
+#define ARCHIVE_SLOT_NAME 0          /* u32 symbol name offset in strings, ARCHIVE_EMPTY_SLOT if empty */
+#define ARCHIVE_SLOT_MEMBER 4        /* u32 index of member defining the symbol */
+#define ARCHIVE_SLOT_SIZE 8
+
+#define ARCHIVE_EMPTY_SLOT 0xFFFFFFFFUL
+#define ARCHIVE_ALIGNMENT 4
+#define MAX_ARCHIVE_CONTEXT_LENGTH (MAX_LABEL_NAME_LENGTH + MAX_FILENAME_LENGTH + 4)   /* "<symbol> in <member>" */
+
+/* Archive opened for linking: only the directory is read, members are read on demand */
+typedef struct {
+    FILE *fp;
+    const char *filename;        /* base filename, for messages (kept by caller) */
+    SourceBuffer directory;      /* header, member table, symbol index & strings */
+    long file_size;
+    unsigned long members_offset;
+    unsigned long member_count;
+    unsigned long index_offset;
+    unsigned long slot_count;
+    unsigned long strings_offset;
+    unsigned long strings_length;
+    char *loaded;                /* 'boolean' flags per member, already read for linking */
+} Archive;
+
+/* Function prototypes */
+
+int write_archive(const char *base_filename, char *objects[], int object_count);
+
+int open_archive(Archive *archive, const char *base_filename);
+
+void close_archive(Archive *archive);
+
+long find_archive_symbol(const Archive *archive, const char *name);
+
+const char *get_archive_member_name(const Archive *archive, unsigned long member);
+
+int read_archive_member(Archive *archive, unsigned long member, SourceBuffer *buffer);
+
+/* Access macros */
+
+#define ARCHIVE_DIRECTORY(archive) \
+    ((const unsigned char *)(archive)->directory.text)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "utils.h"
+
+#define TEXT_ARENA_SIZE 4096    /* block size for file-scoped text (macro bodies) */
+
+/* Alignment unit for arena allocations */
+typedef union {
+    long l;
+    double d;
+    void *p;
+} ArenaAlign;
+
+/* Chunk of arena memory, its data follows the (aligned) header */
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;     /* next block in chain, NULL if last */
+    size_t capacity;             /* usable bytes in block */
+    size_t used;                 /* bytes handed out from block */
+} ArenaBlock;
+
+/* Bump allocator: blocks are kept on reset, and only freed with the arena */
+typedef struct {
+    ArenaBlock *first;           /* first block in chain */
+    ArenaBlock *current;         /* block allocations are bumped from */
+    size_t block_size;           /* default capacity of new blocks */
+} Arena;
+
+/* Function prototypes */
+
+int init_arena(Arena *arena, size_t block_size);
+
+void free_arena(Arena *arena);
+
+void reset_arena(Arena *arena);
+
+void *arena_alloc(Arena *arena, size_t size);
+
+char *arena_copy_span(Arena *arena, const char *src, size_t length);
+
+char *arena_copy_string(Arena *arena, const char *src);
+
+/* Validation macros */
+
+#define ARENA_ALIGN(size) \
+    (((size) + sizeof(ArenaAlign) - 1) / sizeof(ArenaAlign) * sizeof(ArenaAlign))
+
+#define BLOCK_DATA(block) \
+    ((char*)(block) + ARENA_ALIGN(sizeof(ArenaBlock)))
+
+#endif
\ No newline at end of file
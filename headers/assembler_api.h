@@ -0,0 +1,49 @@
+#ifndef ASSEMBLER_API_H
+#define ASSEMBLER_API_H
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "diagnostics.h"
+
+/*
+Embeddable assembler (make lib: lib/libassembler.a, lib/libassembler.so).
+A context assembles source buffers into in-memory outputs & structured diagnostics, without file system access.
+A context is used by one thread at a time, different contexts may run concurrently.
+*/
+
+/* Outputs of an assembled source */
+#define ASSEMBLER_OUTPUT_EXPANDED 0  /* macro expanded source (.am) */
+#define ASSEMBLER_OUTPUT_OBJECT 1    /* .ob */
+#define ASSEMBLER_OUTPUT_ENTRY 2     /* .ent, only when the source has entries */
+#define ASSEMBLER_OUTPUT_EXTERN 3    /* .ext, only when the source references externals */
+#define ASSEMBLER_OUTPUT_RELOC 4     /* .rel, relocation table of the object */
+#define ASSEMBLER_OUTPUT_BINARY 5    /* .bin, binary object (see binary_object.h) */
+#define ASSEMBLER_OUTPUT_COUNT 6
+
+/* Assembler state, kept warm between sources */
+typedef struct {
+    FileTables tables;
+    SourceBuffer outputs[ASSEMBLER_OUTPUT_COUNT];
+    int produced[ASSEMBLER_OUTPUT_COUNT];    /* 'boolean' flags, output of last source is valid */
+    SourceBuffer log;                        /* messages of last source, as the assembler prints them */
+    DiagnosticList diagnostics;              /* errors & warnings of last source */
+} AssemblerContext;
+
+/* Function prototypes */
+
+AssemblerContext *create_assembler_context(void);
+
+void free_assembler_context(AssemblerContext *context);
+
+int assemble_source_buffer(AssemblerContext *context, const char *name, const char *source, size_t length);
+
+const char *get_assembler_output(const AssemblerContext *context, int output, size_t *length);
+
+const char *get_assembler_log(const AssemblerContext *context, size_t *length);
+
+int get_diagnostic_count(const AssemblerContext *context);
+
+const Diagnostic *get_diagnostic(const AssemblerContext *context, int index);
+
+#endif
\ No newline at end of file
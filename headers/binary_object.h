@@ -0,0 +1,66 @@
+#ifndef BINARY_OBJECT_H
+#define BINARY_OBJECT_H
+
+#include "utils.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "source_buffer.h"
+
+/*
+Binary object file (--binary), laid out to be mapped & used in place (all fields little endian):
+- Header (BINARY_HEADER_SIZE bytes), fields at the BINARY_*_FIELD offsets
+- Words: ic + dc 16-bit words, instructions first (from address code base), then data
+- Entries, external references, relocations & labels: 8-byte records, 4-byte aligned
+  (32-bit name offset, 16-bit address, 16-bit kind), a section is empty when the object has none
+- Strings: null terminated symbol names, referenced by name offset
+Label records hold the address of every label the object defines (unnamed), the block boundaries of dead code elimination.
+*/
+#define BINARY_MAGIC "AOBJ"
+#define BINARY_MAGIC_LENGTH 4
+#define BINARY_VERSION 2
+
+/* Header fields (byte offsets) */
+#define BINARY_VERSION_FIELD 4       /* u16 format version */
+#define BINARY_CODE_BASE_FIELD 6     /* u16 address of first instruction word */
+#define BINARY_IC_FIELD 8            /* u16 instruction words */
+#define BINARY_DC_FIELD 10           /* u16 data words */
+#define BINARY_WORDS_FIELD 12        /* u32 offset of words */
+#define BINARY_ENTRIES_FIELD 16      /* u32 offset of entries, followed by u32 count */
+#define BINARY_EXTERNS_FIELD 24      /* u32 offset of external references, followed by u32 count */
+#define BINARY_RELOCS_FIELD 32       /* u32 offset of relocations, followed by u32 count */
+#define BINARY_STRINGS_FIELD 40      /* u32 offset of strings, followed by u32 length */
+#define BINARY_LABELS_FIELD 48       /* u32 offset of labels, followed by u32 count */
+#define BINARY_HEADER_SIZE 56
+
+/* Record layout (byte offsets) */
+#define BINARY_RECORD_NAME 0         /* u32 name offset in strings, BINARY_NO_NAME if none */
+#define BINARY_RECORD_ADDRESS 4      /* u16 address of symbol / referencing word */
+#define BINARY_RECORD_KIND 6         /* u16 A/R/E kind of relocation (0 for entries, externals & labels) */
+#define BINARY_RECORD_SIZE 8
+#define BINARY_RECORD_ALIGNMENT 4
+
+#define BINARY_NO_NAME 0xFFFFFFFFUL
+
+/* Function prototypes */
+
+int render_binary_object(const MemoryImage *memory, const SymbolTable *symtab, SourceBuffer *output);
+
+int check_binary_object(const unsigned char *data, size_t length);
+
+const char *get_binary_record_name(const unsigned char *object, unsigned long record);
+
+int append_binary_u16(SourceBuffer *output, unsigned int value);
+
+int append_binary_u32(SourceBuffer *output, unsigned long value);
+
+int append_binary_padding(SourceBuffer *output);
+
+/* Field access macros (data points to the start of the object) */
+
+#define BINARY_U16(data, offset) \
+    ((unsigned int)(data)[(offset)] | ((unsigned int)(data)[(offset) + 1] << 8))
+
+#define BINARY_U32(data, offset) \
+    ((unsigned long)BINARY_U16((data), (offset)) | ((unsigned long)BINARY_U16((data), (offset) + 2) << 16))
+
+#endif
\ No newline at end of file
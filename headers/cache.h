@@ -0,0 +1,59 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "utils.h"
+#include "source_buffer.h"
+
+/* Cache entry files */
+#define CACHE_FILE_EXT ".cache"
+#define CACHE_TEMP_EXT ".tmp"
+#define CACHE_MAGIC "asmcache"
+
+#define CACHE_KEY_LENGTH 25          /* 16 hex digits of hash, 8 of length + null terminator */
+#define MAX_CACHE_NAME_LENGTH 32     /* key & extension + null terminator */
+#define MAX_CACHE_DIR_LENGTH 256
+#define MAX_CACHE_PATH_LENGTH 320    /* directory, key & temporary file suffix */
+#define MAX_SECTION_HEADER_LENGTH 32
+#define INITIAL_CACHE_FILES 64       /* initial capacity of the directory listing */
+#define BYTES_PER_KILOBYTE 1024
+
+/* Sections of a cache entry, in the order they are stored */
+#define CACHE_SECTION_LOG 0          /* messages printed while assembling the file */
+#define CACHE_SECTION_AM 1           /* expanded source, stored only when assembled with --keep-am */
+#define CACHE_SECTION_OBJECT 2
+#define CACHE_SECTION_ENTRY 3        /* stored only when the file has entries */
+#define CACHE_SECTION_EXTERN 4       /* stored only when the file has externals */
+#define CACHE_SECTION_RELOC 5        /* stored only when assembled with --reloc */
+#define CACHE_SECTION_BINARY 6       /* stored only when assembled with --binary */
+#define CACHE_SECTION_COUNT 7
+
+/* Span of a section inside a read cache entry */
+typedef struct {
+    size_t offset;               /* start of section text in the entry */
+    size_t length;
+    int present;                 /* 'boolean' flag, section stored in the entry */
+} CacheSection;
+
+/* Cache entry file found while evicting */
+typedef struct {
+    char name[MAX_CACHE_NAME_LENGTH];
+    long size;
+    long last_used;              /* modification time, refreshed on every hit */
+} CacheFile;
+
+/* Function prototypes */
+
+int prepare_cache_directory(const char *directory);
+
+void build_cache_key(const char *filename, const SourceBuffer *as_source, char *key);
+
+int restore_cache_entry(const char *directory, const char *key, const char *outputs[], SourceBuffer *entry);
+
+void store_cache_entry(
+    const char *directory, const char *key, int file_number, const char *outputs[],
+    const SourceBuffer *log, SourceBuffer *entry, SourceBuffer *scratch
+);
+
+int evict_cache_entries(const char *directory, long max_size);
+
+#endif
\ No newline at end of file
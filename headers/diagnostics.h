@@ -0,0 +1,53 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "arena.h"
+
+#define MAX_MESSAGE_LENGTH 512  /* fits a message with filename & source line contexts */
+
+/* Diagnostic severities */
+#define DIAGNOSTIC_ERROR 0
+#define DIAGNOSTIC_WARNING 1
+
+#define NO_LINE 0                    /* line number of diagnostics not tied to a source line */
+#define INITIAL_DIAGNOSTIC_CAPACITY 16
+
+/* Reported error / warning, as structured data */
+typedef struct {
+    int severity;                /* DIAGNOSTIC_ERROR / DIAGNOSTIC_WARNING */
+    int line_num;                /* source line number, NO_LINE if not tied to a line */
+    const char *message;
+    const char *context;         /* offending name / text, NULL if none */
+} Diagnostic;
+
+/* Diagnostics recorded while a list is bound to the thread */
+typedef struct {
+    Diagnostic *items;
+    int count;
+    int capacity;
+    Arena text;                  /* storage of messages & contexts */
+} DiagnosticList;
+
+/* Function prototypes */
+
+SourceBuffer *get_diagnostic_log(void);
+
+void set_diagnostic_log(SourceBuffer *log);
+
+void print_message(const char *format, ...);
+
+void print_text(const char *text, size_t length);
+
+int init_diagnostic_list(DiagnosticList *list);
+
+void reset_diagnostic_list(DiagnosticList *list);
+
+void free_diagnostic_list(DiagnosticList *list);
+
+void set_diagnostic_list(DiagnosticList *list);
+
+void record_diagnostic(int severity, const char *message, const char *context, int context_length, int line_num);
+
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "memory.h"
 #include "symbol_table.h"
+#include "instructions.h"
+#include "keywords.h"
 
 /* Data directives */
 #define DATA_DIRECTIVE ".data"
@@ -12,25 +14,35 @@
 #define ENTRY_DIRECTIVE ".entry"
 #define EXTERN_DIRECTIVE ".extern"
 
+/* Directive numeric IDs */
+#define NO_DIRECTIVE -1
+#define DIRECTIVE_DATA 0
+#define DIRECTIVE_STRING 1
+#define DIRECTIVE_MATRIX 2
+#define DIRECTIVE_ENTRY 3
+#define DIRECTIVE_EXTERN 4
+
+#define DIRECTIVES_COUNT 5
+
+/* .data / .mat value range (10-bit signed) */
+#define MIN_DATA_VALUE -512
+#define MAX_DATA_VALUE 511
+#define MAX_DATA_MAGNITUDE 512
+
 /* Function prototypes */
 
+int get_directive_span(const char *name, size_t length);
+
+int get_directive(const char *name);
+
 int process_directive(
-    char **tokens, int token_count, SymbolTable *symtab,
-    MemoryImage *memory, int is_second_pass
+    int directive, const Operand *values, int value_count,
+    SymbolTable *symtab, MemoryImage *memory
 );
 
 /* Validation macros */
 
-#define IS_DATA_DIRECTIVE(token) \
-    (strcmp((token), DATA_DIRECTIVE) == 0 || strcmp((token), "data") == 0 || \
-     strcmp((token), STRING_DIRECTIVE) == 0 || strcmp((token), "string") == 0 || \
-     strcmp((token), MATRIX_DIRECTIVE) == 0 || strcmp((token), "mat") == 0)
-
-#define IS_LINKER_DIRECTIVE(token) \
-    (strcmp((token), ENTRY_DIRECTIVE) == 0 || strcmp((token), "entry") == 0 || \
-     strcmp((token), EXTERN_DIRECTIVE) == 0 || strcmp((token), "extern") == 0)
-
 #define IS_DIRECTIVE(token) \
-    (IS_DATA_DIRECTIVE(token) || IS_LINKER_DIRECTIVE(token))
+    IS_KEYWORD_OF_CLASS((token), KEYWORD_DIRECTIVE)
 
 #endif
\ No newline at end of file
@@ -4,20 +4,19 @@
 #include "memory.h"
 #include "symbol_table.h"
 #include "instructions.h"
+#include "fixup_table.h"
 
 #define BASE4_ENCODING 4
+#define BASE4_ADDRESS_COUNT 256       /* 4 base-4 digits */
+#define BASE4_WORD_COUNT 1024         /* 5 base-4 digits */
 
-/* For register word bit positions */
-#define REG_SRC_SHIFT 6  /* Source register starts at bit 6 */
-#define REG_DST_SHIFT 2  /* Destination register starts at bit 2 */
+/* Object file text: header line, then one "address word" line per memory word */
+#define OBJECT_LINE_LENGTH ((ADDR_LENGTH - 1) + 1 + (WORD_LENGTH - 1) + 1)
+#define MAX_OBJECT_TEXT_LENGTH ((2 * ADDR_LENGTH) + (MAX_WORD_COUNT * OBJECT_LINE_LENGTH))
 
 /* Function prototypes */
 
-int parse_operands(
-    char **tokens, int token_count, int *operand_start_index, int *operand_count
-);
-
-int check_operands(const Instruction *inst, char **operands, int operand_count);
+int check_operands(const Instruction *inst, const Operand *operands, int operand_count);
 
 int encode_instruction_word(
     const Instruction *inst, MemoryImage *memory,
@@ -25,15 +24,19 @@ int encode_instruction_word(
 );
 
 int encode_operands(
-    const Instruction *inst, char **operands, int operand_start,
-    int operand_count, SymbolTable *symtab, MemoryImage *memory,
-    int *current_ic_ptr, MemoryWord *instruction_word
+    const Instruction *inst, const Operand *operands,
+    int operand_count, FixupTable *fixups, MemoryImage *memory,
+    int *current_ic_ptr, MemoryWord *instruction_word, int line_num
 );
 
+int encode_symbol_operand(const char *operand, int length, SymbolTable *symtab, MemoryImage *memory, int address);
+
 void convert_to_base4_header(int value, char *result);
 
 void convert_to_base4_address(int value, char *result);
 
 void convert_to_base4_word(int value, char *result);
 
+size_t format_object_image(const MemoryImage *memory, char *buffer);
+
 #endif
\ No newline at end of file
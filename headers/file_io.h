@@ -4,6 +4,11 @@
 #include "memory.h"
 #include "symbol_table.h"
 #include "macro_table.h"
+#include "source_buffer.h"
+#include "fixup_table.h"
+#include "statement.h"
+#include "arena.h"
+#include "stats.h"
 
 /* Various file extensions */
 #define FILE_EXT_INPUT ".as"
@@ -11,28 +16,85 @@
 #define FILE_EXT_OBJECT ".ob"
 #define FILE_EXT_ENTRY ".ent"
 #define FILE_EXT_EXTERN ".ext"
+#define FILE_EXT_RELOC ".rel"
+#define FILE_EXT_BINARY ".bin"
+#define FILE_EXT_ARCHIVE ".lib"
+
+/* Relocation kinds of the .rel file */
+#define RELOC_KIND_RELOCATABLE "R"   /* word holds a label address, rebased with the program */
+#define RELOC_KIND_EXTERNAL "E"      /* word refers to an external symbol, followed by its name */
+#define MAX_RELOC_KIND_LENGTH (MAX_LABEL_NAME_LENGTH + 3)
 
 #define MAX_FILENAME_LENGTH 100
+#define MAX_EXTENSION_LENGTH 4      /* longest extension above, base names must leave room for it */
 
 #define PASS_ERROR -1 /* Pass result code */
 
+/* Tables used while assembling a single file, reset (not freed) between files */
+typedef struct {
+    SymbolTable symtab;
+    MacroTable macrotab;
+    SourceBuffer as_source;      /* source (.as) file contents */
+    SourceBuffer am_source;      /* expanded (.am) source */
+    SourceBuffer output;         /* rendered output file (.ob/.ent/.ext), reused per file */
+    SourceBuffer log;            /* messages of current file, captured for the cache */
+    SourceBuffer cache_entry;    /* cache entry being read or built */
+    StatementTable statements;
+    FixupTable fixups;
+    MemoryImage memory;
+    Arena line_arena;            /* line-scoped token storage */
+    FileStats stats;             /* statistics of current file */
+    FileStats totals;            /* statistics of all files assembled on these tables (kept on reset) */
+} FileTables;
+
 /* Function prototypes */
 
+int init_file_tables(FileTables *tables);
+
+void reset_file_tables(FileTables *tables);
+
+void free_file_tables(FileTables *tables);
+
 void safe_fclose(FILE **fp);
 
 FILE *open_source_file(const char *filename);
 
+long get_file_size(const char *filename);
+
 FILE *open_output_file(const char *filename);
 
-void write_file_line(FILE *fp, const char *part1, const char *part2);
+int write_text_file(const char *filename, const char *text, size_t length);
+
+int read_input_file(SourceBuffer *buffer, const char *filename);
+
+int write_output_file(const char *filename, const char *text, size_t length);
 
-int preprocess_macros(const char* src_filename, const char* am_filename, MacroTable *macrotab);
+void remove_output_file(const char *filename);
 
-int first_pass(const char *filename, SymbolTable *symtab, MemoryImage *memory);
+int preprocess_macros(const SourceBuffer *as_source, SourceBuffer *am_source, MacroTable *macrotab);
+
+int first_pass(
+    const char *filename, const SourceBuffer *am_source, StatementTable *statements,
+    SymbolTable *symtab, MemoryImage *memory, FixupTable *fixups, Arena *line_arena
+);
 
 int second_pass(
-    const char *filename, SymbolTable *symtab, MemoryImage *memory,
-    const char *obj_file, const char *ent_file, const char *ext_file
+    SymbolTable *symtab, MemoryImage *memory,
+    const StatementTable *statements, const FixupTable *fixups
+);
+
+int render_object_file(MemoryImage *memory, SourceBuffer *output);
+
+int render_entry_file(SymbolTable *symtab, SourceBuffer *output);
+
+int render_extern_file(MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output);
+
+int render_relocation_file(MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output);
+
+int write_output_files(
+    SymbolTable *symtab, MemoryImage *memory, SourceBuffer *output,
+    const char *obj_file, const char *ent_file, const char *ext_file,
+    const char *rel_file, const char *bin_file
 );
 
 #endif
\ No newline at end of file
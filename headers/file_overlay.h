@@ -0,0 +1,30 @@
+#ifndef FILE_OVERLAY_H
+#define FILE_OVERLAY_H
+
+#include <pthread.h>
+
+#include "utils.h"
+#include "source_buffer.h"
+
+#define OVERLAY_NOT_FOUND -1         /* file is not in the overlay (or none is bound), use the disk */
+
+/* In-memory files of a request: sources sent by the client, and the output files captured instead of written */
+typedef struct {
+    const SourceBuffer *inputs;  /* RECORD_INPUT records (NULL if none) */
+    SourceBuffer outputs;        /* RECORD_OUTPUT records, in writing order */
+    pthread_mutex_t lock;        /* guards outputs, written by all worker threads of a request */
+} FileOverlay;
+
+/* Function prototypes */
+
+int init_file_overlay(FileOverlay *overlay);
+
+void free_file_overlay(FileOverlay *overlay);
+
+void set_file_overlay(FileOverlay *overlay, const SourceBuffer *inputs);
+
+int read_overlay_file(const char *filename, SourceBuffer *buffer);
+
+int write_overlay_file(const char *filename, const char *text, size_t length);
+
+#endif
\ No newline at end of file
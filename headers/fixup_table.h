@@ -0,0 +1,32 @@
+#ifndef FIXUP_TABLE_H
+#define FIXUP_TABLE_H
+
+#include "utils.h"
+
+#define INITIAL_FIXUPS_CAPACITY 16
+
+/* Operand word waiting for a label address */
+typedef struct {
+    const char *symbol;          /* referenced symbol name, view into statement text */
+    int symbol_length;           /* length of symbol name */
+    int address;                 /* memory address of the word to patch */
+    int line_num;                /* source line, for error reporting */
+} Fixup;
+
+typedef struct {
+    Fixup *fixups;               /* dynamic array of fixups, in source order */
+    int count;                   /* current number of fixups */
+    int capacity;                /* allocated capacity of the array */
+} FixupTable;
+
+/* Function prototypes */
+
+int init_fixup_table(FixupTable *table);
+
+void free_fixup_table(FixupTable *table);
+
+void reset_fixup_table(FixupTable *table);
+
+int add_fixup(FixupTable *table, const char *symbol, int symbol_length, int address, int line_num);
+
+#endif
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef INSTRUCTIONS_H
 #define INSTRUCTIONS_H
 
+#include "keywords.h"
+#include "memory.h"
+
 #define INSTRUCTIONS_COUNT 16
 
 /* Instruction Operands Amount */
@@ -10,6 +13,11 @@
 
 #define MAX_INSTRUCTION_WORDS 5 /* maximum amount an instruction can require in memory. */
 
+/* Opcodes after which execution never continues to the next instruction */
+#define OPCODE_JMP  9
+#define OPCODE_RTS  14
+#define OPCODE_STOP 15
+
 /* Addressing Mode Numeric IDs */
 #define ADDR_MODE_IMMEDIATE 0
 #define ADDR_MODE_DIRECT    1
@@ -30,17 +38,33 @@ typedef struct {
     int legal_dest_addr_modes;  /* address mode for destination operand */
 } Instruction;
 
+/* Parsed operand: its text, and the addressing mode computed once when the line is parsed */
+typedef struct {
+    char *text;                 /* operand token (null terminated copy) */
+    int length;                 /* length of operand token */
+    int mode;                   /* ADDR_MODE_* for instruction operands, -1 for directive values */
+} Operand;
+
 /* Function prototypes */
 
+const Instruction* get_instruction_span(const char *name, size_t length);
+
 const Instruction* get_instruction(const char *name);
 
+const Instruction* get_instruction_by_opcode(int opcode);
+
 int get_addressing_mode(const char *operand);
 
-int calculate_instruction_length(const Instruction *inst, char **operands, int operand_count);
+int calculate_instruction_length(const Instruction *inst, const Operand *operands, int operand_count);
+
+int decode_instruction_length(MemoryWord word);
 
 /* Validation macros */
 
 #define IS_INSTRUCTION(name) \
-    (get_instruction(name) != NULL)
+    IS_KEYWORD_OF_CLASS((name), KEYWORD_INSTRUCTION)
+
+#define ENDS_CONTROL_FLOW(opcode) \
+    (((opcode) == OPCODE_JMP) || ((opcode) == OPCODE_RTS) || ((opcode) == OPCODE_STOP))
 
 #endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef KEYWORD_SLOTS_H
+#define KEYWORD_SLOTS_H
+
+#include "keywords.h"
+
+/*
+Perfect hash table: keyword index per hash slot, -1 for empty slots.
+Generated by tools/gen_keyword_slots.c (make keyword-slots), do not edit.
+*/
+static const signed char keyword_slots[KEYWORD_SLOTS] = {
+    2, -1, 28, -1, -1, -1, -1, -1, -1, -1, -1, -1, 22, -1, 36, 15,
+    -1, -1, -1, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, 33, -1, -1,
+    -1, 29, -1, -1, -1, -1, -1, 21, 5, -1, -1, -1, 0, -1, -1, -1,
+    18, -1, 10, 19, -1, -1, 4, -1, -1, -1, -1, -1, -1, 11, -1, -1,
+    30, -1, -1, -1, 26, -1, 17, -1, -1, -1, 35, -1, -1, 13, -1, -1,
+    -1, 25, -1, -1, 34, -1, 23, -1, -1, -1, -1, -1, -1, -1, -1, 31,
+    -1, -1, -1, 27, 14, -1, -1, -1, 8, -1, -1, -1, -1, -1, -1, -1,
+    1, -1, -1, 6, -1, 20, -1, 9, 16, -1, 3, 24, -1, -1, 32, 7
+};
+
+#endif
\ No newline at end of file
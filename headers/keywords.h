@@ -0,0 +1,48 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include "utils.h"
+
+#define KEYWORDS_COUNT 37       /* 16 instructions, 10 directives, 9 registers, 2 macro keywords */
+#define KEYWORD_SLOTS 128       /* perfect hash table size (power of 2) */
+#define MAX_KEYWORD_LENGTH 7    /* longest keywords: .string / .extern / mcroend */
+
+/* Keyword Classes */
+#define KEYWORD_NONE 0
+#define KEYWORD_INSTRUCTION 1   /* id: opcode */
+#define KEYWORD_DIRECTIVE 2     /* id: DIRECTIVE_* ID, NO_DIRECTIVE for names without '.' */
+#define KEYWORD_REGISTER 3      /* id: register number, PSW_REGISTER_ID for PSW */
+#define KEYWORD_MACRO 4         /* id: MACRO_KEYWORD_START / MACRO_KEYWORD_END */
+
+#define PSW_REGISTER_ID 8
+#define MACRO_KEYWORD_START 0
+#define MACRO_KEYWORD_END 1
+
+typedef struct {
+    const char *name;
+    int keyword_class;          /* KEYWORD_* class */
+    int id;                     /* ID within the class */
+} Keyword;
+
+/* Function prototypes */
+
+const Keyword *find_keyword_span(const char *name, size_t length);
+
+const Keyword *find_keyword(const char *name);
+
+int get_keyword_span_class(const char *name, size_t length);
+
+int get_keyword_class(const char *name);
+
+int build_keyword_slots(signed char *slots);
+
+int check_instruction_keywords(void);
+
+int check_keyword_slots(void);
+
+/* Validation macros */
+
+#define IS_KEYWORD_OF_CLASS(name, keyword_class) \
+    (get_keyword_class(name) == (keyword_class))
+
+#endif
\ No newline at end of file
@@ -3,13 +3,14 @@
 
 #include "memory.h"
 #include "symbol_table.h"
+#include "tokenizer.h"
 
 /* Function prototypes */
 
-int is_directive_line(char **tokens, int token_count);
+int is_directive_line(const Token *tokens, int token_count);
 
-int is_instruction_line(char **tokens, int token_count);
+int is_instruction_line(const Token *tokens, int token_count);
 
-int check_line_format(char **tokens, int token_count, int line_num);
+int check_line_format(const Token *tokens, int token_count, int line_num);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef LINKER_H
+#define LINKER_H
+
+#include "utils.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "archive.h"
+
+#define INITIAL_LINK_MODULES 16
+#define MAX_LINK_WORDS (MAX_WORD_COUNT - IC_START)   /* code & data of all objects share addresses IC_START-255 */
+#define MAX_LINK_CONTEXT_LENGTH (MAX_LABEL_NAME_LENGTH + MAX_FILENAME_LENGTH + 4)   /* "<symbol> in <object>" */
+
+/* Link word flags */
+#define LINK_WORD_CODE 1             /* instruction word (data word otherwise) */
+#define LINK_WORD_BLOCK_START 2      /* starts a block: code / data start of its object, label operand target or entry */
+#define LINK_WORD_REACHABLE 4        /* reachable from the program entry point (dead code elimination) */
+
+/* Object being linked, the contents of its binary object are kept in Linker.objects */
+typedef struct {
+    const char *name;            /* object name, for messages (kept by caller) */
+    size_t offset;               /* start of binary object in Linker.objects */
+    size_t length;
+    int first_word;              /* index of its first word in Linker.words */
+} LinkModule;
+
+/* Word of a loaded object. The words of all objects are numbered one after another (code, then data of each object) */
+typedef struct {
+    MemoryWord value;            /* word as assembled */
+    unsigned char flags;         /* LINK_WORD_* flags */
+    int address;                 /* linked address, -1 if eliminated */
+    int target;                  /* word its label / external operand refers to, -1 if none */
+} LinkWord;
+
+/* Linker state: the loaded objects, then the linked image & its global index of entry symbols */
+typedef struct {
+    LinkModule *modules;
+    int count;
+    int capacity;
+    SourceBuffer objects;        /* binary objects of all modules, back to back */
+    SourceBuffer scratch;        /* object file being read */
+    LinkWord *words;             /* words of all objects */
+    int *pending;                /* reachable blocks not scanned yet */
+    int word_count;
+    int word_capacity;
+    int remove_dead_code;        /* 'boolean' flag, keep only the blocks reachable from the entry point */
+    int removed_blocks;          /* blocks eliminated by last link */
+    int removed_words;           /* words eliminated by last link */
+    MemoryImage image;           /* linked executable image */
+    SymbolTable symtab;          /* entry symbols of all modules, at linked addresses */
+} Linker;
+
+/* Function prototypes */
+
+int init_linker(Linker *linker);
+
+void free_linker(Linker *linker);
+
+int add_link_module(Linker *linker, const char *name, const char *data, size_t length);
+
+int add_link_object(Linker *linker, const char *base_filename);
+
+int add_archive_members(Linker *linker, Archive archives[], int archive_count);
+
+int link_objects(Linker *linker);
+
+/* Access macros */
+
+#define MODULE_OBJECT(linker, module) \
+    ((const unsigned char *)(linker)->objects.text + (module)->offset)
+
+#endif
\ No newline at end of file
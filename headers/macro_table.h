@@ -2,10 +2,20 @@
 #define MACRO_TABLE_H
 
 #include "utils.h"
+#include "keywords.h"
+#include "arena.h"
 
 #define INITIAL_MACROS_CAPACITY 8
 #define MAX_MACRO_NAME_LENGTH 31  /* 30 chars + null terminator */
 #define INITIAL_MACRO_BODY_CAPACITY 8
+#define INITIAL_MACRO_INDEX_CAPACITY 16  /* must be a power of 2 */
+
+/* Macro names pre-filter, 256 bloom bits set by 2 hash probes */
+#define MACRO_BLOOM_BITS 256
+#define MACRO_BLOOM_WORD_BITS 32
+#define MACRO_BLOOM_WORDS (MACRO_BLOOM_BITS / MACRO_BLOOM_WORD_BITS)
+
+#define EMPTY_MACRO_SLOT -1
 
 /* Macro open / close keywords */
 #define MACRO_START "mcro"
@@ -13,7 +23,7 @@
 
 typedef struct {
     char name[MAX_MACRO_NAME_LENGTH];
-    char **body;        /* dynamic array of chars of each line */
+    char **body;        /* dynamic array of lines, text owned by table arena */
     int line_count;     /* current number of lines */
     int body_capacity;  /* allocated capacity for body lines */
 } Macro;
@@ -22,6 +32,10 @@ typedef struct {
     Macro *macros;      /* dynamic array of macros */
     int count;          /* current number of macros */
     int capacity;       /* total allocated macro slots */
+    int *index;         /* open-addressing hash index, holds positions in macros array */
+    int index_capacity; /* number of index slots (power of 2, at most half full) */
+    unsigned long bloom[MACRO_BLOOM_WORDS]; /* bloom bits of all macro names */
+    Arena text;         /* storage of all macro body lines */
 } MacroTable;
 
 /* Function prototypes */
@@ -30,27 +44,36 @@ int init_macro_table(MacroTable *table);
 
 void free_macro_table(MacroTable *table);
 
+void reset_macro_table(MacroTable *table);
+
 int is_valid_macro_start(const char *name);
 
+const Macro *find_macro_span(const MacroTable *table, const char *name, size_t length);
+
 const Macro *find_macro(const MacroTable *table, const char *name);
 
 int add_macro(MacroTable *table, const char *name);
 
-int add_line_to_macro(Macro *macro, const char *line_content);
+int add_line_to_macro(MacroTable *table, Macro *macro, const char *line_content);
 
 int is_macro_call(const char *line, const MacroTable *table);
 
 /* Validation macros */
 
 #define IS_MACRO_KEYWORD(label) \
-    (strcmp((label), MACRO_START) == 0 || \
-     strcmp((label), MACRO_END) == 0)
+    IS_KEYWORD_OF_CLASS((label), KEYWORD_MACRO)
 
 #define IS_MACRO_DEFINITION(line) \
     (strncmp((line), MACRO_START " ", strlen(MACRO_START) + 1) == 0 || \
      (strncmp((line), MACRO_START, strlen(MACRO_START)) == 0 && \
       (line)[strlen(MACRO_START)] == NULL_TERMINATOR))
 
+#define BLOOM_WORD(hash) \
+    (((hash) / MACRO_BLOOM_WORD_BITS) % MACRO_BLOOM_WORDS)
+
+#define BLOOM_MASK(hash) \
+    (1UL << ((hash) % MACRO_BLOOM_WORD_BITS))
+
 #define IS_MACRO_END(line) \
     (strcmp((line), MACRO_END) == 0)
 
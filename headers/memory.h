@@ -2,6 +2,7 @@
 #define MEMORY_H
 
 #include "utils.h"
+#include "keywords.h"
 
 /* Architecture limits */
 #define MAX_WORD_COUNT 256            /* total addressable memory (0-255) */
@@ -10,6 +11,7 @@
 #define MAX_IC_SIZE   156             /* available instruction words IC (100-255) */
 
 #define WORD_MASK 0x3FF               /* Mask to enforce 10-bit word size (bits 0-9 set to 1) */
+#define ADDRESS_MASK 0xFF             /* Mask to enforce 8-bit address size (0-255) */
 
 #define REGISTER_CHAR 'r'             /* r0-r7 */
 #define PSW_REGISTER "PSW"            /* Program Status Word register */
@@ -25,47 +27,37 @@
 #define ARE_EXTERNAL 1                /* 01 in binary */ 
 #define ARE_RELOCATABLE 2             /* 10 in binary */
 
-/* First instruction word format */
+/* Packed word fields (10-bit payload in bits 0-9) */
+#define ARE_MASK 0x3                  /* A/R/E bits 0-1 */
+#define MODE_MASK 0x3                 /* addressing mode fields of first instruction word */
+#define DEST_MODE_SHIFT 2             /* bits 2-3 */
+#define SRC_MODE_SHIFT 4              /* bits 4-5 */
+#define OPCODE_MASK 0xF
+#define OPCODE_SHIFT 6                /* bits 6-9 */
+#define VALUE_MASK 0xFF               /* operand value / address, bits 2-9 */
+#define VALUE_SHIFT 2
+#define REG_MASK 0xF                  /* register fields of register word */
+#define REG_SRC_SHIFT 6               /* source register starts at bit 6 */
+#define REG_DST_SHIFT 2               /* destination register starts at bit 2 */
+
+/* Memory word: 10-bit instruction / operand / register / data word, packed in 16 bits */
+typedef unsigned short MemoryWord;
+
+/* Symbol operand word, recorded when its label is resolved */
 typedef struct {
-    unsigned int are    : 2;          /* A/R/E bits 0–1 */
-    unsigned int dest   : 2;          /* bits 2–3 */
-    unsigned int src    : 2;          /* bits 4–5 */
-    unsigned int opcode : 4;          /* bits 6–9 */
-} InstrWord;
+    int symbol_index;                 /* index of symbol in symbol table */
+    unsigned short address;           /* absolute address of operand word */
+    unsigned char are;                /* ARE_RELOCATABLE / ARE_EXTERNAL */
+} Relocation;
 
-/* Operand word: address or immediate value */
+/* Memory image: separate code & data words, and relocations of symbol operands */
 typedef struct {
-    unsigned int are : 2;             /* A/R/E bits 0–1 */
-    signed int value : 8;             /* bits 2–9 */
-    signed int ext_symbol_index;
-} OperandWord;
-
-/* Register-pair operand word */
-typedef struct {
-    unsigned int are     : 2;         /* A/R/E bits 0–1 */
-    unsigned int reg_dst : 4;         /* bits 2–5 */
-    unsigned int reg_src : 4;         /* bits 6–9 */
-} RegWord;
-
-/* Data word for .data/.string/.mat */
-typedef struct {
-    signed int value : 10;            /* bits 0–9 */
-} DataWord;
-
-/* Union to store any type of word */
-typedef union {
-    InstrWord   instr;
-    OperandWord operand;
-    RegWord     reg;
-    DataWord    data;
-    unsigned int raw;                 /* for direct output to file */
-} MemoryWord;
-
-/* Memory image: flat array of words */
-typedef struct {
-    MemoryWord words[MAX_WORD_COUNT]; /* addresses 0–255 */
+    MemoryWord code[MAX_IC_SIZE];     /* instruction words, addresses IC_START onwards */
+    MemoryWord data[MAX_DC_SIZE];     /* data words, placed after instructions in output */
     unsigned int ic;                  /* instruction counter */
     unsigned int dc;                  /* data counter */
+    Relocation relocations[MAX_IC_SIZE]; /* in address order */
+    int relocation_count;
 } MemoryImage;
 
 /* Function prototypes */
@@ -78,6 +70,28 @@ int check_dc_limit(int current_dc);
 
 int store_value(MemoryImage *memory, int value);
 
+void add_relocation(MemoryImage *memory, int address, int are, int symbol_index);
+
+/* Word packing macros */
+
+#define PACK_INSTR_WORD(opcode, src_mode, dest_mode) \
+    ((MemoryWord)((((opcode) & OPCODE_MASK) << OPCODE_SHIFT) | \
+                  (((src_mode) & MODE_MASK) << SRC_MODE_SHIFT) | \
+                  (((dest_mode) & MODE_MASK) << DEST_MODE_SHIFT) | ARE_ABSOLUTE))
+
+#define PACK_OPERAND_WORD(value, are) \
+    ((MemoryWord)((((value) & VALUE_MASK) << VALUE_SHIFT) | ((are) & ARE_MASK)))
+
+#define PACK_REG_WORD(reg_src, reg_dst) \
+    ((MemoryWord)((((reg_src) & REG_MASK) << REG_SRC_SHIFT) | \
+                  (((reg_dst) & REG_MASK) << REG_DST_SHIFT) | ARE_ABSOLUTE))
+
+#define OPERAND_VALUE(word) \
+    (((word) >> VALUE_SHIFT) & VALUE_MASK)
+
+#define CODE_WORD(memory, address) \
+    ((memory)->code[(address) - IC_START])
+
 /* Validation macros */
 
 #define IS_REGISTER(str) \
@@ -90,6 +104,6 @@ int store_value(MemoryImage *memory, int value);
     (strcmp((str), PSW_REGISTER) == 0)
 
 #define IS_REGISTER_OR_PSW(str) \
-    (IS_REGISTER(str) || IS_PSW(str))
+    IS_KEYWORD_OF_CLASS((str), KEYWORD_REGISTER)
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+/* Command line flags */
+#define OPTION_PREFIX "--"
+#define OPTION_KEEP_AM "--keep-am"
+#define OPTION_STATS "--stats"
+#define OPTION_RELOC "--reloc"       /* also write the relocation table to a .rel file */
+#define OPTION_BINARY "--binary"     /* also write a binary object to a .bin file */
+#define OPTION_JOBS "-j"             /* followed by the number of worker threads */
+#define OPTION_CACHE_DIR "--cache-dir"   /* followed by the cache directory */
+#define OPTION_CACHE_SIZE "--cache-size" /* followed by the cache size limit, in KB */
+#define OPTION_SERVE "--serve"           /* followed by the socket path to serve requests on */
+
+#define MAX_JOBS 64                  /* upper limit of worker threads */
+#define MAX_CACHE_SIZE 1048576L      /* upper limit of cache size, in KB (1 GB) */
+
+typedef struct {
+    char **files;                /* base filenames (without extension) to assemble */
+    int file_count;              /* number of base filenames */
+    int keep_am;                 /* 'boolean' flag, write expanded source to .am file */
+    int stats;                   /* 'boolean' flag, print timing & size statistics */
+    int write_relocations;       /* 'boolean' flag, write relocation table to .rel file */
+    int write_binary;            /* 'boolean' flag, write binary object to .bin file */
+    int jobs;                    /* number of files assembled concurrently (1 = serial) */
+    const char *cache_dir;       /* directory of cached results (NULL = no cache) */
+    long cache_size;             /* cache size limit in bytes (0 = unlimited) */
+    const char *serve_socket;    /* socket path of the resident server (NULL = assemble files) */
+} AssemblerOptions;
+
+/* Function prototypes */
+
+int parse_options(int argc, char *argv[], AssemblerOptions *options);
+
+void free_options(AssemblerOptions *options);
+
+/* Validation macros */
+
+#define IS_VALUE_OPTION(arg) \
+    ((strcmp((arg), OPTION_JOBS) == 0) || \
+     (strcmp((arg), OPTION_CACHE_DIR) == 0) || \
+     (strcmp((arg), OPTION_CACHE_SIZE) == 0) || \
+     (strcmp((arg), OPTION_SERVE) == 0))
+
+#define IS_OPTION(arg) \
+    (strncmp((arg), OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "utils.h"
+#include "source_buffer.h"
+
+/*
+Records exchanged with the resident assembler (--serve), and held by a file overlay.
+Each record is a "<kind> <name length> <data length>" line, followed by the name & data bytes.
+*/
+#define RECORD_CWD "cwd"             /* request: working directory of the client (data) */
+#define RECORD_ARG "arg"             /* request: command line argument (data) */
+#define RECORD_INPUT "in"            /* request: in-memory source file (name & data) */
+#define RECORD_STOP "stop"           /* request: shut the server down */
+#define RECORD_LOG "log"             /* response: messages printed while assembling (data) */
+#define RECORD_OUTPUT "out"          /* response: output file of in-memory sources (name & data) */
+#define RECORD_EXIT "exit"           /* response: exit code (data) */
+
+#define MAX_RECORD_KIND_LENGTH 8
+#define MAX_RECORD_HEADER_LENGTH 64
+
+#define DEFAULT_SOCKET_PATH "/tmp/assembler.sock"
+#define MAX_SOCKET_PATH_LENGTH 108   /* size of sun_path */
+#define MAX_CWD_LENGTH 4096          /* working directory of a request */
+#define SOCKET_BUFFER_SIZE 65536     /* bytes moved per socket read / write */
+
+/* Record span inside a buffer */
+typedef struct {
+    char kind[MAX_RECORD_KIND_LENGTH];
+    const char *name;            /* not null terminated */
+    size_t name_length;
+    const char *data;            /* not null terminated */
+    size_t data_length;
+} Record;
+
+/* Function prototypes */
+
+int append_record(SourceBuffer *buffer, const char *kind, const char *name, size_t name_length, const char *data, size_t data_length);
+
+int next_record(const SourceBuffer *buffer, size_t *position, Record *record);
+
+int read_socket(int fd, SourceBuffer *buffer);
+
+int write_socket(int fd, const char *text, size_t length);
+
+/* Validation macros */
+
+#define IS_RECORD(record, record_kind) \
+    (strcmp((record)->kind, (record_kind)) == 0)
+
+#define IS_RECORD_NAME(record, filename) \
+    (((record)->name_length == strlen(filename)) && \
+     (strncmp((record)->name, (filename), (record)->name_length) == 0))
+
+#endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <pthread.h>
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "options.h"
+#include "file_io.h"
+#include "stats.h"
+
+/* Assembles a single input file (options->files[file_index]) using the given tables */
+typedef int (*FileJob)(const AssemblerOptions *options, int file_index, FileTables *tables);
+
+/* Input file with its size, for largest-first scheduling */
+typedef struct {
+    int file_index;              /* index in options->files */
+    long size;                   /* size of .as file in bytes (-1 if missing) */
+} Job;
+
+/* Per-worker job queue: the owner takes from the head, thieves steal from the tail */
+typedef struct {
+    int *file_indexes;           /* dealt jobs, largest first */
+    int head;                    /* next job of owner */
+    int tail;                    /* one past the last pending job */
+    pthread_mutex_t lock;
+} JobQueue;
+
+/* Outcome of a finished job, held until all earlier jobs were printed */
+typedef struct {
+    char *log;                   /* buffered diagnostics (NULL if printed already) */
+    int success;                 /* 'boolean' flag, job result */
+    int done;                    /* 'boolean' flag, job finished */
+} JobResult;
+
+struct Scheduler;
+
+/* Worker thread, owning its queue, tables & log */
+typedef struct {
+    JobQueue queue;
+    FileTables tables;
+    SourceBuffer log;            /* diagnostics of the running job */
+    pthread_t thread;
+    int started;                 /* 'boolean' flag, thread was created */
+    int index;                   /* position in scheduler workers */
+    struct Scheduler *scheduler;
+} Worker;
+
+typedef struct Scheduler {
+    const AssemblerOptions *options;
+    FileJob job;
+    Worker *workers;
+    int worker_count;
+    JobResult *results;          /* indexed by file index */
+    SourceBuffer *output_log;    /* log bound to the starting thread, logs are printed to (NULL: stdout) */
+    int next_output;             /* first file index whose log was not printed */
+    int success_count;
+    pthread_mutex_t output_lock; /* guards results, next_output & success_count */
+} Scheduler;
+
+/* Function prototypes */
+
+int run_parallel_jobs(const AssemblerOptions *options, FileJob job, FileStats *totals);
+
+#endif
\ No newline at end of file
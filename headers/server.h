@@ -0,0 +1,38 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "options.h"
+#include "file_io.h"
+#include "file_overlay.h"
+#include "cache.h"
+#include "protocol.h"
+
+#define MAX_REQUEST_ARGS 1024        /* command line arguments of a single request */
+#define MAX_EXIT_CODE_LENGTH 12
+#define MAX_REQUEST_OPTION_LENGTH MAX_CACHE_DIR_LENGTH    /* longest flag or flag value, a --cache-dir path */
+
+/* Runs the assembler on the parsed options of a request, returns its exit code */
+typedef int (*RequestRun)(const AssemblerOptions *options, FileTables *tables);
+
+/* Resident server state, kept warm between requests */
+typedef struct {
+    int listen_fd;
+    SourceBuffer request;        /* records received from the client */
+    SourceBuffer arguments;      /* null terminated working directory & arguments of the request */
+    SourceBuffer log;            /* messages printed while serving the request */
+    SourceBuffer response;       /* records sent back to the client */
+    FileOverlay overlay;         /* in-memory sources & captured outputs of the request */
+    char start_dir[MAX_CWD_LENGTH];  /* directory the server started in, returned to after each request */
+    char *argv[MAX_REQUEST_ARGS + 1];
+    int argc;
+    int has_inputs;              /* 'boolean' flag, request carries in-memory sources */
+    int stop;                    /* 'boolean' flag, request asks the server to stop */
+} Server;
+
+/* Function prototypes */
+
+int serve_requests(const char *socket_path, RequestRun run, FileTables *tables);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include "utils.h"
+
+#define INITIAL_SOURCE_CAPACITY 1024
+
+/* In-memory text: the read .as input, the expanded (.am) source shared by both passes, or a rendered output file */
+typedef struct {
+    char *text;                  /* null terminated text of all lines */
+    size_t length;               /* current text length (without null terminator) */
+    size_t capacity;             /* allocated size of text buffer */
+} SourceBuffer;
+
+/* Function prototypes */
+
+int init_source_buffer(SourceBuffer *buffer);
+
+void free_source_buffer(SourceBuffer *buffer);
+
+void reset_source_buffer(SourceBuffer *buffer);
+
+int append_source_text(SourceBuffer *buffer, const char *text);
+
+int append_source_span(SourceBuffer *buffer, const char *text, size_t length);
+
+int append_source_line(SourceBuffer *buffer, const char *part1, const char *part2);
+
+int read_source_file(SourceBuffer *buffer, const char *filename);
+
+int read_source_span(SourceBuffer *buffer, FILE *fp, size_t length);
+
+int next_source_line(const SourceBuffer *buffer, size_t *position, const char **line, size_t *length);
+
+long count_source_lines(const SourceBuffer *buffer);
+
+int read_source_line(const SourceBuffer *buffer, size_t *position, char *line, int line_size);
+
+int write_source_file(const SourceBuffer *buffer, const char *filename);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include "utils.h"
+#include "instructions.h"
+#include "directives.h"
+#include "arena.h"
+#include "tokenizer.h"
+
+#define INITIAL_STATEMENTS_CAPACITY 32
+#define INITIAL_OPERANDS_CAPACITY 64
+
+/* Statement kinds */
+#define STATEMENT_INSTRUCTION 0
+#define STATEMENT_DIRECTIVE 1
+
+/* A single classified source line */
+typedef struct {
+    char *label;                 /* label token (with ':'), NULL if none */
+    char *name;                  /* instruction / directive token */
+    int kind;                    /* STATEMENT_INSTRUCTION / STATEMENT_DIRECTIVE */
+    const Instruction *inst;     /* instruction definition, NULL if unknown */
+    int directive;               /* DIRECTIVE_* ID, NO_DIRECTIVE if unknown */
+    int first_operand;           /* index of first operand in table operands array */
+    int operand_count;           /* number of operands / directive values */
+    int line_num;                /* source line number */
+} Statement;
+
+/* All statements of a source, stored contiguously */
+typedef struct {
+    Statement *statements;       /* dynamic array of statements, in source order */
+    int count;                   /* current number of statements */
+    int capacity;                /* allocated capacity of statements array */
+    Operand *operands;           /* dynamic array of operands of all statements */
+    int operand_count;           /* current number of operands */
+    int operand_capacity;        /* allocated capacity of operands array */
+    Arena text;                  /* token text storage, never moved once allocated */
+} StatementTable;
+
+/* Function prototypes */
+
+int init_statement_table(StatementTable *table);
+
+void free_statement_table(StatementTable *table);
+
+void reset_statement_table(StatementTable *table);
+
+Statement *add_statement(StatementTable *table, const Token *tokens, int token_count, int line_num);
+
+/* Validation macros */
+
+#define STATEMENT_OPERANDS(table, statement) \
+    ((table)->operands + (statement)->first_operand)
+
+#define HAS_LABEL(statement) \
+    ((statement)->label != NULL)
+
+#define IS_ENTRY_STATEMENT(statement) \
+    ((statement)->kind == STATEMENT_DIRECTIVE && \
+     (statement)->directive == DIRECTIVE_ENTRY)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "utils.h"
+
+/* Timed phases of assembling a file */
+#define PHASE_PREPROCESS 0
+#define PHASE_FIRST_PASS 1
+#define PHASE_SECOND_PASS 2
+#define PHASE_OUTPUT 3        /* writing .am/.ob/.ent/.ext files */
+#define PHASE_COUNT 4
+
+#define NANOSECONDS_PER_SECOND 1000000000.0
+
+/* Point in time, as wall clock & CPU clock of the calling thread */
+typedef struct {
+    double wall;             /* seconds, monotonic clock */
+    double cpu;              /* seconds, thread CPU clock */
+} Timestamp;
+
+/* Time spent in a phase */
+typedef struct {
+    double wall;
+    double cpu;
+} PhaseTime;
+
+/* Timing & size statistics of one file, or accumulated over files */
+typedef struct {
+    PhaseTime phases[PHASE_COUNT];
+    long files;              /* files accumulated into the statistics */
+    long lines;              /* source (.as) lines read */
+    long words;              /* memory words emitted (IC + DC) */
+    long symbols;            /* peak symbol table size */
+    long macros;             /* peak macro table size */
+    long macro_lines;        /* peak total of macro body lines */
+    long cache_hits;         /* files restored from the cache (--cache-dir) */
+    long cache_misses;       /* files assembled & stored into the cache */
+} FileStats;
+
+/* Function prototypes */
+
+void init_file_stats(FileStats *stats);
+
+void get_timestamp(Timestamp *timestamp);
+
+void add_phase_time(FileStats *stats, int phase, Timestamp *start);
+
+void add_file_stats(FileStats *total, const FileStats *stats);
+
+void print_file_stats(const char *title, const FileStats *stats, double elapsed);
+
+#endif
\ No newline at end of file
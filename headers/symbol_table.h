@@ -1,7 +1,12 @@
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
+#include "tokenizer.h"
+
 #define INITIAL_SYMBOLS_CAPACITY 8
+#define INITIAL_SYMBOL_INDEX_CAPACITY 16 /* must be a power of 2 */
+
+#define EMPTY_SLOT -1
 
 #define MAX_LABEL_NAME_LENGTH 31 /* max label name length (30 + null terminator) */
 
@@ -23,6 +28,8 @@ typedef struct {
     Symbol *symbols;             /* dynamic array of symbols */
     unsigned int count;          /* current number of symbols */
     unsigned int capacity;       /* current capacity of the array */
+    int *index;                  /* open-addressing hash index, holds positions in symbols array */
+    unsigned int index_capacity; /* number of index slots (power of 2, at most half full) */
 } SymbolTable;
 
 /* Function prototypes */
@@ -31,6 +38,10 @@ int init_symbol_table(SymbolTable *table);
 
 void free_symbol_table(SymbolTable *table);
 
+void reset_symbol_table(SymbolTable *table);
+
+Symbol* find_symbol_span(SymbolTable *table, const char *name, size_t length);
+
 Symbol* find_symbol(SymbolTable *table, const char *name);
 
 int add_symbol(SymbolTable *table, const char *name, int value, int type);
@@ -41,7 +52,7 @@ int has_externs(const SymbolTable *table);
 
 int is_valid_label(char *label);
 
-int is_first_token_label(char **tokens, int token_count);
+int is_first_token_label(const Token *tokens, int token_count);
 
 int process_label(char *label, SymbolTable *table, int address, int symbol_type);
 
@@ -1,18 +1,24 @@
 #ifndef TOKENIZER_H
 #define TOKENIZER_H
 
-#define INITIAL_TOKEN_SIZE 32
-#define INITIAL_TOKENS_CAPACITY 16
+#include "arena.h"
+
+/* Token view: a span inside the parsed line, not null terminated */
+typedef struct {
+    const char *start;         /* first char of token inside the line */
+    int length;                /* amount of chars in token */
+} Token;
+
+/* Line arena block size: the token array of a MAX_LINE_LENGTH line fits in a single block */
+#define LINE_ARENA_SIZE ARENA_ALIGN((MAX_LINE_LENGTH + 1) * sizeof(Token))
 
 /* Structure to hold parsing state */
 typedef struct {
-    char *current_token;       /* buffer for current token being built */
-    char **tokens;             /* array of completed tokens */
+    const char *line;          /* line being parsed, tokens point into it */
+    Token *tokens;             /* array of completed tokens */
     int in_token;              /* flag indicating if building a token */
-    int char_index;            /* position in current_token */
+    int token_start;           /* line position where current token starts */
     int token_index;           /* position in tokens array */
-    int current_token_size;    /* allocated size of current_token */
-    int tokens_capacity;       /* allocated capacity of tokens array */
     int prev_was_comma;        /* flag for comma validation */
     int *token_count;          /* pointer to final token count */
     int in_string;             /* flag to prevent accidental string breakup */
@@ -20,8 +26,15 @@ typedef struct {
 
 /* Function prototypes */
 
-int parse_tokens(const char *line, char ***tokens_ptr, int *token_count);
+int parse_tokens(const char *line, size_t line_length, Arena *arena, Token **tokens_ptr, int *token_count);
+
+/* Validation macros */
+
+#define TOKEN_EQUALS(token, str) \
+    ((size_t)(token).length == strlen(str) && \
+     strncmp((token).start, (str), (token).length) == 0)
 
-void free_tokens(char **tokens, int token_count);
+#define TOKEN_HAS_CHAR(token, cha) \
+    (memchr((token).start, (cha), (token).length) != NULL)
 
 #endif
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 #define MAX_LINE_LENGTH 81  /* 80 chars + null terminator */
 
+#define ASSEMBLER_VERSION "1.1"  /* bump whenever output changes, invalidates cached results */
+
 /* 'Boolean' Constants */
 #define FALSE 0
 #define TRUE !FALSE
@@ -28,6 +30,11 @@
 
 #define BASE10_ENCODING 10
 
+/* String hashing constants (32-bit FNV-1a) */
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+#define HASH_MASK 0xFFFFFFFFUL
+
 /* Function prototypes */
 
 char *copy_string(const char *src);
@@ -46,6 +53,14 @@ void print_line_error(const char *message, const char *context, int line_num);
 
 void print_line_warning(const char *message, const char *context, int line_num);
 
+void print_span_error(const char *message, const char *context, int length);
+
+void print_line_span_error(const char *message, const char *context, int length, int line_num);
+
 void safe_free(void **ptr);
 
+unsigned long hash_span(const char *str, size_t length);
+
+unsigned long hash_string(const char *str);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "diagnostics.h"
+#include "binary_object.h"
+#include "archive.h"
+#include "linker.h"
+
+/*
+Linker of binary objects (./assembler --binary).
+Places the code of all objects one after another from address 100, and their data after all code,
+resolves the external references of every object against the entry symbols of all objects,
+and writes the single executable image as an .ob file (with its .ent file, and .bin with --binary).
+Archives (-l, made by ./archiver) supply the members defining the externals left unresolved by the objects.
+With --gc, only the code & data blocks reachable from the entry point (address 100) are kept.
+*/
+
+#define LINKER_OPTION_OUTPUT "-o"
+#define LINKER_OPTION_BINARY "--binary"
+#define LINKER_OPTION_ARCHIVE "-l"
+#define LINKER_OPTION_DEAD_CODE "--gc"
+#define DEFAULT_LINK_OUTPUT "program"
+
+/* Linker command line */
+typedef struct {
+    const char *output;          /* base filename of linked image */
+    int write_binary;            /* 'boolean' flag, also write the image as binary object */
+    int remove_dead_code;        /* 'boolean' flag, eliminate the blocks unreachable from the entry point */
+    char **objects;              /* base filenames of objects, without extension */
+    int object_count;
+    char **archives;             /* base filenames of archives, without extension */
+    int archive_count;
+} LinkerOptions;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to parse the linker command line.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments
+          LinkerOptions *options - Output options
+Returns: int - TRUE if arguments are valid, FALSE otherwise
+*/
+static int parse_linker_options(int argc, char *argv[], LinkerOptions *options) {
+    int i;
+
+    options->output = DEFAULT_LINK_OUTPUT;
+    options->write_binary = FALSE;
+    options->remove_dead_code = FALSE;
+    options->object_count = 0;
+    options->archive_count = 0;
+    options->objects = malloc(argc * sizeof(char *));
+    options->archives = malloc(argc * sizeof(char *));
+
+    if (!options->objects || !options->archives) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to parse command line");
+        return FALSE;
+    }
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], LINKER_OPTION_OUTPUT) == 0) {
+            if (i + 1 >= argc) {
+                print_error("Missing value of option", LINKER_OPTION_OUTPUT);
+                return FALSE;
+            }
+            options->output = argv[++i];
+        }
+        else if (strcmp(argv[i], LINKER_OPTION_ARCHIVE) == 0) {
+            if (i + 1 >= argc) {
+                print_error("Missing value of option", LINKER_OPTION_ARCHIVE);
+                return FALSE;
+            }
+            options->archives[options->archive_count++] = argv[++i];
+        }
+        else if (strcmp(argv[i], LINKER_OPTION_BINARY) == 0)
+            options->write_binary = TRUE;
+
+        else if (strcmp(argv[i], LINKER_OPTION_DEAD_CODE) == 0)
+            options->remove_dead_code = TRUE;
+
+        else if (argv[i][0] == '-') {
+            print_error("Unknown option", argv[i]);
+            return FALSE;
+        }
+        else
+            options->objects[options->object_count++] = argv[i];
+    }
+    return TRUE;
+}
+
+/*
+Function to write an output of the linked image, named <output><extension>.
+Receives: const char *output - Base filename of linked image
+          const char *extension - Output file extension
+          const SourceBuffer *text - Rendered output
+Returns: int - TRUE if written, FALSE otherwise
+*/
+static int write_linked_file(const char *output, const char *extension, const SourceBuffer *text) {
+    char filename[MAX_FILENAME_LENGTH];
+
+    if (strlen(output) + strlen(extension) >= MAX_FILENAME_LENGTH) {
+        print_error("Filename is too long", output);
+        return FALSE;
+    }
+    sprintf(filename, "%s%s", output, extension);
+
+    return write_source_file(text, filename);
+}
+
+/*
+Function to write the linked image: .ob file, .ent file of all entries (if any), and .bin file when requested.
+Receives: const LinkerOptions *options - Linker command line
+          Linker *linker - Linker holding the linked image
+Returns: int - TRUE if all files were written, FALSE otherwise
+*/
+static int write_linked_image(const LinkerOptions *options, Linker *linker) {
+    SourceBuffer *output = &linker->scratch;
+
+    if (!render_object_file(&linker->image, output) || !write_linked_file(options->output, FILE_EXT_OBJECT, output))
+        return FALSE;
+
+    if (has_entries(&linker->symtab) &&
+        (!render_entry_file(&linker->symtab, output) || !write_linked_file(options->output, FILE_EXT_ENTRY, output)))
+        return FALSE;
+
+    if (options->write_binary &&
+        (!render_binary_object(&linker->image, &linker->symtab, output) || !write_linked_file(options->output, FILE_EXT_BINARY, output)))
+        return FALSE;
+
+    return TRUE;
+}
+
+/*
+Function to load all command line objects & the archive members they need, link them and write the image.
+Receives: const LinkerOptions *options - Linker command line
+          Linker *linker - Initialized linker
+          Archive archives[] - Opened archives of the command line
+Returns: int - TRUE if image was written, FALSE on any error
+*/
+static int run_linker(const LinkerOptions *options, Linker *linker, Archive archives[]) {
+    int i, result = TRUE;
+
+    for (i = 0; i < options->object_count; i++) {
+        if (!add_link_object(linker, options->objects[i]))
+            result = FALSE;
+    }
+    if (result && (options->archive_count > 0) && !add_archive_members(linker, archives, options->archive_count))
+        result = FALSE;
+
+    linker->remove_dead_code = options->remove_dead_code;
+
+    if (!result || !link_objects(linker) || !write_linked_image(options, linker))
+        return FALSE;
+
+    print_message("Linked %d objects into %s%s: IC = %d, DC = %d%c", linker->count, options->output, FILE_EXT_OBJECT,
+                  linker->image.ic, linker->image.dc, NEWLINE);
+
+    if (options->remove_dead_code)
+        print_message("Removed %d unreachable blocks (%d words)%c", linker->removed_blocks, linker->removed_words, NEWLINE);
+
+    return TRUE;
+}
+
+/*
+Function to open all command line archives, link & write the image, then close the archives.
+Receives: const LinkerOptions *options - Linker command line
+          Linker *linker - Initialized linker
+Returns: int - TRUE if image was written, FALSE on any error
+*/
+static int run_linker_with_archives(const LinkerOptions *options, Linker *linker) {
+    Archive *archives = malloc((options->archive_count + 1) * sizeof(Archive));
+    int i, opened, result = TRUE;
+
+    if (!archives) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to open archives");
+        return FALSE;
+    }
+    for (opened = 0; opened < options->archive_count; opened++) {
+        if (!open_archive(&archives[opened], options->archives[opened])) {
+            result = FALSE;
+            break;
+        }
+    }
+    if (result)
+        result = run_linker(options, linker, archives);
+
+    for (i = 0; i < opened; i++) {
+        close_archive(&archives[i]);
+    }
+    free(archives);
+
+    return result;
+}
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point to the linker program.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments (flags, archives & object base filenames)
+Returns: int - 0 if image was linked & written, 1 otherwise
+*/
+int main(int argc, char *argv[]) {
+    LinkerOptions options;
+    Linker linker;
+    int result;
+
+    if (!parse_linker_options(argc, argv, &options)) {
+        free(options.objects);
+        free(options.archives);
+        return 1;
+    }
+    if (options.object_count < 1) {
+        print_error("Expected different app call", "./linker [-o OUTPUT] [--binary] [--gc] [-l ARCHIVE] ... <object1> [object2] ...");
+        free(options.objects);
+        free(options.archives);
+        return 1;
+    }
+    if (!init_linker(&linker)) {
+        print_error("Failed to initialize linker", NULL);
+        free(options.objects);
+        free(options.archives);
+        return 1;
+    }
+    result = run_linker_with_archives(&options, &linker);
+
+    free_linker(&linker);
+    free(options.objects);
+    free(options.archives);
+
+    return result ? 0 : 1;
+}
\ No newline at end of file
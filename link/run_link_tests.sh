@@ -0,0 +1,63 @@
+#!/bin/sh
+# Linker tests: assembles the objects of link/tests with --binary, links them as given, from an archive (-l)
+# and with --gc, and compares the linked images & entries (at their relocated addresses) with the expected files.
+# Run from the repository root (make link-test)
+
+ROOT=$(pwd)
+ASSEMBLER="$ROOT/assembler"
+LINKER="$ROOT/linker"
+ARCHIVER="$ROOT/archiver"
+TEST_DIR="$ROOT/link/tests"
+WORK_DIR="$ROOT/link/tests/results"
+
+for tool in "$ASSEMBLER" "$LINKER" "$ARCHIVER"; do
+    if [ ! -x "$tool" ]; then
+        echo "Error: Missing $tool (run: make)"
+        exit 1
+    fi
+done
+
+rm -rf "$WORK_DIR"
+mkdir -p "$WORK_DIR"
+cp "$TEST_DIR"/*.as "$WORK_DIR"
+cd "$WORK_DIR" || exit 1
+failed=0
+
+# Compares <output>.ob & <output>.ent with <expected>_expected.ob & .ent
+check_outputs() {
+    for extension in ob ent; do
+        if ! cmp -s "$1.$extension" "$TEST_DIR/$2_expected.$extension"; then
+            echo "FAIL: $1.$extension differs from $2_expected.$extension"
+            diff "$1.$extension" "$TEST_DIR/$2_expected.$extension"
+            failed=1
+        fi
+    done
+}
+
+"$ASSEMBLER" --binary gc_main gc_util > assembler.log || { cat assembler.log; exit 1; }
+
+# Both objects linked as given: FUNC & TABLE follow the code & data of gc_main
+"$LINKER" -o plain gc_main gc_util > linker.log || { cat linker.log; exit 1; }
+check_outputs plain plain
+
+# FUNC resolved from an archive member gives the same image
+"$ARCHIVER" util gc_util > archiver.log || { cat archiver.log; exit 1; }
+"$LINKER" -o archive gc_main -l util > linker.log || { cat linker.log; exit 1; }
+check_outputs archive archive
+
+"$LINKER" --gc -o gc gc_main gc_util > linker.log || { cat linker.log; exit 1; }
+
+# DEAD (after stop) & UNUSED (after rts) code blocks, SPARE & TABLE data blocks
+if ! grep -q "^Removed 4 unreachable blocks (9 words)$" linker.log; then
+    echo "FAIL: gc removed blocks"
+    cat linker.log
+    failed=1
+fi
+check_outputs gc gc
+cd "$ROOT" || exit 1
+
+if [ "$failed" -ne 0 ]; then
+    exit 1
+fi
+rm -rf "$WORK_DIR"
+echo "Linker tests passed"
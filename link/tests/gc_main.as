@@ -0,0 +1,11 @@
+; Dead code & data elimination test (linker --gc): DEAD & SPARE are dropped
+.extern FUNC
+
+MAIN:   jsr FUNC
+        lea ARR, r1
+        prn ARR
+        stop
+DEAD:   inc r2
+        rts
+SPARE:  .data 9,9
+ARR:    .data 1,2,3
@@ -0,0 +1,9 @@
+; Library object of the --gc test: FUNC is called, UNUSED & TABLE are not
+.entry FUNC
+.entry TABLE
+
+FUNC:   inc r1
+        rts
+UNUSED: dec r1
+        rts
+TABLE:  .data 5
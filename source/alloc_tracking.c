@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "stats.h"
+#include "diagnostics.h"
+#include "alloc_tracking.h"
+
+/* Header in front of every tracked block, aligned for any data type */
+typedef union {
+    struct {
+        size_t size;             /* requested bytes */
+        int site;                /* ALLOC_SITE_* */
+    } info;
+    long l;
+    double d;
+    void *p;
+} AllocHeader;
+
+static const char *site_names[ALLOC_SITE_COUNT] = {
+    "other", "symbols", "symbol index", "macros", "macro bodies", "macro index",
+    "arenas", "source buffers", "statements", "fixups", "scheduler", "cache"
+};
+
+static const char *phase_names[ALLOC_PHASE_COUNT] = {
+    "preprocess", "first pass", "second pass", "output", "setup"
+};
+
+/* Counters shared by all threads, guarded by counters_lock */
+static AllocCounters site_counters[ALLOC_SITE_COUNT];
+static AllocCounters phase_counters[ALLOC_PHASE_COUNT];
+static AllocCounters total_counters;
+static pthread_mutex_t counters_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Allocation phase of each thread (unset: setup) */
+static int phase_ids[ALLOC_PHASE_COUNT] = {0, 1, 2, 3, 4};
+static pthread_once_t phase_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t phase_key;
+static int phase_key_created = FALSE;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to create the thread-specific phase key, run once per process.
+*/
+static void create_phase_key(void) {
+    phase_key_created = (pthread_key_create(&phase_key, NULL) == 0);
+}
+
+/*
+Function to get the allocation phase of the calling thread.
+Returns: int - ALLOC_PHASE_* / PHASE_* of calling thread
+*/
+static int get_allocation_phase(void) {
+    int *phase;
+
+    pthread_once(&phase_key_once, create_phase_key);
+    phase = phase_key_created ? pthread_getspecific(phase_key) : NULL;
+
+    return phase ? *phase : ALLOC_PHASE_SETUP;
+}
+
+/*
+Function to apply a change of live bytes to a counter, keeping its peak.
+Receives: AllocCounters *counters - Counters to update
+          long delta - Change of live bytes (negative when freed)
+*/
+static void update_live_bytes(AllocCounters *counters, long delta) {
+    counters->live_bytes += delta;
+
+    if (counters->live_bytes > counters->peak_bytes)
+        counters->peak_bytes = counters->live_bytes;
+}
+
+/*
+Function to count a call on the site, phase & total counters.
+Receives: int site - Allocation site (ALLOC_SITE_*)
+          long bytes - Bytes requested (0 for free)
+          long delta - Change of live bytes
+          long copied - Bytes moved by a reallocation (-1 if not a reallocation)
+          int is_free - 'boolean' flag, call is a free
+*/
+static void count_call(int site, long bytes, long delta, long copied, int is_free) {
+    AllocCounters *counters[3];
+    int i;
+
+    counters[0] = &site_counters[site];
+    counters[1] = &phase_counters[get_allocation_phase()];
+    counters[2] = &total_counters;
+
+    pthread_mutex_lock(&counters_lock);
+
+    for (i = 0; i < 3; i++) {
+        if (is_free)
+            counters[i]->frees++;
+        else if (copied < 0)
+            counters[i]->allocations++;
+        else
+            counters[i]->reallocations++;
+
+        if (copied > 0) {
+            counters[i]->copies++;
+            counters[i]->copied_bytes += copied;
+        }
+        counters[i]->bytes += bytes;
+
+        /* Phase peaks aren't meaningful, memory outlives the phase allocating it */
+        if (i != 1)
+            update_live_bytes(counters[i], delta);
+    }
+    pthread_mutex_unlock(&counters_lock);
+}
+
+/*
+Function to print one row of the allocation report.
+Receives: const char *name - Row name
+          const AllocCounters *counters - Counters of row
+          int with_peak - 'boolean' flag, also print live & peak bytes
+*/
+static void print_counters(const char *name, const AllocCounters *counters, int with_peak) {
+    print_message("  %-15s allocs %ld, reallocs %ld, frees %ld, bytes %ld, copies %ld (%ld bytes)",
+                  name, counters->allocations, counters->reallocations, counters->frees,
+                  counters->bytes, counters->copies, counters->copied_bytes);
+
+    if (with_peak)
+        print_message(", live %ld, peak %ld", counters->live_bytes, counters->peak_bytes);
+
+    print_message("%c", NEWLINE);
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to allocate a counted block (see ALLOC / ALLOC_ZEROED).
+Receives: size_t size - Bytes to allocate
+          int site - Allocation site (ALLOC_SITE_*)
+          int zeroed - 'boolean' flag, clear the block like calloc()
+Returns: void* - Allocated block, NULL on memory error
+*/
+void *tracked_alloc(size_t size, int site, int zeroed) {
+    AllocHeader *header = malloc(sizeof(AllocHeader) + size);
+
+    if (!header)
+        return NULL;
+
+    if (zeroed)
+        memset(header + 1, 0, size);
+
+    header->info.size = size;
+    header->info.site = site;
+    count_call(site, (long)size, (long)size, -1, FALSE);
+
+    return header + 1;
+}
+
+/*
+Function to resize a counted block (see REALLOC), counting whether it was moved.
+Receives: void *ptr - Block to resize (NULL allocates a new block)
+          size_t size - New size in bytes
+          int site - Allocation site (ALLOC_SITE_*)
+Returns: void* - Resized block, NULL on memory error (ptr is kept)
+*/
+void *tracked_realloc(void *ptr, size_t size, int site) {
+    AllocHeader *header, *new_header;
+    size_t old_size;
+
+    if (!ptr)
+        return tracked_alloc(size, site, FALSE);
+
+    header = (AllocHeader*)ptr - 1;
+    old_size = header->info.size;
+    new_header = realloc(header, sizeof(AllocHeader) + size);
+
+    if (!new_header)
+        return NULL;
+
+    new_header->info.size = size;
+    count_call(new_header->info.site, (long)size, (long)size - (long)old_size,
+               (new_header != header) ? (long)((old_size < size) ? old_size : size) : 0, FALSE);
+
+    return new_header + 1;
+}
+
+/*
+Function to free a counted block (see FREE).
+Receives: void *ptr - Block to free (NULL is ignored)
+*/
+void tracked_free(void *ptr) {
+    AllocHeader *header;
+
+    if (!ptr)
+        return;
+
+    header = (AllocHeader*)ptr - 1;
+    count_call(header->info.site, 0, -(long)header->info.size, -1, TRUE);
+    free(header);
+}
+
+/*
+Function to set the phase that allocations of the calling thread are charged to.
+Receives: int phase - PHASE_* of a file, or ALLOC_PHASE_SETUP
+*/
+void set_allocation_phase(int phase) {
+    pthread_once(&phase_key_once, create_phase_key);
+
+    if (phase_key_created)
+        pthread_setspecific(phase_key, &phase_ids[phase]);
+}
+
+/*
+Function to print the allocation counters per table, per phase & in total (see PRINT_ALLOCATION_REPORT).
+*/
+void print_allocation_report(void) {
+    int i;
+
+    print_message("%c--- Allocations per table ---%c", NEWLINE, NEWLINE);
+
+    for (i = 0; i < ALLOC_SITE_COUNT; i++) {
+        print_counters(site_names[i], &site_counters[i], TRUE);
+    }
+    print_message("%c--- Allocations per phase ---%c", NEWLINE, NEWLINE);
+
+    for (i = 0; i < ALLOC_PHASE_COUNT; i++) {
+        print_counters(phase_names[i], &phase_counters[i], FALSE);
+    }
+    print_message("%c--- Allocations total ---%c", NEWLINE, NEWLINE);
+    print_counters("all", &total_counters, TRUE);
+}
\ No newline at end of file
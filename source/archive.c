@@ -0,0 +1,515 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "binary_object.h"
+#include "archive.h"
+#include "alloc_tracking.h"
+
+/* Member of an archive being built */
+typedef struct {
+    const char *name;            /* member name (kept by caller) */
+    unsigned long name_offset;   /* offset of name in strings */
+    size_t offset;               /* start of binary object in ArchiveBuilder.objects */
+    size_t length;
+} ArchiveMember;
+
+/* Archive being built: its members, their entry symbol index & strings */
+typedef struct {
+    ArchiveMember *members;
+    int member_count;
+    SourceBuffer objects;        /* binary objects of all members, back to back */
+    SourceBuffer strings;        /* member names, followed by symbol names */
+    SourceBuffer output;         /* object file being read, then the rendered archive */
+    unsigned long *slots;        /* 2 values per index slot: symbol name offset & member */
+    unsigned long slot_count;
+    unsigned long symbol_count;
+} ArchiveBuilder;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to report an archive error about a symbol of a member.
+Receives: const char *message - Error message
+          const char *member - Member name
+          const char *name - Symbol name (NULL if unknown)
+*/
+static void print_archive_error(const char *message, const char *member, const char *name) {
+    char context[MAX_ARCHIVE_CONTEXT_LENGTH];
+
+    sprintf(context, "%.*s in %.*s", MAX_LABEL_NAME_LENGTH - 1, name ? name : "?",
+            MAX_FILENAME_LENGTH - MAX_EXTENSION_LENGTH, member);
+    print_error(message, context);
+}
+
+/*
+Function to build <base_filename><extension>.
+Receives: const char *base_filename - Filename without extension
+          const char *extension - File extension
+          char *filename - Output buffer (MAX_FILENAME_LENGTH size)
+Returns: int - TRUE if built, FALSE if too long
+*/
+static int build_archive_filename(const char *base_filename, const char *extension, char *filename) {
+    if (strlen(base_filename) + strlen(extension) >= MAX_FILENAME_LENGTH) {
+        print_error("Filename is too long", base_filename);
+        return FALSE;
+    }
+    sprintf(filename, "%s%s", base_filename, extension);
+    return TRUE;
+}
+
+/*
+Function to round an offset up to the archive alignment.
+Receives: unsigned long offset - Offset to align
+Returns: unsigned long - Aligned offset
+*/
+static unsigned long align_archive_offset(unsigned long offset) {
+    return (offset + ARCHIVE_ALIGNMENT - 1) & ~(unsigned long)(ARCHIVE_ALIGNMENT - 1);
+}
+
+/*
+Function to initialize an archive builder for a number of members.
+Receives: ArchiveBuilder *builder - Builder to initialize
+          int object_count - Number of members
+Returns: int - TRUE if initialized, FALSE on memory error
+*/
+static int init_archive_builder(ArchiveBuilder *builder, int object_count) {
+    builder->member_count = 0;
+    builder->slots = NULL;
+    builder->slot_count = 0;
+    builder->symbol_count = 0;
+    builder->members = ALLOC(object_count * sizeof(ArchiveMember), ALLOC_SITE_OTHER);
+
+    if (!builder->members) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to build archive");
+        return FALSE;
+    }
+    if (!init_source_buffer(&builder->objects)) {
+        FREE(builder->members);
+        return FALSE;
+    }
+    if (!init_source_buffer(&builder->strings)) {
+        FREE(builder->members);
+        free_source_buffer(&builder->objects);
+        return FALSE;
+    }
+    if (!init_source_buffer(&builder->output)) {
+        FREE(builder->members);
+        free_source_buffer(&builder->objects);
+        free_source_buffer(&builder->strings);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to free all resources held by an archive builder.
+Receives: ArchiveBuilder *builder - Builder to free
+*/
+static void free_archive_builder(ArchiveBuilder *builder) {
+    FREE(builder->members);
+    FREE(builder->slots);
+    free_source_buffer(&builder->objects);
+    free_source_buffer(&builder->strings);
+    free_source_buffer(&builder->output);
+}
+
+/*
+Function to read the binary object files (<name>.bin) of all members into the builder,
+with the member names as the first strings of the archive.
+Receives: ArchiveBuilder *builder - Initialized builder
+          char *objects[] - Base filenames of objects, without extension
+          int object_count - Number of objects
+Returns: int - TRUE if all objects were read, FALSE if any is missing / invalid (all are reported)
+*/
+static int load_archive_members(ArchiveBuilder *builder, char *objects[], int object_count) {
+    char filename[MAX_FILENAME_LENGTH];
+    ArchiveMember *member;
+    int i, result = TRUE;
+
+    for (i = 0; i < object_count; i++) {
+        if (!build_archive_filename(objects[i], FILE_EXT_BINARY, filename)) {
+            result = FALSE;
+            continue;
+        }
+        if (!read_input_file(&builder->output, filename)) {
+            print_error("File not found", filename);
+            result = FALSE;
+            continue;
+        }
+        if (!check_binary_object((const unsigned char *)builder->output.text, builder->output.length)) {
+            print_error("Invalid binary object", filename);
+            result = FALSE;
+            continue;
+        }
+        member = &builder->members[builder->member_count++];
+        member->name = objects[i];
+        member->name_offset = builder->strings.length;
+        member->offset = builder->objects.length;
+        member->length = builder->output.length;
+        builder->symbol_count += BINARY_U32((const unsigned char *)builder->output.text, BINARY_ENTRIES_FIELD + 4);
+
+        if (!append_source_span(&builder->strings, objects[i], strlen(objects[i]) + 1) ||
+            !append_source_span(&builder->objects, builder->output.text, builder->output.length))
+            return FALSE;
+    }
+    return result;
+}
+
+/*
+Function to insert an entry symbol into the index, probing linearly from its hash.
+Receives: ArchiveBuilder *builder - Builder with allocated index
+          const char *name - Symbol name
+          int member - Index of member defining the symbol
+Returns: int - TRUE if inserted, FALSE on duplicate symbol / memory error
+*/
+static int insert_archive_symbol(ArchiveBuilder *builder, const char *name, int member) {
+    unsigned long mask = builder->slot_count - 1;
+    unsigned long slot = hash_string(name) & mask;
+
+    while (builder->slots[2 * slot] != ARCHIVE_EMPTY_SLOT) {
+        if (strcmp(builder->strings.text + builder->slots[2 * slot], name) == 0) {
+            print_archive_error("Entry symbol defined by more than one member", builder->members[member].name, name);
+            return FALSE;
+        }
+        slot = (slot + 1) & mask;
+    }
+    builder->slots[2 * slot] = builder->strings.length;
+    builder->slots[2 * slot + 1] = (unsigned long)member;
+
+    return append_source_span(&builder->strings, name, strlen(name) + 1);
+}
+
+/*
+Function to build the symbol index of the archive from the entry records of all members.
+The slot count is the smallest power of 2 keeping the index at most half full.
+Receives: ArchiveBuilder *builder - Builder holding all members
+Returns: int - TRUE if all entries were indexed, FALSE on invalid / duplicate entry (all are reported)
+*/
+static int build_archive_index(ArchiveBuilder *builder) {
+    const unsigned char *object;
+    const char *name;
+    unsigned long i, record, count;
+    int member, result = TRUE;
+
+    builder->slot_count = 1;
+
+    while (builder->slot_count < 2 * builder->symbol_count) {
+        builder->slot_count *= 2;
+    }
+    builder->slots = ALLOC(2 * builder->slot_count * sizeof(unsigned long), ALLOC_SITE_OTHER);
+
+    if (!builder->slots) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to build archive index");
+        return FALSE;
+    }
+    for (i = 0; i < builder->slot_count; i++) {
+        builder->slots[2 * i] = ARCHIVE_EMPTY_SLOT;
+        builder->slots[2 * i + 1] = 0;
+    }
+    for (member = 0; member < builder->member_count; member++) {
+        object = (const unsigned char *)builder->objects.text + builder->members[member].offset;
+        record = BINARY_U32(object, BINARY_ENTRIES_FIELD);
+        count = BINARY_U32(object, BINARY_ENTRIES_FIELD + 4);
+
+        for (i = 0; i < count; i++, record += BINARY_RECORD_SIZE) {
+            name = get_binary_record_name(object, record);
+
+            if (!name) {
+                print_archive_error("Invalid entry record", builder->members[member].name, NULL);
+                result = FALSE;
+            }
+            else if (!insert_archive_symbol(builder, name, member))
+                result = FALSE;
+        }
+    }
+    return result;
+}
+
+/*
+Function to render the archive: header, member table, symbol index, strings & member data.
+Receives: ArchiveBuilder *builder - Builder holding all members & the index
+Returns: int - TRUE if rendered, FALSE on memory error
+*/
+static int render_archive(ArchiveBuilder *builder) {
+    SourceBuffer *output = &builder->output;
+    unsigned long index_offset, strings_offset, data_offset;
+    const ArchiveMember *member;
+    int i, result;
+
+    index_offset = ARCHIVE_HEADER_SIZE + (unsigned long)builder->member_count * ARCHIVE_MEMBER_SIZE;
+    strings_offset = index_offset + builder->slot_count * ARCHIVE_SLOT_SIZE;
+    data_offset = align_archive_offset(strings_offset + builder->strings.length);
+
+    reset_source_buffer(output);
+
+    result = append_source_span(output, ARCHIVE_MAGIC, ARCHIVE_MAGIC_LENGTH) &&
+             append_binary_u16(output, ARCHIVE_VERSION) &&
+             append_binary_u16(output, 0) &&
+             append_binary_u32(output, ARCHIVE_HEADER_SIZE) &&
+             append_binary_u32(output, (unsigned long)builder->member_count) &&
+             append_binary_u32(output, index_offset) &&
+             append_binary_u32(output, builder->slot_count) &&
+             append_binary_u32(output, strings_offset) &&
+             append_binary_u32(output, builder->strings.length);
+
+    for (i = 0; result && (i < builder->member_count); i++) {
+        member = &builder->members[i];
+        result = append_binary_u32(output, member->name_offset) &&
+                 append_binary_u32(output, data_offset) &&
+                 append_binary_u32(output, member->length);
+
+        data_offset = align_archive_offset(data_offset + member->length);
+    }
+    for (i = 0; result && ((unsigned long)i < builder->slot_count); i++) {
+        result = append_binary_u32(output, builder->slots[2 * i]) &&
+                 append_binary_u32(output, builder->slots[2 * i + 1]);
+    }
+    result = result && append_source_span(output, builder->strings.text, builder->strings.length) &&
+             append_binary_padding(output);
+
+    for (i = 0; result && (i < builder->member_count); i++) {
+        member = &builder->members[i];
+        result = append_source_span(output, builder->objects.text + member->offset, member->length) &&
+                 append_binary_padding(output);
+    }
+    return result;
+}
+
+/*
+Function to get a null terminated string of an open archive.
+Receives: const Archive *archive - Archive with its directory read
+          unsigned long offset - Offset of string in strings
+Returns: const char* - String, NULL if offset is not a valid string
+*/
+static const char *get_archive_string(const Archive *archive, unsigned long offset) {
+    const char *strings = archive->directory.text + archive->strings_offset;
+
+    if ((offset >= archive->strings_length) || !memchr(strings + offset, NULL_TERMINATOR, archive->strings_length - offset))
+        return NULL;
+
+    return strings + offset;
+}
+
+/*
+Function to check that a table of the directory lies within it.
+Receives: const Archive *archive - Archive with its directory read
+          unsigned long offset - Table offset
+          unsigned long count - Number of records
+          unsigned long record_size - Size of each record
+Returns: int - TRUE if table is aligned & within the directory, FALSE otherwise
+*/
+static int check_archive_table(const Archive *archive, unsigned long offset, unsigned long count, unsigned long record_size) {
+    return ((offset % ARCHIVE_ALIGNMENT) == 0) && (offset >= ARCHIVE_HEADER_SIZE) &&
+           (offset <= archive->directory.length) && (count <= (archive->directory.length - offset) / record_size);
+}
+
+/*
+Function to validate the directory of an opened archive, so lookups can use it in place:
+tables within the directory, a power of 2 index, valid names, and member data within the file.
+Receives: const Archive *archive - Archive with its directory read
+Returns: int - TRUE if directory is valid, FALSE otherwise
+*/
+static int check_archive_directory(const Archive *archive) {
+    const unsigned char *directory = ARCHIVE_DIRECTORY(archive);
+    unsigned long i, record, name, data, length;
+
+    if (!check_archive_table(archive, archive->members_offset, archive->member_count, ARCHIVE_MEMBER_SIZE) ||
+        !check_archive_table(archive, archive->index_offset, archive->slot_count, ARCHIVE_SLOT_SIZE) ||
+        (archive->slot_count == 0) || ((archive->slot_count & (archive->slot_count - 1)) != 0))
+        return FALSE;
+
+    for (i = 0, record = archive->members_offset; i < archive->member_count; i++, record += ARCHIVE_MEMBER_SIZE) {
+        data = BINARY_U32(directory, record + ARCHIVE_MEMBER_DATA);
+        length = BINARY_U32(directory, record + ARCHIVE_MEMBER_LENGTH);
+
+        if (!get_archive_string(archive, BINARY_U32(directory, record + ARCHIVE_MEMBER_NAME)) ||
+            (data > (unsigned long)archive->file_size) || (length > (unsigned long)archive->file_size - data))
+            return FALSE;
+    }
+    for (i = 0, record = archive->index_offset; i < archive->slot_count; i++, record += ARCHIVE_SLOT_SIZE) {
+        name = BINARY_U32(directory, record + ARCHIVE_SLOT_NAME);
+
+        if ((name != ARCHIVE_EMPTY_SLOT) &&
+            (!get_archive_string(archive, name) || (BINARY_U32(directory, record + ARCHIVE_SLOT_MEMBER) >= archive->member_count)))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to read & validate the directory of an archive: its header first, then up to the end of its strings.
+Receives: Archive *archive - Archive with an open file
+Returns: int - TRUE if directory was read and is valid, FALSE otherwise
+*/
+static int read_archive_directory(Archive *archive) {
+    const unsigned char *header;
+
+    if ((fseek(archive->fp, 0, SEEK_END) != 0) || ((archive->file_size = ftell(archive->fp)) < ARCHIVE_HEADER_SIZE))
+        return FALSE;
+
+    rewind(archive->fp);
+
+    if (!read_source_span(&archive->directory, archive->fp, ARCHIVE_HEADER_SIZE))
+        return FALSE;
+
+    header = ARCHIVE_DIRECTORY(archive);
+
+    if ((memcmp(header, ARCHIVE_MAGIC, ARCHIVE_MAGIC_LENGTH) != 0) ||
+        (BINARY_U16(header, ARCHIVE_VERSION_FIELD) != ARCHIVE_VERSION))
+        return FALSE;
+
+    archive->members_offset = BINARY_U32(header, ARCHIVE_MEMBERS_FIELD);
+    archive->member_count = BINARY_U32(header, ARCHIVE_MEMBERS_FIELD + 4);
+    archive->index_offset = BINARY_U32(header, ARCHIVE_INDEX_FIELD);
+    archive->slot_count = BINARY_U32(header, ARCHIVE_INDEX_FIELD + 4);
+    archive->strings_offset = BINARY_U32(header, ARCHIVE_STRINGS_FIELD);
+    archive->strings_length = BINARY_U32(header, ARCHIVE_STRINGS_FIELD + 4);
+
+    if ((archive->strings_offset < ARCHIVE_HEADER_SIZE) || (archive->strings_offset > (unsigned long)archive->file_size) ||
+        (archive->strings_length > (unsigned long)archive->file_size - archive->strings_offset))
+        return FALSE;
+
+    rewind(archive->fp);
+
+    return read_source_span(&archive->directory, archive->fp, archive->strings_offset + archive->strings_length) &&
+           check_archive_directory(archive);
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to bundle binary objects (<name>.bin) into an archive file (<base_filename>.lib),
+indexing the entry symbols of all members. See archive.h for the layout.
+Receives: const char *base_filename - Archive filename without extension
+          char *objects[] - Base filenames of member objects, without extension
+          int object_count - Number of objects
+Returns: int - TRUE if archive was written, FALSE on any error (all errors are reported)
+*/
+int write_archive(const char *base_filename, char *objects[], int object_count) {
+    char filename[MAX_FILENAME_LENGTH];
+    ArchiveBuilder builder;
+    int result;
+
+    if (!build_archive_filename(base_filename, FILE_EXT_ARCHIVE, filename) ||
+        !init_archive_builder(&builder, object_count))
+        return FALSE;
+
+    result = load_archive_members(&builder, objects, object_count) &&
+             build_archive_index(&builder) &&
+             render_archive(&builder) &&
+             write_output_file(filename, builder.output.text, builder.output.length);
+
+    free_archive_builder(&builder);
+    return result;
+}
+
+/*
+Function to open an archive file (<base_filename>.lib) for linking.
+Only the directory (header, member table, symbol index & strings) is read, members are read on demand.
+Receives: Archive *archive - Archive to open
+          const char *base_filename - Archive filename without extension (kept by caller until closed)
+Returns: int - TRUE if opened, FALSE if missing / invalid (nothing is kept open)
+*/
+int open_archive(Archive *archive, const char *base_filename) {
+    char filename[MAX_FILENAME_LENGTH];
+
+    archive->fp = NULL;
+    archive->filename = base_filename;
+    archive->loaded = NULL;
+
+    if (!build_archive_filename(base_filename, FILE_EXT_ARCHIVE, filename) ||
+        !init_source_buffer(&archive->directory))
+        return FALSE;
+
+    archive->fp = open_source_file(filename);
+
+    if (!archive->fp) {
+        close_archive(archive);
+        return FALSE;
+    }
+    if (!read_archive_directory(archive)) {
+        print_error("Invalid archive", filename);
+        close_archive(archive);
+        return FALSE;
+    }
+    archive->loaded = ALLOC(archive->member_count + 1, ALLOC_SITE_OTHER);
+
+    if (!archive->loaded) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to open archive");
+        close_archive(archive);
+        return FALSE;
+    }
+    memset(archive->loaded, FALSE, archive->member_count + 1);
+    return TRUE;
+}
+
+/*
+Function to close an opened archive, freeing all its resources.
+Receives: Archive *archive - Archive to close
+*/
+void close_archive(Archive *archive) {
+    safe_fclose(&archive->fp);
+    free_source_buffer(&archive->directory);
+    FREE(archive->loaded);
+    archive->loaded = NULL;
+}
+
+/*
+Function to find the member defining an entry symbol, by the hashed index of the archive.
+Receives: const Archive *archive - Opened archive
+          const char *name - Symbol name
+Returns: long - Index of member, -1 if no member defines the symbol
+*/
+long find_archive_symbol(const Archive *archive, const char *name) {
+    const unsigned char *directory = ARCHIVE_DIRECTORY(archive);
+    unsigned long mask = archive->slot_count - 1;
+    unsigned long probes, record, slot_name, slot = hash_string(name) & mask;
+
+    for (probes = 0; probes < archive->slot_count; probes++, slot = (slot + 1) & mask) {
+        record = archive->index_offset + slot * ARCHIVE_SLOT_SIZE;
+        slot_name = BINARY_U32(directory, record + ARCHIVE_SLOT_NAME);
+
+        if (slot_name == ARCHIVE_EMPTY_SLOT)
+            return -1;
+
+        if (strcmp(get_archive_string(archive, slot_name), name) == 0)
+            return (long)BINARY_U32(directory, record + ARCHIVE_SLOT_MEMBER);
+    }
+    return -1;
+}
+
+/*
+Function to get the name of an archive member (its object base filename when archived).
+Receives: const Archive *archive - Opened archive
+          unsigned long member - Index of member
+Returns: const char* - Member name, valid until the archive is closed
+*/
+const char *get_archive_member_name(const Archive *archive, unsigned long member) {
+    unsigned long record = archive->members_offset + member * ARCHIVE_MEMBER_SIZE;
+
+    return get_archive_string(archive, BINARY_U32(ARCHIVE_DIRECTORY(archive), record + ARCHIVE_MEMBER_NAME));
+}
+
+/*
+Function to read the binary object of an archive member, with a single seek & read.
+Receives: Archive *archive - Opened archive
+          unsigned long member - Index of member
+          SourceBuffer *buffer - Buffer receiving the object (emptied first)
+Returns: int - TRUE if read, FALSE otherwise
+*/
+int read_archive_member(Archive *archive, unsigned long member, SourceBuffer *buffer) {
+    const unsigned char *directory = ARCHIVE_DIRECTORY(archive);
+    unsigned long record = archive->members_offset + member * ARCHIVE_MEMBER_SIZE;
+
+    if ((fseek(archive->fp, (long)BINARY_U32(directory, record + ARCHIVE_MEMBER_DATA), SEEK_SET) != 0) ||
+        !read_source_span(buffer, archive->fp, BINARY_U32(directory, record + ARCHIVE_MEMBER_LENGTH))) {
+        print_error("Failed to read archive member", get_archive_member_name(archive, member));
+        return FALSE;
+    }
+    return TRUE;
+}
\ No newline at end of file
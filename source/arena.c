@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "arena.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to allocate a new, empty arena block.
+Receives: size_t capacity - Usable bytes of the block
+Returns: ArenaBlock* - Pointer to new block, NULL on memory error
+*/
+static ArenaBlock *create_block(size_t capacity) {
+    ArenaBlock *block = ALLOC(ARENA_ALIGN(sizeof(ArenaBlock)) + capacity, ALLOC_SITE_ARENAS);
+
+    if (!block) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to allocate arena block");
+        return NULL;
+    }
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+
+    return block;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to initialize an arena, with its first block.
+Receives: Arena *arena - Pointer to arena structure to initialize
+          size_t block_size - Default capacity of arena blocks
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+int init_arena(Arena *arena, size_t block_size) {
+    arena->block_size = block_size;
+    arena->first = create_block(block_size);
+    arena->current = arena->first;
+
+    return (arena->first != NULL);
+}
+
+/*
+Function to free all blocks of the arena.
+Receives: Arena *arena - Arena to deallocate
+*/
+void free_arena(Arena *arena) {
+    ArenaBlock *block = arena->first, *next;
+
+    while (block) {
+        next = block->next;
+        FREE(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+/*
+Function to release all arena allocations at once, keeping its blocks for reuse.
+Receives: Arena *arena - Arena to reset
+*/
+void reset_arena(Arena *arena) {
+    arena->current = arena->first;
+
+    if (arena->current)
+        arena->current->used = 0;
+}
+
+/*
+Function to bump-allocate aligned memory from the arena.
+Moves to the next kept block (or chains a new one) when the current block is full.
+Receives: Arena *arena - Arena to allocate from
+          size_t size - Amount of bytes requested
+Returns: void* - Pointer to allocated memory, NULL on memory error
+*/
+void *arena_alloc(Arena *arena, size_t size) {
+    ArenaBlock *block;
+    void *memory;
+
+    size = ARENA_ALIGN(size);
+
+    if (!arena->current)
+        return NULL;
+
+    while (arena->current->used + size > arena->current->capacity) {
+        if (!arena->current->next) {
+            block = create_block((size > arena->block_size) ? size : arena->block_size);
+
+            if (!block)
+                return NULL;
+
+            arena->current->next = block;
+        }
+        arena->current = arena->current->next;
+        arena->current->used = 0;
+    }
+    memory = BLOCK_DATA(arena->current) + arena->current->used;
+    arena->current->used += size;
+
+    return memory;
+}
+
+/*
+Function to create a null terminated copy of a string span inside the arena.
+Receives: Arena *arena - Arena to allocate from
+          const char *src - Start of span to be copied
+          size_t length - Amount of chars to copy
+Returns: char* - Arena copy of the span, NULL on memory error
+*/
+char *arena_copy_span(Arena *arena, const char *src, size_t length) {
+    char *copy = arena_alloc(arena, length + 1);
+
+    if (copy) {
+        memcpy(copy, src, length);
+        copy[length] = NULL_TERMINATOR;
+    }
+    return copy;
+}
+
+/*
+Function to create a copy of a string inside the arena.
+Receives: Arena *arena - Arena to allocate from
+          const char *src - Source string to be copied
+Returns: char* - Arena copy of the string, NULL on memory error
+*/
+char *arena_copy_string(Arena *arena, const char *src) {
+    return arena_copy_span(arena, src, strlen(src));
+}
\ No newline at end of file
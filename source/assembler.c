@@ -7,122 +7,385 @@
 #include "memory.h"
 #include "symbol_table.h"
 #include "macro_table.h"
+#include "source_buffer.h"
+#include "fixup_table.h"
+#include "statement.h"
+#include "arena.h"
+#include "options.h"
 #include "file_io.h"
+#include "diagnostics.h"
+#include "scheduler.h"
+#include "stats.h"
+#include "cache.h"
+#include "server.h"
+#include "alloc_tracking.h"
 
 /* Inner STATIC methods */
 /* ==================================================================== */
 /*
 Function to construct full filenames by combining base name with standard extensions.
-Generates filenames for: input (.as), preprocessed (.am), object (.ob), entry (.ent), and external (.ext) files
-Receives: const char* base_filename - Base filename without extension
+Generates filenames for: input (.as), preprocessed (.am), object (.ob), entry (.ent), external (.ext),
+relocation (.rel) and binary object (.bin) files
+Receives: const char* base_filename - Base filename without extension (length checked by parse_options)
           char* input_file - Output buffer for input filename
           char* am_file - Output buffer for preprocessed filename
           char* obj_file - Output buffer for object filename
           char* ent_file - Output buffer for entry filename
           char* ext_file - Output buffer for externals filename
+          char* rel_file - Output buffer for relocations filename
+          char* bin_file - Output buffer for binary object filename
 Returns: void
 */
-static void build_files(const char* base_filename, char* input_file, char* am_file, char* obj_file, char* ent_file, char* ext_file) {
+static void build_files(const char* base_filename, char* input_file, char* am_file, char* obj_file, char* ent_file, char* ext_file, char* rel_file, char* bin_file) {
     sprintf(input_file, "%s%s", base_filename, FILE_EXT_INPUT);
     sprintf(am_file, "%s%s", base_filename, FILE_EXT_PREPROC);
     sprintf(obj_file, "%s%s", base_filename, FILE_EXT_OBJECT);
     sprintf(ent_file, "%s%s", base_filename, FILE_EXT_ENTRY);
     sprintf(ext_file, "%s%s", base_filename, FILE_EXT_EXTERN);
+    sprintf(rel_file, "%s%s", base_filename, FILE_EXT_RELOC);
+    sprintf(bin_file, "%s%s", base_filename, FILE_EXT_BINARY);
+}
+
+/*
+Function to list the files a cache entry restores to, or was stored from, indexed by CACHE_SECTION_*.
+Receives: const char *outputs[] - Output array (CACHE_SECTION_COUNT size)
+          const char* am_file - Name of the .am file (NULL if not written)
+          const char* obj_file - Name of the .ob file
+          const char* ent_file - Name of the .ent file (NULL if not written)
+          const char* ext_file - Name of the .ext file (NULL if not written)
+          const char* rel_file - Name of the .rel file (NULL if not written)
+          const char* bin_file - Name of the .bin file (NULL if not written)
+*/
+static void set_cache_outputs(const char *outputs[], const char* am_file, const char* obj_file, const char* ent_file, const char* ext_file, const char* rel_file, const char* bin_file) {
+    outputs[CACHE_SECTION_LOG] = NULL;
+    outputs[CACHE_SECTION_AM] = am_file;
+    outputs[CACHE_SECTION_OBJECT] = obj_file;
+    outputs[CACHE_SECTION_ENTRY] = ent_file;
+    outputs[CACHE_SECTION_EXTERN] = ext_file;
+    outputs[CACHE_SECTION_RELOC] = rel_file;
+    outputs[CACHE_SECTION_BINARY] = bin_file;
+}
+
+/*
+Function to run the assembler stages on an already read source buffer,
+charging the time of each stage to the file statistics:
+- Preprocessing (macro expansion into memory)
+- Optional .am file writing (--keep-am)
+- First pass (statement table, symbol table creation & encoding)
+- Second pass (statement walk & fixups patching)
+- Output files writing (.rel only with --reloc, .bin only with --binary)
+Receives: const AssemblerOptions *options - Command line options
+          const char* input_file - Name of the .as file
+          const char* am_file - Name of the .am file
+          const char* obj_file - Name of the .ob file
+          const char* ent_file - Name of the .ent file
+          const char* ext_file - Name of the .ext file
+          const char* rel_file - Name of the .rel file
+          const char* bin_file - Name of the .bin file
+          FileTables *tables - Per-file tables, holding the source
+Returns: int - TRUE if all stages succeeded, FALSE on any error
+*/
+static int assemble_source(const AssemblerOptions *options, const char* input_file, const char* am_file, const char* obj_file, const char* ent_file, const char* ext_file, const char* rel_file, const char* bin_file, FileTables *tables) {
+    Timestamp start;
+
+    get_timestamp(&start);
+    SET_ALLOCATION_PHASE(PHASE_PREPROCESS);
+
+    if (preprocess_macros(&tables->as_source, &tables->am_source, &tables->macrotab) == PASS_ERROR) {
+        add_phase_time(&tables->stats, PHASE_PREPROCESS, &start);
+        print_message("%cPreprocessing failed for %s%c", NEWLINE, input_file, NEWLINE);
+        return FALSE;
+    }
+    add_phase_time(&tables->stats, PHASE_PREPROCESS, &start);
+    SET_ALLOCATION_PHASE(PHASE_OUTPUT);
+
+    if (options->keep_am && !write_source_file(&tables->am_source, am_file)) {
+        add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+        return FALSE;
+    }
+
+    add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+    SET_ALLOCATION_PHASE(PHASE_FIRST_PASS);
+
+    if (first_pass(am_file, &tables->am_source, &tables->statements, &tables->symtab, &tables->memory, &tables->fixups, &tables->line_arena) == PASS_ERROR) {
+        add_phase_time(&tables->stats, PHASE_FIRST_PASS, &start);
+        print_message("%cFirst pass failed for %s%c", NEWLINE, am_file, NEWLINE);
+        return FALSE;
+    }
+    add_phase_time(&tables->stats, PHASE_FIRST_PASS, &start);
+    SET_ALLOCATION_PHASE(PHASE_SECOND_PASS);
+
+    if (second_pass(&tables->symtab, &tables->memory, &tables->statements, &tables->fixups) == PASS_ERROR) {
+        add_phase_time(&tables->stats, PHASE_SECOND_PASS, &start);
+        print_message("%cSecond pass failed for %s%c", NEWLINE, am_file, NEWLINE);
+        return FALSE;
+    }
+    add_phase_time(&tables->stats, PHASE_SECOND_PASS, &start);
+    SET_ALLOCATION_PHASE(PHASE_OUTPUT);
+
+    if (!write_output_files(&tables->symtab, &tables->memory, &tables->output, obj_file, ent_file, ext_file,
+                            options->write_relocations ? rel_file : NULL, options->write_binary ? bin_file : NULL)) {
+        add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+        print_message("%cFailed to write the output files of %s%c", NEWLINE, input_file, NEWLINE);
+        return FALSE;
+    }
+    add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+
+    return TRUE;
+}
+
+/*
+Function to assemble an already read source through the cache (--cache-dir).
+A hit restores the output files & messages of an earlier assembly of the same source, skipping all stages.
+On a miss the messages are captured while assembling, and a successful result is stored.
+Receives: const AssemblerOptions *options - Command line options
+          const char* input_file - Name of the .as file
+          const char* am_file - Name of the .am file
+          const char* obj_file - Name of the .ob file
+          const char* ent_file - Name of the .ent file
+          const char* ext_file - Name of the .ext file
+          const char* rel_file - Name of the .rel file
+          const char* bin_file - Name of the .bin file
+          const int file_number - Current file index (makes temporary cache files unique)
+          FileTables *tables - Per-file tables, holding the source
+Returns: int - TRUE if file was restored or assembled successfully, FALSE on any error
+*/
+static int assemble_cached_source(const AssemblerOptions *options, const char* input_file, const char* am_file, const char* obj_file, const char* ent_file, const char* ext_file, const char* rel_file, const char* bin_file, const int file_number, FileTables *tables) {
+    char cache_key[CACHE_KEY_LENGTH];
+    const char *outputs[CACHE_SECTION_COUNT];
+    SourceBuffer *previous_log;
+    Timestamp start;
+    int result;
+
+    get_timestamp(&start);
+    build_cache_key(input_file, &tables->as_source, cache_key);
+    set_cache_outputs(outputs, options->keep_am ? am_file : NULL, obj_file, ent_file, ext_file,
+                      options->write_relocations ? rel_file : NULL, options->write_binary ? bin_file : NULL);
+
+    if (restore_cache_entry(options->cache_dir, cache_key, outputs, &tables->cache_entry)) {
+        tables->stats.cache_hits = 1;
+        add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+        return TRUE;
+    }
+    tables->stats.cache_misses = 1;
+    add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+
+    previous_log = get_diagnostic_log();
+    set_diagnostic_log(&tables->log);
+    result = assemble_source(options, input_file, am_file, obj_file, ent_file, ext_file, rel_file, bin_file, tables);
+    set_diagnostic_log(previous_log);
+    print_text(tables->log.text, tables->log.length);
+
+    /* The entry is read back from the output files, so it is stored only when all of them were written */
+    if (result) {
+        get_timestamp(&start);
+        set_cache_outputs(outputs, options->keep_am ? am_file : NULL, obj_file,
+                          has_entries(&tables->symtab) ? ent_file : NULL,
+                          has_externs(&tables->symtab) ? ext_file : NULL,
+                          options->write_relocations ? rel_file : NULL, options->write_binary ? bin_file : NULL);
+        store_cache_entry(options->cache_dir, cache_key, file_number, outputs, &tables->log, &tables->cache_entry, &tables->output);
+        add_phase_time(&tables->stats, PHASE_OUTPUT, &start);
+    }
+    return result;
 }
 
 /*
 Function to process a single .as file through the complete assembler pipeline:
-- Preprocessing (macro expansion)
-- First pass (symbol table creation)
-- Second pass (code encoding & output)
-Receives: const char* base_filename - Base filename without extension
+- Reading the source into memory
+- Preprocessing (macro expansion into memory)
+- First pass (symbol table creation & encoding)
+- Second pass (fixups patching & output)
+Receives: const AssemblerOptions *options - Command line options
+          const char* base_filename - Base filename without extension
           const int file_number - Current file index (for progress display)
           const int total_files - Total files to process
-          SymbolTable *symtab - Pointer to symbol table
-          MemoryImage *memory - Pointer to memory image
-          MacroTable *macrotab - Pointer to macro table
+          FileTables *tables - Per-file tables (already reset)
 Returns: int - TRUE if file processed successfully, FALSE on any error
 */
-static int process_input_file(const char* base_filename, const int file_number, const int total_files, SymbolTable *symtab, MemoryImage *memory, MacroTable *macrotab) {
+static int process_input_file(const AssemblerOptions *options, const char* base_filename, const int file_number, const int total_files, FileTables *tables) {
     char input_file[MAX_FILENAME_LENGTH];
     char am_file[MAX_FILENAME_LENGTH];
     char obj_file[MAX_FILENAME_LENGTH], ent_file[MAX_FILENAME_LENGTH], ext_file[MAX_FILENAME_LENGTH];
-    FILE *test_file;
+    char rel_file[MAX_FILENAME_LENGTH], bin_file[MAX_FILENAME_LENGTH];
+    Timestamp start;
+    int result;
 
-    printf("%cProcessing file %d of %d: %s%c", NEWLINE, file_number, total_files, base_filename, NEWLINE);
-    build_files(base_filename, input_file, am_file, obj_file, ent_file, ext_file);
+    print_message("%cProcessing file %d of %d: %s%c", NEWLINE, file_number, total_files, base_filename, NEWLINE);
+    build_files(base_filename, input_file, am_file, obj_file, ent_file, ext_file, rel_file, bin_file);
 
-    test_file = open_source_file(input_file);
+    get_timestamp(&start);
+    SET_ALLOCATION_PHASE(PHASE_PREPROCESS);
+    result = read_input_file(&tables->as_source, input_file);
+    add_phase_time(&tables->stats, PHASE_PREPROCESS, &start);
 
-    if (!test_file) {
+    if (!result) {
         print_error("File not found", input_file);
         return FALSE;
     }
-    safe_fclose(&test_file);
+    if (options->cache_dir)
+        return assemble_cached_source(options, input_file, am_file, obj_file, ent_file, ext_file, rel_file, bin_file, file_number, tables);
 
-    if (preprocess_macros(input_file, am_file, macrotab) == PASS_ERROR) {
-        printf("%cPreprocessing failed for %s%c", NEWLINE, input_file, NEWLINE);
-        return FALSE;
+    return assemble_source(options, input_file, am_file, obj_file, ent_file, ext_file, rel_file, bin_file, tables);
+}
+
+/*
+Function to record the sizes of a just assembled file into its statistics,
+and accumulate them into the totals of the tables.
+Receives: FileTables *tables - Per-file tables, after the file was assembled
+*/
+static void record_file_stats(FileTables *tables) {
+    FileStats *stats = &tables->stats;
+    int i;
+
+    stats->files = 1;
+    stats->lines = count_source_lines(&tables->as_source);
+    stats->words = tables->memory.ic + tables->memory.dc;
+    stats->symbols = tables->symtab.count;
+    stats->macros = tables->macrotab.count;
+
+    for (i = 0; i < tables->macrotab.count; i++) {
+        stats->macro_lines += tables->macrotab.macros[i].line_count;
     }
-    if (first_pass(am_file, symtab, memory) == PASS_ERROR) {
-        printf("%cFirst pass failed for %s%c", NEWLINE, am_file, NEWLINE);
-        return FALSE;
+    add_file_stats(&tables->totals, stats);
+}
+
+/*
+Function to assemble a single command line file, on tables reused from earlier files.
+Prints the file statistics when requested (--stats).
+Receives: const AssemblerOptions *options - Command line options
+          int file_index - Index of file in options->files
+          FileTables *tables - Per-file tables (reset before use)
+Returns: int - TRUE if file processed successfully, FALSE on any error
+*/
+static int assemble_file(const AssemblerOptions *options, int file_index, FileTables *tables) {
+    int result;
+
+    reset_file_tables(tables);
+
+    result = process_input_file(options, options->files[file_index], file_index + 1, options->file_count, tables);
+    SET_ALLOCATION_PHASE(ALLOC_PHASE_SETUP);
+    record_file_stats(tables);
+
+    if (options->stats)
+        print_file_stats(options->files[file_index], &tables->stats, 0);
+
+    return result;
+}
+
+/*
+Function to assemble all command line files one after another, on a single set of tables.
+Receives: const AssemblerOptions *options - Command line options
+          FileTables *tables - Tables reused for all files (warm across server requests)
+          FileStats *totals - Statistics accumulated over all files
+Returns: int - Number of files assembled successfully
+*/
+static int run_serial_jobs(const AssemblerOptions *options, FileTables *tables, FileStats *totals) {
+    int i, success_count = 0;
+
+    init_file_stats(&tables->totals);
+
+    for (i = 0; i < options->file_count; i++) {
+        if (assemble_file(options, i, tables))
+            success_count++;
     }
-    if (second_pass(am_file, symtab, memory, obj_file, ent_file, ext_file) == PASS_ERROR) {
-        printf("%cSecond pass failed for %s%c", NEWLINE, am_file, NEWLINE);
-        return FALSE;
+    add_file_stats(totals, &tables->totals);
+
+    return success_count;
+}
+
+/*
+Function to run the assembler on parsed command line options: process multiple assembly files
+through complete pipeline, one after another or on N worker threads, restoring unchanged
+files from the cache when one is given. Displays summary upon completion.
+Runs once per process, or once per request of the resident server (--serve).
+Receives: const AssemblerOptions *options - Parsed command line options
+          FileTables *tables - Tables used by serial runs (initialized by caller)
+Returns: int - Exit code, 0 if all files processed successfully, 1 otherwise
+*/
+static int run_assembler(const AssemblerOptions *options, FileTables *tables) {
+    int runtime_result, total_files, success_count, evicted_count = 0;
+    FileStats totals;
+    Timestamp start, end;
+
+    if (options->file_count < 1) {
+        print_error("Expected different app call", "./assembler [--keep-am] [--reloc] [--binary] [--stats] [-j N] [--cache-dir DIR [--cache-size KB]] <filename1> [filename2] ...");
+        return 1;
     }
-    return TRUE;
+    total_files = options->file_count;
+
+    if (options->cache_dir && !prepare_cache_directory(options->cache_dir))
+        return 1;
+
+    init_file_stats(&totals);
+    get_timestamp(&start);
+
+    if (options->jobs > 1)
+        success_count = run_parallel_jobs(options, assemble_file, &totals);
+    else
+        success_count = run_serial_jobs(options, tables, &totals);
+
+    get_timestamp(&end);
+
+    if (success_count < 0) {
+        print_error("Failed to initialize assembler tables", NULL);
+        return 1;
+    }
+    if (options->stats)
+        print_file_stats("all files", &totals, end.wall - start.wall);
+
+    if (options->cache_dir && (options->cache_size > 0))
+        evicted_count = evict_cache_entries(options->cache_dir, options->cache_size);
+
+    print_message("%c--- Summary ---%c", NEWLINE, NEWLINE);
+    print_message("Successfully processed: %d/%d files%c", success_count, total_files, NEWLINE);
+
+    if (options->cache_dir)
+        print_message("Cache: %ld hits, %ld misses, %d evicted%c", totals.cache_hits, totals.cache_misses, evicted_count, NEWLINE);
+
+    runtime_result = (success_count == total_files) ? 0 : 1;
+    print_message("%cAssembler completed with exit code %d!%c", NEWLINE, runtime_result, NEWLINE);
+
+    return runtime_result;
 }
 
 /* App main method */
 /* ==================================================================== */
 /*
 Main entry point to the assembler program.
-Processes multiple assembly files through complete pipeline.
-Manages initialization and cleanup of data structures.
-Displays summary upon completion.
+Parses command line flags (--keep-am, --reloc, --binary, --stats, -j N, --cache-dir DIR, --cache-size KB), then assembles
+the given files, or with --serve PATH stays resident and assembles the requests of clients.
+Per-file tables are initialized once (per worker), reset between files, and freed at the end.
 Receives: int argc - Number of command line arguments
           char *argv[] - Array of command line arguments
-                         (argv[1..n] are input filenames)
+                         (input filenames and flags)
 Returns: int - 0 if all files processed successfully, 1 otherwise
 */
 int main(int argc, char *argv[]) {
-    int i, runtime_result;
-    int success_count = 0, total_files = argc - 1;
+    int runtime_result;
+    AssemblerOptions options;
+    FileTables tables;
 
-    if (argc < 2) {
-        print_error("Expected different app call", "./assembler <filename1> [filename2] ...");
+    if (!parse_options(argc, argv, &options))
         return 1;
-    }
 
-    for (i = 1; i < argc; i++) {
-        SymbolTable symtab;
-        MemoryImage memory;
-        MacroTable macrotab;
-
-        init_memory(&memory);
-
-        if (!init_symbol_table(&symtab)) {
-            print_error("Failed to initialize symbol table for file", argv[i]);
-            continue;
-        }
-        if (!init_macro_table(&macrotab)) {
-            print_error("Failed to initialize macro table for file", argv[i]);
-            free_symbol_table(&symtab);
-            continue;
-        }
-        if (process_input_file(argv[i], i, total_files, &symtab, &memory, &macrotab))
-            success_count++;
-
-        free_symbol_table(&symtab);
-        free_macro_table(&macrotab);
+    if (options.serve_socket && (options.file_count > 0)) {
+        print_error("Files can't be assembled by the server itself", options.files[0]);
+        free_options(&options);
+        return 1;
     }
-    printf("%c--- Summary ---%c", NEWLINE, NEWLINE);
-    printf("Successfully processed: %d/%d files%c", success_count, total_files, NEWLINE);
+    if (!init_file_tables(&tables)) {
+        print_error("Failed to initialize assembler tables", NULL);
+        free_options(&options);
+        return 1;
+    }
+    if (options.serve_socket)
+        runtime_result = serve_requests(options.serve_socket, run_assembler, &tables);
+    else
+        runtime_result = run_assembler(&options, &tables);
 
-    runtime_result = (success_count == total_files) ? 0 : 1;
-    printf("%cAssembler completed with exit code %d!%c", NEWLINE, runtime_result, NEWLINE);
+    free_file_tables(&tables);
+    free_options(&options);
+    PRINT_ALLOCATION_REPORT();
 
     return runtime_result;
 }
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "symbol_table.h"
+#include "file_io.h"
+#include "diagnostics.h"
+#include "binary_object.h"
+#include "assembler_api.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to free the buffers of a context that were initialized.
+Receives: AssemblerContext *context - Context to free
+          int output_count - Amount of initialized output buffers
+          int log_ok - 'boolean' flag, log was initialized
+          int diagnostics_ok - 'boolean' flag, diagnostic list was initialized
+*/
+static void free_context_buffers(AssemblerContext *context, int output_count, int log_ok, int diagnostics_ok) {
+    int i;
+
+    for (i = 0; i < output_count; i++) {
+        free_source_buffer(&context->outputs[i]);
+    }
+    if (log_ok)
+        free_source_buffer(&context->log);
+    if (diagnostics_ok)
+        free_diagnostic_list(&context->diagnostics);
+}
+
+/*
+Function to empty a context before the next source, keeping its allocations.
+Receives: AssemblerContext *context - Context to reset
+*/
+static void reset_assembler_context(AssemblerContext *context) {
+    int i;
+
+    reset_file_tables(&context->tables);
+
+    for (i = 0; i < ASSEMBLER_OUTPUT_COUNT; i++) {
+        reset_source_buffer(&context->outputs[i]);
+        context->produced[i] = FALSE;
+    }
+    reset_source_buffer(&context->log);
+    reset_diagnostic_list(&context->diagnostics);
+}
+
+/*
+Function to run all assembler stages on the source held by the context, rendering the outputs in memory.
+Receives: AssemblerContext *context - Context holding the source
+          const char *name - Name of source (used in messages)
+          const char *am_name - Name of expanded source (used in messages)
+Returns: int - TRUE if all stages succeeded, FALSE on any error
+*/
+static int assemble_context_source(AssemblerContext *context, const char *name, const char *am_name) {
+    FileTables *tables = &context->tables;
+    SourceBuffer *expanded = &context->outputs[ASSEMBLER_OUTPUT_EXPANDED];
+
+    if (preprocess_macros(&tables->as_source, expanded, &tables->macrotab) == PASS_ERROR) {
+        print_message("%cPreprocessing failed for %s%s%c", NEWLINE, name, FILE_EXT_INPUT, NEWLINE);
+        return FALSE;
+    }
+    context->produced[ASSEMBLER_OUTPUT_EXPANDED] = TRUE;
+
+    if (first_pass(am_name, expanded, &tables->statements, &tables->symtab, &tables->memory, &tables->fixups, &tables->line_arena) == PASS_ERROR) {
+        print_message("%cFirst pass failed for %s%c", NEWLINE, am_name, NEWLINE);
+        return FALSE;
+    }
+    if (second_pass(&tables->symtab, &tables->memory, &tables->statements, &tables->fixups) == PASS_ERROR) {
+        print_message("%cSecond pass failed for %s%c", NEWLINE, am_name, NEWLINE);
+        return FALSE;
+    }
+    if (!render_object_file(&tables->memory, &context->outputs[ASSEMBLER_OUTPUT_OBJECT]))
+        return FALSE;
+
+    context->produced[ASSEMBLER_OUTPUT_OBJECT] = TRUE;
+
+    if (has_entries(&tables->symtab)) {
+        if (!render_entry_file(&tables->symtab, &context->outputs[ASSEMBLER_OUTPUT_ENTRY]))
+            return FALSE;
+
+        context->produced[ASSEMBLER_OUTPUT_ENTRY] = TRUE;
+    }
+    if (has_externs(&tables->symtab)) {
+        if (!render_extern_file(&tables->memory, &tables->symtab, &context->outputs[ASSEMBLER_OUTPUT_EXTERN]))
+            return FALSE;
+
+        context->produced[ASSEMBLER_OUTPUT_EXTERN] = TRUE;
+    }
+    if (!render_relocation_file(&tables->memory, &tables->symtab, &context->outputs[ASSEMBLER_OUTPUT_RELOC]))
+        return FALSE;
+
+    context->produced[ASSEMBLER_OUTPUT_RELOC] = TRUE;
+
+    if (!render_binary_object(&tables->memory, &tables->symtab, &context->outputs[ASSEMBLER_OUTPUT_BINARY]))
+        return FALSE;
+
+    context->produced[ASSEMBLER_OUTPUT_BINARY] = TRUE;
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to create an assembler context, with its tables initialized once for all sources.
+Returns: AssemblerContext* - New context, NULL on memory error
+*/
+AssemblerContext *create_assembler_context(void) {
+    AssemblerContext *context = ALLOC(sizeof(AssemblerContext), ALLOC_SITE_OTHER);
+    int i, log_ok, diagnostics_ok;
+
+    if (!context) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to create assembler context");
+        return NULL;
+    }
+    for (i = 0; i < ASSEMBLER_OUTPUT_COUNT; i++) {
+        context->produced[i] = FALSE;
+
+        if (!init_source_buffer(&context->outputs[i]))
+            break;
+    }
+    log_ok = (i == ASSEMBLER_OUTPUT_COUNT) && init_source_buffer(&context->log);
+    diagnostics_ok = log_ok && init_diagnostic_list(&context->diagnostics);
+
+    if (!diagnostics_ok || !init_file_tables(&context->tables)) {
+        free_context_buffers(context, i, log_ok, diagnostics_ok);
+        FREE(context);
+        return NULL;
+    }
+    return context;
+}
+
+/*
+Function to free an assembler context, with all outputs & diagnostics it holds.
+Receives: AssemblerContext *context - Context to free (may be NULL)
+*/
+void free_assembler_context(AssemblerContext *context) {
+    if (!context)
+        return;
+
+    free_file_tables(&context->tables);
+    free_context_buffers(context, ASSEMBLER_OUTPUT_COUNT, TRUE, TRUE);
+    FREE(context);
+}
+
+/*
+Function to assemble a source held in memory, replacing the outputs & diagnostics of the previous source.
+Messages are captured by the context (never printed), and no file is read or written.
+Receives: AssemblerContext *context - Context to assemble with
+          const char *name - Name of source, without extension (used in messages, must leave room for an extension)
+          const char *source - Source text (not necessarily null terminated)
+          size_t length - Length of source
+Returns: int - TRUE if assembled successfully (object output produced), FALSE on any error
+*/
+int assemble_source_buffer(AssemblerContext *context, const char *name, const char *source, size_t length) {
+    char am_name[MAX_FILENAME_LENGTH];
+    SourceBuffer *previous_log = get_diagnostic_log();
+    int result;
+
+    reset_assembler_context(context);
+    set_diagnostic_log(&context->log);
+    set_diagnostic_list(&context->diagnostics);
+
+    /* A name that leaves no room for an extension is an error, as on the command line */
+    if (strlen(name) >= MAX_FILENAME_LENGTH - MAX_EXTENSION_LENGTH) {
+        print_error("Filename too long", NULL);
+        result = FALSE;
+    }
+    else {
+        sprintf(am_name, "%s%s", name, FILE_EXT_PREPROC);
+        result = append_source_span(&context->tables.as_source, source, length) &&
+                 assemble_context_source(context, name, am_name);
+    }
+
+    set_diagnostic_list(NULL);
+    set_diagnostic_log(previous_log);
+
+    return result;
+}
+
+/*
+Function to get an output of the last assembled source.
+Receives: const AssemblerContext *context - Context that assembled the source
+          int output - Output to get (ASSEMBLER_OUTPUT_*)
+          size_t *length - Output length of text (0 if not produced)
+Returns: const char* - Null terminated output text, NULL if not produced
+*/
+const char *get_assembler_output(const AssemblerContext *context, int output, size_t *length) {
+    *length = 0;
+
+    if ((output < 0) || (output >= ASSEMBLER_OUTPUT_COUNT) || !context->produced[output])
+        return NULL;
+
+    *length = context->outputs[output].length;
+    return context->outputs[output].text;
+}
+
+/*
+Function to get the messages of the last assembled source, as the assembler would print them.
+Receives: const AssemblerContext *context - Context that assembled the source
+          size_t *length - Output length of text
+Returns: const char* - Null terminated messages
+*/
+const char *get_assembler_log(const AssemblerContext *context, size_t *length) {
+    *length = context->log.length;
+    return context->log.text;
+}
+
+/*
+Function to get the amount of errors & warnings of the last assembled source.
+Receives: const AssemblerContext *context - Context that assembled the source
+Returns: int - Amount of diagnostics
+*/
+int get_diagnostic_count(const AssemblerContext *context) {
+    return context->diagnostics.count;
+}
+
+/*
+Function to get an error / warning of the last assembled source, in reporting order.
+Receives: const AssemblerContext *context - Context that assembled the source
+          int index - Index of diagnostic (0 to count - 1)
+Returns: const Diagnostic* - Diagnostic, NULL if index is out of range
+*/
+const Diagnostic *get_diagnostic(const AssemblerContext *context, int index) {
+    if ((index < 0) || (index >= context->diagnostics.count))
+        return NULL;
+
+    return &context->diagnostics.items[index];
+}
\ No newline at end of file
@@ -1,3 +1,6 @@
+#include <stdio.h>
+#include <string.h>
+
 #include "utils.h"
 #include "memory.h"
 #include "encoder.h"
@@ -5,6 +8,27 @@
 /* base-4 digit mapping string (a=0, b=1, c=2, d=3) */
 static const char base4_digits[BASE4_ENCODING + 1] = {'a','b','c','d',NULL_TERMINATOR};
 
+/*
+Compile-time base-4 tables, built by preprocessor string concatenation.
+Each BASE4_DIGITS_N level appends one more digit (most significant first),
+so entries come out in numeric order: "aaaaa", "aaaab", ... "ddddd".
+*/
+#define BASE4_DIGITS_1(prefix) prefix "a", prefix "b", prefix "c", prefix "d"
+#define BASE4_DIGITS_2(prefix) BASE4_DIGITS_1(prefix "a"), BASE4_DIGITS_1(prefix "b"), \
+                               BASE4_DIGITS_1(prefix "c"), BASE4_DIGITS_1(prefix "d")
+#define BASE4_DIGITS_3(prefix) BASE4_DIGITS_2(prefix "a"), BASE4_DIGITS_2(prefix "b"), \
+                               BASE4_DIGITS_2(prefix "c"), BASE4_DIGITS_2(prefix "d")
+#define BASE4_DIGITS_4(prefix) BASE4_DIGITS_3(prefix "a"), BASE4_DIGITS_3(prefix "b"), \
+                               BASE4_DIGITS_3(prefix "c"), BASE4_DIGITS_3(prefix "d")
+#define BASE4_DIGITS_5(prefix) BASE4_DIGITS_4(prefix "a"), BASE4_DIGITS_4(prefix "b"), \
+                               BASE4_DIGITS_4(prefix "c"), BASE4_DIGITS_4(prefix "d")
+
+/* All 4-digit addresses (0-255) */
+static const char base4_addresses[BASE4_ADDRESS_COUNT][ADDR_LENGTH] = { BASE4_DIGITS_4("") };
+
+/* All 5-digit (10-bit) words (0-1023) */
+static const char base4_words[BASE4_WORD_COUNT][WORD_LENGTH] = { BASE4_DIGITS_5("") };
+
 /* Inner STATIC methods */
 /* ==================================================================== */
 /*
@@ -49,31 +73,52 @@ void convert_to_base4_header(int value, char *result) {
 }
 
 /*
-Function to convert a memory address to fixed-length base-4 string.
-Receives: int value - Address value to convert
+Function to convert a memory address to fixed-length base-4 string, with a single table copy.
+Receives: int value - Address value to convert (masked to 8 bits)
           char *result - Output buffer (must be ADDR_LENGTH size)
 */
 void convert_to_base4_address(int value, char *result) {
-    int i;
-
-    for (i = ADDR_LENGTH - 2; i >= 0; i--) {
-        result[i] = base4_digits[value % BASE4_ENCODING];
-        value /= BASE4_ENCODING;
-    }
-    result[ADDR_LENGTH - 1] = NULL_TERMINATOR;
+    memcpy(result, base4_addresses[value & ADDRESS_MASK], ADDR_LENGTH);
 }
 
 /*
-Function to convert a 10-bit word value to fixed-length base-4 string.
+Function to convert a 10-bit word value to fixed-length base-4 string, with a single table copy.
 Receives: int value - Word value to convert (masked to 10 bits)
           char *result - Output buffer (must be WORD_LENGTH size)
 */
 void convert_to_base4_word(int value, char *result) {
-    int i;
+    memcpy(result, base4_words[value & WORD_MASK], WORD_LENGTH);
+}
 
-    for (i = WORD_LENGTH - 2; i >= 0; i--) {
-        result[i] = base4_digits[value % BASE4_ENCODING];
-        value /= BASE4_ENCODING;
+/*
+Function to render a whole memory image as .ob file text, into a single buffer.
+Writes the IC/DC header line, then one "address word" line per instruction and data word.
+Receives: const MemoryImage *memory - Memory image to render
+          char *buffer - Output buffer (must be MAX_OBJECT_TEXT_LENGTH size)
+Returns: size_t - Length of rendered text (not null terminated)
+*/
+size_t format_object_image(const MemoryImage *memory, char *buffer) {
+    char ic_str[ADDR_LENGTH], dc_str[ADDR_LENGTH];
+    char *p = buffer;
+    unsigned int i, address, word;
+
+    convert_to_base4_header(memory->ic, ic_str);
+    convert_to_base4_header(memory->dc, dc_str);
+    p += sprintf(p, "%s %s%c", ic_str, dc_str, NEWLINE);
+
+    for (i = 0; i < memory->ic + memory->dc; i++) {
+        address = IC_START + i;
+
+        memcpy(p, base4_addresses[address & ADDRESS_MASK], ADDR_LENGTH - 1);
+        p += ADDR_LENGTH - 1;
+        *p++ = ' ';
+
+        /* Data words are stored apart from instructions, and follow them in output */
+        word = (i < memory->ic) ? memory->code[i] : memory->data[i - memory->ic];
+
+        memcpy(p, base4_words[word & WORD_MASK], WORD_LENGTH - 1);
+        p += WORD_LENGTH - 1;
+        *p++ = NEWLINE;
     }
-    result[WORD_LENGTH - 1] = NULL_TERMINATOR;
+    return (size_t)(p - buffer);
 }
\ No newline at end of file
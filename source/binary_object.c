@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "source_buffer.h"
+#include "binary_object.h"
+#include "alloc_tracking.h"
+
+/* Counts & offsets of the sections of an object being rendered */
+typedef struct {
+    unsigned long entry_count;
+    unsigned long extern_count;
+    unsigned long relocation_count;
+    unsigned long label_count;
+    unsigned long strings_length;
+    unsigned long words_offset;
+    unsigned long entries_offset;
+    unsigned long externs_offset;
+    unsigned long relocations_offset;
+    unsigned long labels_offset;
+    unsigned long strings_offset;
+} BinaryLayout;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to append a single entry / external / relocation / label record.
+Receives: SourceBuffer *output - Object being rendered
+          unsigned long name_offset - Offset of name in strings (BINARY_NO_NAME if none)
+          int address - Address of symbol / referencing word
+          int kind - A/R/E kind (0 for entries, externals & labels)
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+static int append_record(SourceBuffer *output, unsigned long name_offset, int address, int kind) {
+    return append_binary_u32(output, name_offset) &&
+           append_binary_u16(output, (unsigned int)address) &&
+           append_binary_u16(output, (unsigned int)kind);
+}
+
+/*
+Function to round an offset up to the record alignment.
+Receives: unsigned long offset - Offset to align
+Returns: unsigned long - Aligned offset
+*/
+static unsigned long align_offset(unsigned long offset) {
+    return (offset + BINARY_RECORD_ALIGNMENT - 1) & ~(unsigned long)(BINARY_RECORD_ALIGNMENT - 1);
+}
+
+/*
+Function to plan the layout of an object: section counts & offsets, and the string offset of every named symbol.
+Only entry & external symbols are named, each once.
+Receives: const MemoryImage *memory - Pointer to memory image
+          const SymbolTable *symtab - Pointer to symbol table
+          unsigned long *name_offsets - Output string offsets, indexed by symbol (symtab->count size)
+          BinaryLayout *layout - Output layout
+*/
+static void plan_binary_layout(const MemoryImage *memory, const SymbolTable *symtab, unsigned long *name_offsets, BinaryLayout *layout) {
+    const Symbol *symbol;
+    unsigned int i;
+    int j;
+
+    layout->entry_count = 0;
+    layout->extern_count = 0;
+    layout->label_count = 0;
+    layout->strings_length = 0;
+    layout->relocation_count = (unsigned long)memory->relocation_count;
+
+    for (i = 0; i < symtab->count; i++) {
+        symbol = &symtab->symbols[i];
+        name_offsets[i] = BINARY_NO_NAME;
+
+        if (symbol->is_entry)
+            layout->entry_count++;
+
+        if (symbol->type != EXTERNAL_SYMBOL)
+            layout->label_count++;
+
+        if (symbol->is_entry || (symbol->type == EXTERNAL_SYMBOL)) {
+            name_offsets[i] = layout->strings_length;
+            layout->strings_length += strlen(symbol->name) + 1;
+        }
+    }
+    for (j = 0; j < memory->relocation_count; j++) {
+        if (memory->relocations[j].are == ARE_EXTERNAL)
+            layout->extern_count++;
+    }
+    layout->words_offset = BINARY_HEADER_SIZE;
+    layout->entries_offset = align_offset(layout->words_offset + 2 * (memory->ic + memory->dc));
+    layout->externs_offset = layout->entries_offset + layout->entry_count * BINARY_RECORD_SIZE;
+    layout->relocations_offset = layout->externs_offset + layout->extern_count * BINARY_RECORD_SIZE;
+    layout->labels_offset = layout->relocations_offset + layout->relocation_count * BINARY_RECORD_SIZE;
+    layout->strings_offset = layout->labels_offset + layout->label_count * BINARY_RECORD_SIZE;
+}
+
+/*
+Function to append the object header.
+Receives: SourceBuffer *output - Object being rendered (empty)
+          const MemoryImage *memory - Pointer to memory image
+          const BinaryLayout *layout - Planned layout
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+static int append_header(SourceBuffer *output, const MemoryImage *memory, const BinaryLayout *layout) {
+    return append_source_span(output, BINARY_MAGIC, BINARY_MAGIC_LENGTH) &&
+           append_binary_u16(output, BINARY_VERSION) &&
+           append_binary_u16(output, IC_START) &&
+           append_binary_u16(output, memory->ic) &&
+           append_binary_u16(output, memory->dc) &&
+           append_binary_u32(output, layout->words_offset) &&
+           append_binary_u32(output, layout->entries_offset) &&
+           append_binary_u32(output, layout->entry_count) &&
+           append_binary_u32(output, layout->externs_offset) &&
+           append_binary_u32(output, layout->extern_count) &&
+           append_binary_u32(output, layout->relocations_offset) &&
+           append_binary_u32(output, layout->relocation_count) &&
+           append_binary_u32(output, layout->strings_offset) &&
+           append_binary_u32(output, layout->strings_length) &&
+           append_binary_u32(output, layout->labels_offset) &&
+           append_binary_u32(output, layout->label_count);
+}
+
+/*
+Function to append the packed words, instructions followed by data (as in the .ob file).
+Receives: SourceBuffer *output - Object being rendered
+          const MemoryImage *memory - Pointer to memory image
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+static int append_words(SourceBuffer *output, const MemoryImage *memory) {
+    unsigned int i;
+
+    for (i = 0; i < memory->ic; i++) {
+        if (!append_binary_u16(output, memory->code[i]))
+            return FALSE;
+    }
+    for (i = 0; i < memory->dc; i++) {
+        if (!append_binary_u16(output, memory->data[i]))
+            return FALSE;
+    }
+    return append_binary_padding(output);
+}
+
+/*
+Function to append the entry, external reference, relocation & label records.
+Receives: SourceBuffer *output - Object being rendered
+          const MemoryImage *memory - Pointer to memory image
+          const SymbolTable *symtab - Pointer to symbol table
+          const unsigned long *name_offsets - String offsets, indexed by symbol
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+static int append_records(SourceBuffer *output, const MemoryImage *memory, const SymbolTable *symtab, const unsigned long *name_offsets) {
+    const Relocation *relocation;
+    unsigned int i;
+    int j;
+
+    for (i = 0; i < symtab->count; i++) {
+        if (symtab->symbols[i].is_entry &&
+            !append_record(output, name_offsets[i], symtab->symbols[i].value, 0))
+            return FALSE;
+    }
+    for (j = 0; j < memory->relocation_count; j++) {
+        relocation = &memory->relocations[j];
+
+        if ((relocation->are == ARE_EXTERNAL) &&
+            !append_record(output, name_offsets[relocation->symbol_index], relocation->address, 0))
+            return FALSE;
+    }
+    for (j = 0; j < memory->relocation_count; j++) {
+        relocation = &memory->relocations[j];
+
+        if (!append_record(output, (relocation->are == ARE_EXTERNAL) ? name_offsets[relocation->symbol_index] : BINARY_NO_NAME,
+                           relocation->address, relocation->are))
+            return FALSE;
+    }
+    for (i = 0; i < symtab->count; i++) {
+        if ((symtab->symbols[i].type != EXTERNAL_SYMBOL) &&
+            !append_record(output, BINARY_NO_NAME, symtab->symbols[i].value, 0))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to append the names of all entry & external symbols, null terminated, in symbol table order.
+Receives: SourceBuffer *output - Object being rendered
+          const SymbolTable *symtab - Pointer to symbol table
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+static int append_strings(SourceBuffer *output, const SymbolTable *symtab) {
+    const Symbol *symbol;
+    unsigned int i;
+
+    for (i = 0; i < symtab->count; i++) {
+        symbol = &symtab->symbols[i];
+
+        if ((symbol->is_entry || (symbol->type == EXTERNAL_SYMBOL)) &&
+            !append_source_span(output, symbol->name, strlen(symbol->name) + 1))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to check that a section of records lies within the object.
+Receives: const unsigned char *data - Object contents
+          size_t length - Object length
+          int field - Header field of the section offset (followed by its count)
+Returns: int - TRUE if section is aligned & within the object, FALSE otherwise
+*/
+static int check_record_section(const unsigned char *data, size_t length, int field) {
+    unsigned long offset = BINARY_U32(data, field);
+    unsigned long count = BINARY_U32(data, field + 4);
+
+    return ((offset % BINARY_RECORD_ALIGNMENT) == 0) && (offset <= length) &&
+           (count <= (length - offset) / BINARY_RECORD_SIZE);
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to render the binary object file contents (--binary), see binary_object.h for the layout.
+Receives: const MemoryImage *memory - Pointer to memory image
+          const SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer receiving the rendered file (reset first)
+Returns: int - TRUE if rendered, FALSE on memory error
+*/
+int render_binary_object(const MemoryImage *memory, const SymbolTable *symtab, SourceBuffer *output) {
+    BinaryLayout layout;
+    unsigned long *name_offsets = NULL;
+    int result;
+
+    if (symtab->count > 0) {
+        name_offsets = ALLOC(symtab->count * sizeof(unsigned long), ALLOC_SITE_OTHER);
+
+        if (!name_offsets) {
+            print_error(ERR_MEMORY_ALLOCATION, "Failed to render binary object");
+            return FALSE;
+        }
+    }
+    plan_binary_layout(memory, symtab, name_offsets, &layout);
+    reset_source_buffer(output);
+
+    result = append_header(output, memory, &layout) &&
+             append_words(output, memory) &&
+             append_records(output, memory, symtab, name_offsets) &&
+             append_strings(output, symtab);
+
+    FREE(name_offsets);
+    return result;
+}
+
+/*
+Function to append a 16-bit little endian field.
+Receives: SourceBuffer *output - Binary file being rendered
+          unsigned int value - Field value
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+int append_binary_u16(SourceBuffer *output, unsigned int value) {
+    char bytes[2];
+
+    bytes[0] = (char)(value & 0xFF);
+    bytes[1] = (char)((value >> 8) & 0xFF);
+
+    return append_source_span(output, bytes, sizeof(bytes));
+}
+
+/*
+Function to append a 32-bit little endian field.
+Receives: SourceBuffer *output - Binary file being rendered
+          unsigned long value - Field value
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+int append_binary_u32(SourceBuffer *output, unsigned long value) {
+    return append_binary_u16(output, (unsigned int)(value & 0xFFFF)) &&
+           append_binary_u16(output, (unsigned int)((value >> 16) & 0xFFFF));
+}
+
+/*
+Function to append zero bytes until the output length is a multiple of the record alignment.
+Receives: SourceBuffer *output - Binary file being rendered
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+int append_binary_padding(SourceBuffer *output) {
+    static const char zeros[BINARY_RECORD_ALIGNMENT] = { 0 };
+    size_t remainder = output->length % BINARY_RECORD_ALIGNMENT;
+
+    if (remainder == 0)
+        return TRUE;
+
+    return append_source_span(output, zeros, BINARY_RECORD_ALIGNMENT - remainder);
+}
+
+/*
+Function to get the name of an entry / external / relocation record, from the strings of its object.
+Receives: const unsigned char *object - Binary object (already checked)
+          unsigned long record - Offset of record in object
+Returns: const char* - Null terminated name, NULL if record has no valid name
+*/
+const char *get_binary_record_name(const unsigned char *object, unsigned long record) {
+    unsigned long strings = BINARY_U32(object, BINARY_STRINGS_FIELD);
+    unsigned long strings_length = BINARY_U32(object, BINARY_STRINGS_FIELD + 4);
+    unsigned long name = BINARY_U32(object, record + BINARY_RECORD_NAME);
+
+    if ((name >= strings_length) || !memchr(object + strings + name, NULL_TERMINATOR, strings_length - name))
+        return NULL;
+
+    return (const char *)object + strings + name;
+}
+
+/*
+Function to validate a binary object before it is used in place:
+magic & version (objects of an older version must be assembled again), and that the words, all record sections & strings lie within the object.
+Receives: const unsigned char *data - Object contents (e.g. a mapped file)
+          size_t length - Object length
+Returns: int - TRUE if object is valid, FALSE otherwise
+*/
+int check_binary_object(const unsigned char *data, size_t length) {
+    unsigned long words_offset, word_count, strings_offset, strings_length;
+
+    if ((length < BINARY_HEADER_SIZE) ||
+        (memcmp(data, BINARY_MAGIC, BINARY_MAGIC_LENGTH) != 0) ||
+        (BINARY_U16(data, BINARY_VERSION_FIELD) != BINARY_VERSION))
+        return FALSE;
+
+    words_offset = BINARY_U32(data, BINARY_WORDS_FIELD);
+    word_count = BINARY_U16(data, BINARY_IC_FIELD) + BINARY_U16(data, BINARY_DC_FIELD);
+    strings_offset = BINARY_U32(data, BINARY_STRINGS_FIELD);
+    strings_length = BINARY_U32(data, BINARY_STRINGS_FIELD + 4);
+
+    return (words_offset <= length) && (word_count <= (length - words_offset) / 2) &&
+           check_record_section(data, length, BINARY_ENTRIES_FIELD) &&
+           check_record_section(data, length, BINARY_EXTERNS_FIELD) &&
+           check_record_section(data, length, BINARY_RELOCS_FIELD) &&
+           check_record_section(data, length, BINARY_LABELS_FIELD) &&
+           (strings_offset <= length) && (strings_length <= length - strings_offset);
+}
\ No newline at end of file
@@ -0,0 +1,374 @@
+/* opendir(), stat(), mkdir(), utime() & getpid() are POSIX, not part of C90 */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <utime.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "diagnostics.h"
+#include "cache.h"
+#include "alloc_tracking.h"
+
+#define CACHE_DIR_MODE 0777
+
+/* 64-bit FNV-1a, as two 32-bit halves (C90 has no 64-bit integer type) */
+#define FNV64_BASIS_HIGH 0xCBF29CE4UL
+#define FNV64_BASIS_LOW 0x84222325UL
+#define FNV64_PRIME_LOW 0x1B3UL         /* the prime is 2^40 + 0x1B3 */
+#define FNV64_PRIME_SHIFT 8             /* 2^40 moves the low half into the high half, shifted by 40 - 32 */
+#define HALF_BITS 16
+#define HALF_MASK 0xFFFFUL
+
+/* Section names, indexed by CACHE_SECTION_* */
+static const char *section_names[CACHE_SECTION_COUNT] = {
+    "log", "am", "ob", "ent", "ext", "rel", "bin"
+};
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to continue a 64-bit FNV-1a hash over a span of bytes.
+The low half is multiplied in 16-bit pieces, so no partial product overflows 32 bits.
+Receives: unsigned long hash[] - High & low 32-bit halves of the hash so far (or the offset basis), updated
+          const char *text - Start of span
+          size_t length - Length of span
+*/
+static void hash_bytes(unsigned long hash[], const char *text, size_t length) {
+    unsigned long low_product, high_product, middle;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash[1] ^= (unsigned char)text[i];
+        low_product = (hash[1] & HALF_MASK) * FNV64_PRIME_LOW;
+        high_product = (hash[1] >> HALF_BITS) * FNV64_PRIME_LOW;
+        middle = (low_product >> HALF_BITS) + (high_product & HALF_MASK);
+
+        hash[0] = (hash[0] * FNV64_PRIME_LOW + (hash[1] << FNV64_PRIME_SHIFT) +
+                   (high_product >> HALF_BITS) + (middle >> HALF_BITS)) & HASH_MASK;
+        hash[1] = ((middle & HALF_MASK) << HALF_BITS) | (low_product & HALF_MASK);
+    }
+}
+
+/*
+Function to build the path of a cache entry file.
+Receives: const char *directory - Cache directory
+          const char *key - Entry key
+          const char *suffix - Extra suffix (temporary file), empty for the entry itself
+          char *path - Output buffer (MAX_CACHE_PATH_LENGTH size)
+*/
+static void build_entry_path(const char *directory, const char *key, const char *suffix, char *path) {
+    sprintf(path, "%s/%s%s%s", directory, key, CACHE_FILE_EXT, suffix);
+}
+
+/*
+Function to find a section by the name it is stored with.
+Receives: const char *name - Start of name
+          size_t length - Length of name
+Returns: int - Section (CACHE_SECTION_*), -1 if unknown
+*/
+static int find_section(const char *name, size_t length) {
+    int i;
+
+    for (i = 0; i < CACHE_SECTION_COUNT; i++) {
+        if ((strlen(section_names[i]) == length) && (strncmp(section_names[i], name, length) == 0))
+            return i;
+    }
+    return -1;
+}
+
+/*
+Function to split a read cache entry into its sections.
+An entry is a "asmcache <version>" line, followed by "<section> <length>" lines, each followed by its text.
+Receives: const SourceBuffer *entry - Entry contents
+          CacheSection sections[] - Output sections (CACHE_SECTION_COUNT size)
+Returns: int - TRUE if entry is complete & of this assembler version, FALSE otherwise
+*/
+static int parse_cache_entry(const SourceBuffer *entry, CacheSection sections[]) {
+    char header[MAX_SECTION_HEADER_LENGTH];
+    const char *line, *name_end;
+    char *end;
+    size_t length, position = 0;
+    unsigned long section_length;
+    int i, section;
+
+    for (i = 0; i < CACHE_SECTION_COUNT; i++) {
+        sections[i].present = FALSE;
+    }
+    sprintf(header, "%s %s%c", CACHE_MAGIC, ASSEMBLER_VERSION, NEWLINE);
+
+    if (!next_source_line(entry, &position, &line, &length) ||
+        (length != strlen(header)) || (strncmp(line, header, length) != 0))
+        return FALSE;
+
+    while (next_source_line(entry, &position, &line, &length)) {
+        name_end = memchr(line, ' ', length);
+
+        if (!name_end || ((section = find_section(line, name_end - line)) < 0))
+            return FALSE;
+
+        section_length = strtoul(name_end + 1, &end, BASE10_ENCODING);
+
+        if ((end == name_end + 1) || (*end != NEWLINE) || (section_length > entry->length - position))
+            return FALSE;
+
+        sections[section].offset = position;
+        sections[section].length = section_length;
+        sections[section].present = TRUE;
+        position += section_length;
+    }
+    return TRUE;
+}
+
+/*
+Function to append a section, its "<section> <length>" line and text, to an entry being built.
+Receives: SourceBuffer *entry - Entry being built
+          int section - Section to append (CACHE_SECTION_*)
+          const char *text - Section text
+          size_t length - Length of text
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+static int append_section(SourceBuffer *entry, int section, const char *text, size_t length) {
+    char header[MAX_SECTION_HEADER_LENGTH];
+
+    sprintf(header, "%s %lu%c", section_names[section], (unsigned long)length, NEWLINE);
+
+    return append_source_text(entry, header) && append_source_span(entry, text, length);
+}
+
+/*
+Function to order cache files by last use, least recently used first, for qsort.
+Receives: const void *a - First file (CacheFile)
+          const void *b - Second file (CacheFile)
+Returns: int - Negative, zero or positive
+*/
+static int compare_last_used(const void *a, const void *b) {
+    long first = ((const CacheFile *)a)->last_used;
+    long second = ((const CacheFile *)b)->last_used;
+
+    return (first > second) - (first < second);
+}
+
+/*
+Function to list the entry files of the cache directory, with their sizes & last use.
+Receives: const char *directory - Cache directory
+          CacheFile **files - Output array of files (to be freed by caller)
+          long *total_size - Output total size of the files
+Returns: int - Number of files, -1 on error
+*/
+static int list_cache_files(const char *directory, CacheFile **files, long *total_size) {
+    char path[MAX_CACHE_PATH_LENGTH];
+    CacheFile *new_files;
+    struct dirent *dir_entry;
+    struct stat info;
+    size_t name_length, ext_length = strlen(CACHE_FILE_EXT);
+    int count = 0, capacity = 0;
+    DIR *dir = opendir(directory);
+
+    *files = NULL;
+    *total_size = 0;
+
+    if (!dir) {
+        print_error("Failed to open cache directory", directory);
+        return -1;
+    }
+    while ((dir_entry = readdir(dir)) != NULL) {
+        name_length = strlen(dir_entry->d_name);
+
+        /* Only full entries, temporary files of running assemblers are left alone */
+        if ((name_length <= ext_length) || (name_length >= MAX_CACHE_NAME_LENGTH) ||
+            (strcmp(dir_entry->d_name + name_length - ext_length, CACHE_FILE_EXT) != 0))
+            continue;
+
+        sprintf(path, "%s/%s", directory, dir_entry->d_name);
+
+        if (stat(path, &info) != 0)
+            continue;
+
+        if (count == capacity) {
+            capacity = (capacity == 0) ? INITIAL_CACHE_FILES : capacity * 2;
+            new_files = REALLOC(*files, capacity * sizeof(CacheFile), ALLOC_SITE_CACHE);
+
+            if (!new_files) {
+                print_error(ERR_MEMORY_ALLOCATION, "Failed to list cache directory");
+                FREE(*files);
+                *files = NULL;
+                closedir(dir);
+                return -1;
+            }
+            *files = new_files;
+        }
+        strcpy((*files)[count].name, dir_entry->d_name);
+        (*files)[count].size = (long)info.st_size;
+        (*files)[count].last_used = (long)info.st_mtime;
+        *total_size += (long)info.st_size;
+        count++;
+    }
+    closedir(dir);
+
+    return count;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to create the cache directory, unless it exists already.
+Receives: const char *directory - Cache directory
+Returns: int - TRUE if directory is usable, FALSE otherwise
+*/
+int prepare_cache_directory(const char *directory) {
+    struct stat info;
+
+    if ((mkdir(directory, CACHE_DIR_MODE) != 0) && (errno != EEXIST)) {
+        print_error("Failed to create cache directory", directory);
+        return FALSE;
+    }
+    if ((stat(directory, &info) != 0) || !S_ISDIR(info.st_mode)) {
+        print_error("Cache path is not a directory", directory);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to build the cache key of a source file: a 64-bit FNV-1a hash of the assembler version,
+filename (messages mention it) & source bytes, and the source length, as hex digits.
+Receives: const char *filename - Name of source (.as) file
+          const SourceBuffer *as_source - Source (.as) file contents
+          char *key - Output key (CACHE_KEY_LENGTH size)
+*/
+void build_cache_key(const char *filename, const SourceBuffer *as_source, char *key) {
+    unsigned long hash[2];
+
+    hash[0] = FNV64_BASIS_HIGH;
+    hash[1] = FNV64_BASIS_LOW;
+    hash_bytes(hash, ASSEMBLER_VERSION, sizeof(ASSEMBLER_VERSION));
+    hash_bytes(hash, filename, strlen(filename) + 1);
+    hash_bytes(hash, as_source->text, as_source->length);
+
+    sprintf(key, "%08lx%08lx%08lx", hash[0], hash[1], (unsigned long)as_source->length & HASH_MASK);
+}
+
+/*
+Function to restore the results of an earlier assembly of the same source from the cache:
+writes the stored output files, and prints the stored messages.
+Receives: const char *directory - Cache directory
+          const char *key - Key of the source (see build_cache_key)
+          const char *outputs[] - File each section is restored to (CACHE_SECTION_COUNT size),
+                                  the .am, .rel & .bin files are NULL unless requested (--keep-am, --reloc, --binary)
+          SourceBuffer *entry - Buffer the entry is read into
+Returns: int - TRUE on a hit (all files restored), FALSE on a miss
+*/
+int restore_cache_entry(const char *directory, const char *key, const char *outputs[], SourceBuffer *entry) {
+    char path[MAX_CACHE_PATH_LENGTH];
+    CacheSection sections[CACHE_SECTION_COUNT];
+    int i;
+
+    build_entry_path(directory, key, "", path);
+
+    /* A missing entry is a silent miss, read_source_file() would report it */
+    if ((get_file_size(path) < 0) || !read_source_file(entry, path) || !parse_cache_entry(entry, sections))
+        return FALSE;
+
+    if ((outputs[CACHE_SECTION_AM] && !sections[CACHE_SECTION_AM].present) ||
+        (outputs[CACHE_SECTION_RELOC] && !sections[CACHE_SECTION_RELOC].present) ||
+        (outputs[CACHE_SECTION_BINARY] && !sections[CACHE_SECTION_BINARY].present))
+        return FALSE;
+
+    for (i = CACHE_SECTION_AM; i < CACHE_SECTION_COUNT; i++) {
+        if (!outputs[i])
+            continue;
+
+        if (!sections[i].present)
+            remove_output_file(outputs[i]); /* no .ent/.ext, as a fresh build */
+
+        else if (!write_output_file(outputs[i], entry->text + sections[i].offset, sections[i].length))
+            return FALSE;
+    }
+    if (sections[CACHE_SECTION_LOG].present)
+        print_text(entry->text + sections[CACHE_SECTION_LOG].offset, sections[CACHE_SECTION_LOG].length);
+
+    utime(path, NULL); /* mark as recently used, for eviction */
+
+    return TRUE;
+}
+
+/*
+Function to store the results of a successful assembly into the cache.
+The entry is written to a temporary file & renamed, so concurrent assemblers never read a partial entry.
+Receives: const char *directory - Cache directory
+          const char *key - Key of the source (see build_cache_key)
+          int file_number - Index of file in the command line (makes the temporary file unique)
+          const char *outputs[] - Files written by the assembly (CACHE_SECTION_COUNT size), NULL if not written
+          const SourceBuffer *log - Messages printed while assembling
+          SourceBuffer *entry - Buffer the entry is built in
+          SourceBuffer *scratch - Buffer the output files are read back into
+*/
+void store_cache_entry(const char *directory, const char *key, int file_number, const char *outputs[], const SourceBuffer *log, SourceBuffer *entry, SourceBuffer *scratch) {
+    char path[MAX_CACHE_PATH_LENGTH], temp_path[MAX_CACHE_PATH_LENGTH];
+    char header[MAX_SECTION_HEADER_LENGTH], suffix[MAX_SECTION_HEADER_LENGTH];
+    int i;
+
+    reset_source_buffer(entry);
+    sprintf(header, "%s %s%c", CACHE_MAGIC, ASSEMBLER_VERSION, NEWLINE);
+
+    if (!append_source_text(entry, header) || !append_section(entry, CACHE_SECTION_LOG, log->text, log->length))
+        return;
+
+    for (i = CACHE_SECTION_AM; i < CACHE_SECTION_COUNT; i++) {
+        if (outputs[i] &&
+            (!read_input_file(scratch, outputs[i]) || !append_section(entry, i, scratch->text, scratch->length)))
+            return;
+    }
+    sprintf(suffix, ".%ld.%d%s", (long)getpid(), file_number, CACHE_TEMP_EXT);
+    build_entry_path(directory, key, "", path);
+    build_entry_path(directory, key, suffix, temp_path);
+
+    if (!write_text_file(temp_path, entry->text, entry->length))
+        return;
+
+    if (rename(temp_path, path) != 0) {
+        print_error("Failed to store cache entry", path);
+        remove(temp_path);
+    }
+}
+
+/*
+Function to bound the cache size, deleting least recently used entries until it fits.
+Receives: const char *directory - Cache directory
+          long max_size - Cache size limit in bytes
+Returns: int - Number of deleted entries
+*/
+int evict_cache_entries(const char *directory, long max_size) {
+    char path[MAX_CACHE_PATH_LENGTH];
+    CacheFile *files;
+    long total_size;
+    int i, evicted = 0;
+    int count = list_cache_files(directory, &files, &total_size);
+
+    if (count <= 0)
+        return 0;
+
+    qsort(files, count, sizeof(CacheFile), compare_last_used);
+
+    for (i = 0; (i < count) && (total_size > max_size); i++) {
+        sprintf(path, "%s/%s", directory, files[i].name);
+
+        if (remove(path) == 0) {
+            total_size -= files[i].size;
+            evicted++;
+        }
+    }
+    FREE(files);
+
+    return evicted;
+}
\ No newline at end of file
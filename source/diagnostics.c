@@ -0,0 +1,221 @@
+/* vsnprintf() is POSIX (and C99), not part of C90 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "arena.h"
+#include "diagnostics.h"
+#include "alloc_tracking.h"
+
+/*
+Per-thread log that messages are buffered into (unset: messages go to stdout),
+and per-thread list that diagnostics are also recorded into (unset: not recorded).
+*/
+static pthread_once_t keys_once = PTHREAD_ONCE_INIT;
+static pthread_key_t log_key, list_key;
+static int keys_created = FALSE;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to create the thread-specific log & list keys, run once per process.
+*/
+static void create_diagnostic_keys(void) {
+    keys_created = (pthread_key_create(&log_key, NULL) == 0) &&
+                   (pthread_key_create(&list_key, NULL) == 0);
+}
+
+/*
+Function to get the diagnostic list bound to the calling thread.
+Returns: DiagnosticList* - Bound list, NULL if diagnostics are not recorded
+*/
+static DiagnosticList *get_diagnostic_list(void) {
+    pthread_once(&keys_once, create_diagnostic_keys);
+
+    return keys_created ? pthread_getspecific(list_key) : NULL;
+}
+
+/*
+Function to make room for one more diagnostic in a list.
+Receives: DiagnosticList *list - List to grow
+Returns: int - TRUE if there is room, FALSE on memory error
+*/
+static int reserve_diagnostic(DiagnosticList *list) {
+    Diagnostic *new_items;
+    int new_capacity;
+
+    if (list->count < list->capacity)
+        return TRUE;
+
+    new_capacity = (list->capacity == 0) ? INITIAL_DIAGNOSTIC_CAPACITY : list->capacity * 2;
+    new_items = REALLOC(list->items, new_capacity * sizeof(Diagnostic), ALLOC_SITE_OTHER);
+
+    if (!new_items) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to record diagnostic");
+        return FALSE;
+    }
+    list->items = new_items;
+    list->capacity = new_capacity;
+
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to get the log bound to the calling thread.
+Returns: SourceBuffer* - Bound log, NULL if messages go to stdout
+*/
+SourceBuffer *get_diagnostic_log(void) {
+    pthread_once(&keys_once, create_diagnostic_keys);
+
+    return keys_created ? pthread_getspecific(log_key) : NULL;
+}
+
+/*
+Function to bind a log to the calling thread, so its messages are buffered instead of printed.
+Used by parallel assembly, so the diagnostics of different files never interleave.
+Receives: SourceBuffer *log - Log to append messages to, NULL to print to stdout again
+*/
+void set_diagnostic_log(SourceBuffer *log) {
+    pthread_once(&keys_once, create_diagnostic_keys);
+
+    if (keys_created)
+        pthread_setspecific(log_key, log);
+}
+
+/*
+Function to print a formatted message, to the calling thread's log if bound, or to stdout.
+A logged message longer than MAX_MESSAGE_LENGTH is truncated, keeping its line ending.
+Receives: const char *format - printf() style format string
+          ... - Format arguments
+*/
+void print_message(const char *format, ...) {
+    char message[MAX_MESSAGE_LENGTH];
+    SourceBuffer *log = get_diagnostic_log();
+    va_list args;
+    int length;
+
+    va_start(args, format);
+
+    if (!log) {
+        vprintf(format, args);
+        va_end(args);
+        return;
+    }
+    length = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (length < 0)
+        return;
+
+    if (length >= (int)sizeof(message)) {
+        length = sizeof(message) - 1;
+        message[length - 1] = NEWLINE;
+    }
+    print_text(message, length);
+}
+
+/*
+Function to print already formatted text as is (e.g. a replayed log), to the calling thread's log if bound, or to stdout.
+Receives: const char *text - Start of text (not necessarily null terminated)
+          size_t length - Length of text
+*/
+void print_text(const char *text, size_t length) {
+    SourceBuffer *log = get_diagnostic_log();
+
+    if (!log) {
+        fwrite(text, 1, length, stdout);
+        return;
+    }
+    /* Unbind while appending, so an allocation error is printed rather than logged recursively */
+    set_diagnostic_log(NULL);
+    append_source_span(log, text, length);
+    set_diagnostic_log(log);
+}
+
+/*
+Function to initialize a diagnostic list, before it is bound for the first time.
+Receives: DiagnosticList *list - List to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+int init_diagnostic_list(DiagnosticList *list) {
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+
+    return init_arena(&list->text, TEXT_ARENA_SIZE);
+}
+
+/*
+Function to empty a diagnostic list, keeping its allocations.
+Receives: DiagnosticList *list - List to reset
+*/
+void reset_diagnostic_list(DiagnosticList *list) {
+    list->count = 0;
+    reset_arena(&list->text);
+}
+
+/*
+Function to free a diagnostic list.
+Receives: DiagnosticList *list - List to free
+*/
+void free_diagnostic_list(DiagnosticList *list) {
+    FREE(list->items);
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    free_arena(&list->text);
+}
+
+/*
+Function to bind a diagnostic list to the calling thread, so reported errors & warnings are also recorded.
+Receives: DiagnosticList *list - List to record into, NULL to stop recording
+*/
+void set_diagnostic_list(DiagnosticList *list) {
+    pthread_once(&keys_once, create_diagnostic_keys);
+
+    if (keys_created)
+        pthread_setspecific(list_key, list);
+}
+
+/*
+Function to record a reported error / warning into the calling thread's diagnostic list, if one is bound.
+Receives: int severity - DIAGNOSTIC_ERROR / DIAGNOSTIC_WARNING
+          const char *message - Main message
+          const char *context - Additional context (optional)
+          int context_length - Length of context, -1 if null terminated
+          int line_num - Source line number, NO_LINE if not tied to a line
+*/
+void record_diagnostic(int severity, const char *message, const char *context, int context_length, int line_num) {
+    DiagnosticList *list = get_diagnostic_list();
+    Diagnostic *diagnostic;
+
+    if (!list)
+        return;
+
+    /* Unbind while recording, so an allocation error is printed rather than recorded recursively */
+    set_diagnostic_list(NULL);
+
+    if (reserve_diagnostic(list)) {
+        diagnostic = &list->items[list->count];
+        diagnostic->severity = severity;
+        diagnostic->line_num = line_num;
+        diagnostic->message = arena_copy_string(&list->text, message);
+        diagnostic->context = NULL;
+
+        if (context)
+            diagnostic->context = (context_length < 0) ? arena_copy_string(&list->text, context)
+                                                       : arena_copy_span(&list->text, context, context_length);
+
+        if (diagnostic->message && (!context || diagnostic->context))
+            list->count++;
+    }
+    set_diagnostic_list(list);
+}
\ No newline at end of file
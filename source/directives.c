@@ -9,22 +9,38 @@
 #include "symbol_table.h"
 #include "instructions.h"
 #include "directives.h"
+#include "keywords.h"
 
 /* Inner STATIC methods */
 /* ==================================================================== */
 /*
-Function validate a numeric token for .data directive.
-Receives: const char *token - String to validate as number
+Function validate a numeric token view for .data directive, parsing it in place.
+Accepts an optional sign followed by decimal digits only.
+Receives: const char *token - Start of token to validate as number
+          int length - Length of token
           int *value - Output parameter for parsed value
 Returns: int - TRUE if valid 10-bit signed integer (-512 to 511), FALSE otherwise
 */
-static int check_number(const char *token, int *value) {
-    char *endptr;
-    
-    *value = strtol(token, &endptr, BASE10_ENCODING);
+static int check_number(const char *token, int length, int *value) {
+    int i = 0, is_negative = FALSE, magnitude = 0;
 
-    if ((*endptr != NULL_TERMINATOR) || (*value < -512 || *value > 511)) {
-        print_error(".data value must be a decimal integer within the signed range (-512 to 511)", token);
+    if ((length > 0) && ((token[0] == '-') || (token[0] == '+'))) {
+        is_negative = (token[0] == '-');
+        i++;
+    }
+    if (i == length)
+        magnitude = -1; /* no digits */
+
+    for (; (i < length) && (magnitude >= 0); i++) {
+        if (!isdigit((unsigned char)token[i]))
+            magnitude = -1;
+        else if (magnitude <= MAX_DATA_MAGNITUDE) /* saturate, out of range anyway */
+            magnitude = magnitude * BASE10_ENCODING + (token[i] - '0');
+    }
+    *value = is_negative ? -magnitude : magnitude;
+
+    if ((magnitude < 0) || (*value < MIN_DATA_VALUE || *value > MAX_DATA_VALUE)) {
+        print_span_error(".data value must be a decimal integer within the signed range (-512 to 511)", token, length);
         return FALSE;
     }
     return TRUE;
@@ -53,23 +69,21 @@ Rules:
 - Requires at least one numeric value
 - Each value validated by check_number()
 - Stores using store_value()
-Receives: char **tokens - Tokenized directive line
-          int token_count - Number of tokens
-          SymbolTable *symtab - Symbol table (unused)
+Receives: const Operand *values - Directive values (after directive name)
+          int value_count - Number of values
           MemoryImage *memory - Memory image to store values
 Returns: int - TRUE if all values stored successfully, FALSE otherwise
 */
-static int process_data_directive(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory) {
+static int process_data_directive(const Operand *values, int value_count, MemoryImage *memory) {
     int i, value;
-    int start_index = 0;
 
-    if (token_count <= start_index + 1) {
+    if (value_count < 1) {
         print_error("Invalid .data directive: need at least one numeric value", NULL);
         return FALSE;
     }
 
-    for (i = start_index + 1; i < token_count; i++) {
-        if (!check_number(tokens[i], &value))
+    for (i = 0; i < value_count; i++) {
+        if (!check_number(values[i].text, values[i].length, &value))
             return FALSE;
 
         if (!store_value(memory, value))
@@ -80,23 +94,21 @@ static int process_data_directive(char **tokens, int token_count, SymbolTable *s
 
 /*
 Function to process .string directive - stores ASCII characters and null terminator.
-Receives: char **tokens - Tokenized directive line
-          int token_count - Number of tokens
-          SymbolTable *symtab - Symbol table (unused)
+Receives: const Operand *values - Directive values (after directive name)
+          int value_count - Number of values
           MemoryImage *memory - Memory image to store string
 Returns: int - TRUE if string stored successfully, FALSE otherwise
 */
-static int process_string_directive(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory) {
+static int process_string_directive(const Operand *values, int value_count, MemoryImage *memory) {
     char *str;
     int i;
-    int start_index = 0;
     size_t length;
 
-    if (token_count != start_index + 2) {
+    if (value_count != 1) {
         print_error("Invalid .string directive: need exactly one string literal", NULL);
         return FALSE;
     }
-    str = tokens[start_index + 1];
+    str = values[0].text;
 
     if (!check_string(str))
         return FALSE;
@@ -137,35 +149,28 @@ Function to Processes .mat directive - stores matrix values in row-major order.
 Rules:
 - Requires dimensions and exact number of values (rows*cols)
 - Each value validated by check_number()
-Receives: char **tokens - Tokenized directive line
-          int token_count - Number of tokens
-          SymbolTable *symtab - Symbol table (unused)
+Receives: const Operand *values - Directive values (dimensions first)
+          int value_count - Number of values
           MemoryImage *memory - Memory image to store matrix
 Returns: int - TRUE if matrix stored successfully, FALSE otherwise
 */
-static int process_mat_directive(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory) {
-    char *matrix_def;
-    int rows, cols, i, value, token_index;
-    int start_index = 0;
+static int process_mat_directive(const Operand *values, int value_count, MemoryImage *memory) {
+    int rows, cols, i, value;
 
-    if (token_count <= start_index + 2) {
+    if (value_count < 2) {
         print_error("Invalid .mat directive: need dimensions and at least one numeric value", NULL);
         return FALSE;
     }
-    matrix_def = tokens[start_index + 1];
-
-    if (!parse_matrix_dimensions(matrix_def, &rows, &cols))
+    if (!parse_matrix_dimensions(values[0].text, &rows, &cols))
         return FALSE;
 
-    if (token_count != start_index + 2 + (rows * cols)) {
+    if (value_count != 1 + (rows * cols)) {
         print_error("Matrix dimensions don't match the number of provided values", NULL);
         return FALSE;
     }
 
-    for (i = 0; i < rows * cols; i++) {
-        token_index = start_index + 2 + i;
-
-        if (!check_number(tokens[token_index], &value))
+    for (i = 1; i <= rows * cols; i++) {
+        if (!check_number(values[i].text, values[i].length, &value))
             return FALSE;
 
         if (!store_value(memory, value))
@@ -175,90 +180,86 @@ static int process_mat_directive(char **tokens, int token_count, SymbolTable *sy
 }
 
 /*
-Function to process .entry directive - marks symbol as entry.
-Receives: char **tokens - Tokenized directive line
-          int token_count - Number of tokens
-          SymbolTable *symtab - Symbol table to modify
-Returns: int - TRUE if symbol exists and marked, FALSE otherwisde
+Function to validate .entry directive, the label itself is marked as entry
+by the second pass, once all labels are known.
+Receives: int value_count - Number of values
+Returns: int - TRUE if declaration is valid, FALSE otherwise
 */
-static int process_entry_directive(char **tokens, int token_count, SymbolTable *symtab) {
-    Symbol *symbol_ptr;
-
-    if (token_count != 2) {
+static int process_entry_directive(int value_count) {
+    if (value_count != 1) {
         print_error("Invalid .entry directive: need exactly one label", NULL);
         return FALSE;
     }
-    symbol_ptr = find_symbol(symtab, tokens[1]);
-
-    if (symbol_ptr) {
-        symbol_ptr->is_entry = TRUE;
-        return TRUE;
-    }
-    return FALSE;
+    return TRUE;
 }
 
 /*
 Function to process .extern directive - declares external symbol.
-Receives: char **tokens - Tokenized directive line
-          int token_count - Number of tokens
+Receives: const Operand *values - Directive values (after directive name)
+          int value_count - Number of values
           SymbolTable *symtab - Symbol table to modify
 Returns: int - TRUE if symbol added successfully, FALSE otherwise
 */
-static int process_extern_directive(char **tokens, int token_count, SymbolTable *symtab) {
-    int start_index = 0;
-
-    if (token_count != start_index + 2) {
+static int process_extern_directive(const Operand *values, int value_count, SymbolTable *symtab) {
+    if (value_count != 1) {
         print_error("Invalid .extern directive: need exactly one label", NULL);
         return FALSE;
     }
-    return add_symbol(symtab, tokens[start_index + 1], 0, EXTERNAL_SYMBOL);
+    return add_symbol(symtab, values[0].text, 0, EXTERNAL_SYMBOL);
 }
 
 /* Outer methods */
 /* ==================================================================== */
+/*
+Function to find a directive ID by name span (case-sensitive, with '.' prefix), through the keywords hash.
+Receives: const char *name - Start of directive token (not necessarily null terminated)
+          size_t length - Length of directive token
+Returns: int - DIRECTIVE_* ID, NO_DIRECTIVE if not found
+*/
+int get_directive_span(const char *name, size_t length) {
+    const Keyword *keyword = find_keyword_span(name, length);
+
+    if (!keyword || (keyword->keyword_class != KEYWORD_DIRECTIVE))
+        return NO_DIRECTIVE;
+
+    return keyword->id;
+}
+
+/*
+Function to find a directive ID by name (case-sensitive, with '.' prefix).
+Receives: const char *name - Directive token
+Returns: int - DIRECTIVE_* ID, NO_DIRECTIVE if not found
+*/
+int get_directive(const char *name) {
+    return get_directive_span(name, strlen(name));
+}
+
 /*
 Function to route to the relevant directive handling.
 Handles:
-- .data/.string/.mat in first pass only
-- .entry in second pass only
-- .extern in first pass only
-Receives: char **tokens - Tokenized directive line
-          int token_count - Number of tokens
+- .data/.string/.mat by storing values in data segment
+- .entry by validating it (resolved by second pass)
+- .extern by adding an external symbol
+Receives: int directive - DIRECTIVE_* ID
+          const Operand *values - Directive values (after directive name)
+          int value_count - Number of values
           SymbolTable *symtab - Symbol table for symbol operations
           MemoryImage *memory - Memory image for data storage
-          int is_second_pass - Assembly phase flag
 Returns: int - TRUE if directive processed successfully, FALSE otherwise
 */
-int process_directive(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int is_second_pass) {
-    if (strcmp(tokens[0], DATA_DIRECTIVE) == 0) {
-        if (is_second_pass)
-            return TRUE;
-
-        return process_data_directive(tokens, token_count, symtab, memory);
-    }
-    else if (strcmp(tokens[0], STRING_DIRECTIVE) == 0) {
-        if (is_second_pass)
-            return TRUE;
-
-        return process_string_directive(tokens, token_count, symtab, memory);
-    }
-    else if (strcmp(tokens[0], MATRIX_DIRECTIVE) == 0) {
-        if (is_second_pass)
-            return TRUE;
-
-        return process_mat_directive(tokens, token_count, symtab, memory);
-    }
-    else if (strcmp(tokens[0], ENTRY_DIRECTIVE) == 0) {
-        if (!is_second_pass)
-            return TRUE;
-
-        return process_entry_directive(tokens, token_count, symtab);
-    }
-    else if (strcmp(tokens[0], EXTERN_DIRECTIVE) == 0) {
-        if (is_second_pass)
-            return TRUE;
-
-        return process_extern_directive(tokens, token_count, symtab);
+int process_directive(int directive, const Operand *values, int value_count, SymbolTable *symtab, MemoryImage *memory) {
+    switch (directive) {
+        case DIRECTIVE_DATA:
+            return process_data_directive(values, value_count, memory);
+        case DIRECTIVE_STRING:
+            return process_string_directive(values, value_count, memory);
+        case DIRECTIVE_MATRIX:
+            return process_mat_directive(values, value_count, memory);
+        case DIRECTIVE_ENTRY:
+            return process_entry_directive(value_count);
+        case DIRECTIVE_EXTERN:
+            return process_extern_directive(values, value_count, symtab);
+        default:
+            return FALSE;
     }
-    return FALSE;
 }
\ No newline at end of file
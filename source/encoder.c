@@ -8,6 +8,7 @@
 #include "memory.h"
 #include "symbol_table.h"
 #include "instructions.h"
+#include "fixup_table.h"
 #include "encoder.h"
 
 /* Inner STATIC methods */
@@ -17,7 +18,7 @@ Function to reset all bits in a memory word to 0.
 Receives: MemoryWord *word - Pointer to memory word to clear
 */
 static void clear_bits(MemoryWord *word) {
-    word->raw = 0;
+    *word = 0;
 }
 
 /*
@@ -35,8 +36,7 @@ static int encode_immediate_operand(const char *operand, MemoryWord *word) {
         print_error("# value must be a decimal integer within the signed range (-128 to 127)", operand);
         return FALSE;
     }
-    word->operand.value = value;
-    word->operand.are = ARE_ABSOLUTE;
+    *word = PACK_OPERAND_WORD(value, ARE_ABSOLUTE);
 
     return TRUE;
 }
@@ -54,36 +54,26 @@ static int encode_register_operand(const char *operand, MemoryWord *word) {
         print_error("Register is outside the natural number range (0 to 7)", operand);
         return FALSE;
     }
-    word->operand.value = reg;
-    word->operand.are = ARE_ABSOLUTE;
+    *word = PACK_OPERAND_WORD(reg, ARE_ABSOLUTE);
 
     return TRUE;
 }
 
 /*
-Function to encode a symbol / label operand, handles both external and relocatable symbols.
-Receives: const char *operand - The symbol name
-          SymbolTable *symtab - Pointer to symbol table
+Function to leave a symbol / label operand word empty, and record it for patching
+once all label addresses are known (see encode_symbol_operand).
+Receives: const char *operand - Start of the symbol name, inside statement text
+          int length - Length of the symbol name
+          FixupTable *fixups - Pointer to fixup table
+          int address - Memory address the operand word will be stored at
+          int line_num - Source line number for error reporting
           MemoryWord *word - Pointer to memory word for storage
-Returns: int - TRUE if encoding succeeded, FALSE if symbol not found
+Returns: int - TRUE if reference was recorded, FALSE on memory error
 */
-static int encode_symbol_operand(const char *operand, SymbolTable *symtab, MemoryWord *word) {
-    Symbol *sym = find_symbol(symtab, operand);
-    
-    if (!sym) {
-        print_error("Symbol not found", operand);
-        return FALSE;
-    }
-    if (sym->type == EXTERNAL_SYMBOL) {
-        word->operand.value = 0;
-        word->operand.are = ARE_EXTERNAL;
-        word->operand.ext_symbol_index = (int)(sym - symtab->symbols);
-    } else {
-        word->operand.value = sym->value & WORD_MASK;
-        word->operand.are = ARE_RELOCATABLE;
-        word->operand.ext_symbol_index = -1;
-    }
-    return TRUE;
+static int defer_symbol_operand(const char *operand, int length, FixupTable *fixups, int address, int line_num, MemoryWord *word) {
+    *word = PACK_OPERAND_WORD(0, ARE_ABSOLUTE);
+
+    return add_fixup(fixups, operand, length, address, line_num);
 }
 
 /*
@@ -184,79 +174,67 @@ static int parse_matrix_operand(const char *operand, int *base_reg, int *index_r
 /*
 Function to encode a matrix operand, uses 2 memory words: 1 for label, 1 for registers.
 Receives: const char *operand - Full matrix operand string
-          SymbolTable *symtab - Pointer to symbol table
+          FixupTable *fixups - Pointer to fixup table
+          int address - Memory address of the first (label) word
+          int line_num - Source line number for error reporting
           MemoryWord *word - First memory word for label
           MemoryWord *next_word - Second memory word for registers
 Returns: int - TRUE if encoding succeeded, FALSE otherwise
 */
-static int encode_matrix_operand(const char *operand, SymbolTable *symtab, MemoryWord *word, MemoryWord *next_word) {
-    char label[MAX_LABEL_NAME_LENGTH];
-    char *bracket = strchr(operand, LEFT_BRACKET);
+static int encode_matrix_operand(const char *operand, FixupTable *fixups, int address, int line_num, MemoryWord *word, MemoryWord *next_word) {
+    const char *bracket = strchr(operand, LEFT_BRACKET);
     int base_reg, index_reg;
 
     if (!next_word) {
         print_error(ERR_INVALID_MATRIX, "Matrix addressing requires a second word for registers");
         return FALSE;
     }
-    /* Extract label part (e.g., "M1" from "M1[r2][r7]") */
+    /* Label part is the span before the brackets (e.g., "M1" of "M1[r2][r7]") */
     if (!bracket || (bracket - operand >= MAX_LABEL_NAME_LENGTH)) {
         print_error(ERR_INVALID_MATRIX, "Invalid label part in matrix addressing");
         return FALSE;
     }
-    strncpy(label, operand, bracket - operand);
-    label[bracket - operand] = NULL_TERMINATOR;
-
     /* Parse matrix registers (e.g., r2, r7) */
     if (!parse_matrix_operand(operand, &base_reg, &index_reg))
         return FALSE;
 
     /* Encode the label part (first word of matrix operand) */
-    if (!encode_symbol_operand(label, symtab, word))
+    if (!defer_symbol_operand(operand, (int)(bracket - operand), fixups, address, line_num, word))
         return FALSE;
 
-    clear_bits(next_word);
-    next_word->reg.reg_src = base_reg;
-    next_word->reg.reg_dst = index_reg;
-    next_word->reg.are = ARE_ABSOLUTE; /* Register word is always absolute */
+    *next_word = PACK_REG_WORD(base_reg, index_reg); /* Register word is always absolute */
 
     return TRUE;
 }
 
 /*
-Function to route to specific encoder based on operand type.
+Function to route to specific encoder based on operand addressing mode (computed at parse time).
 Handles immediate, register, matrix, and symbol operands.
-Receives: const char *operand - The operand string to encode
-          SymbolTable *symtab - Pointer to symbol table
+Receives: const Operand *operand - The parsed operand to encode
+          FixupTable *fixups - Pointer to fixup table
+          int address - Memory address the primary word will be stored at
+          int line_num - Source line number for error reporting
           MemoryWord *word - Primary memory word for storage
           int is_dest - Flag indicating if this is a destination operand
           MemoryWord *next_word - Secondary memory word (for matrix)
 Returns: int - TRUE if encoding succeeded, FALSE otherwise
 */
-static int encode_operand(const char *operand, SymbolTable *symtab, MemoryWord *word, int is_dest, MemoryWord *next_word) {
+static int encode_operand(const Operand *operand, FixupTable *fixups, int address, int line_num, MemoryWord *word, int is_dest, MemoryWord *next_word) {
     clear_bits(word);
-    word->operand.ext_symbol_index = -1;
 
-    if (next_word) {
+    if (next_word)
         clear_bits(next_word);
-        next_word->operand.ext_symbol_index = -1;
-    }
 
-    if (operand[0] == IMMEDIATE_PREFIX) { /* Immediate value (#num) */
-        if (!encode_immediate_operand(operand, word)) 
-            return FALSE;
-    }
-    else if (IS_REGISTER(operand)) { /* Register (r0-r7) */
-        if (!encode_register_operand(operand, word)) 
-            return FALSE;
+    switch (operand->mode) {
+        case ADDR_MODE_IMMEDIATE: /* Immediate value (#num) */
+            return encode_immediate_operand(operand->text, word);
+        case ADDR_MODE_REGISTER: /* Register (r0-r7) */
+            return encode_register_operand(operand->text, word);
+        case ADDR_MODE_MATRIX: /* Matrix access (label[rX][rY]) */
+            return encode_matrix_operand(operand->text, fixups, address, line_num, word, next_word);
+        default: /* Symbol/label (direct addressing) */
+            return defer_symbol_operand(operand->text, operand->length, fixups, address, line_num, word);
     }
-    else if (strchr(operand, LEFT_BRACKET)) { /* Matrix access (label[rX][rY]) */
-        if (!encode_matrix_operand(operand, symtab, word, next_word)) 
-            return FALSE;
-    }
-    else if (!encode_symbol_operand(operand, symtab, word)) /* Symbol/label (direct addressing) */
-        return FALSE;
-
-    return TRUE;
 }
 
 /*
@@ -268,13 +246,10 @@ Receives: MemoryImage *memory - Pointer to memory image
 Returns: int - TRUE if storage succeeded, FALSE on IC limit
 */
 static int store_operand_word(MemoryImage *memory, int *current_ic_ptr, MemoryWord operand_word) {
-    int addr_index;
-
     if (!check_ic_limit(*current_ic_ptr + 1))
         return FALSE;
 
-    addr_index = IC_START + (*current_ic_ptr);
-    memory->words[addr_index] = operand_word;
+    memory->code[*current_ic_ptr] = operand_word;
     (*current_ic_ptr)++;
 
     return TRUE;
@@ -290,20 +265,14 @@ Receives: MemoryImage *memory - Pointer to memory image
 Returns: int - TRUE if storage succeeded, FALSE on IC limit
 */
 static int store_register_word(MemoryImage *memory, int *current_ic_ptr, int reg_value, int shift) {
-    MemoryWord *target_word;
-
     if (!check_ic_limit(*current_ic_ptr + 1))
         return FALSE;
 
-    target_word = &memory->words[IC_START + (*current_ic_ptr)];
-    clear_bits(target_word);
-
     if (shift == REG_SRC_SHIFT)
-        target_word->reg.reg_src = reg_value;
-    else if (shift == REG_DST_SHIFT)
-        target_word->reg.reg_dst = reg_value;
+        memory->code[*current_ic_ptr] = PACK_REG_WORD(reg_value, 0);
+    else
+        memory->code[*current_ic_ptr] = PACK_REG_WORD(0, reg_value);
 
-    target_word->reg.are = ARE_ABSOLUTE;
     (*current_ic_ptr)++;
 
     return TRUE;
@@ -319,17 +288,10 @@ Receives: MemoryImage *memory - Pointer to memory image
 Returns: int - TRUE if storage succeeded, FALSE on IC limit
 */
 static int store_two_registers(MemoryImage *memory, int *current_ic_ptr, MemoryWord src_word, MemoryWord dest_word) {
-    MemoryWord *target_word;
-
     if (!check_ic_limit(*current_ic_ptr + 1))
         return FALSE;
 
-    target_word = &memory->words[IC_START + (*current_ic_ptr)];
-    clear_bits(target_word);
-
-    target_word->reg.reg_src = src_word.operand.value;
-    target_word->reg.reg_dst = dest_word.operand.value;
-    target_word->reg.are = ARE_ABSOLUTE;    
+    memory->code[*current_ic_ptr] = PACK_REG_WORD(OPERAND_VALUE(src_word), OPERAND_VALUE(dest_word));
     (*current_ic_ptr)++;
 
     return TRUE;
@@ -348,7 +310,7 @@ Returns: int - TRUE if storage succeeded, FALSE otherwise
 */
 static int process_operand_storage(MemoryImage *memory, int *current_ic_ptr, int mode, MemoryWord operand_word, MemoryWord next_word, int reg_shift) {
     if (mode == ADDR_MODE_REGISTER)
-        return store_register_word(memory, current_ic_ptr, operand_word.operand.value, reg_shift);
+        return store_register_word(memory, current_ic_ptr, OPERAND_VALUE(operand_word), reg_shift);
     else {
         if (!store_operand_word(memory, current_ic_ptr, operand_word))
             return FALSE;
@@ -362,119 +324,89 @@ static int process_operand_storage(MemoryImage *memory, int *current_ic_ptr, int
 /*
 Function to encode a single operand instruction.
 Receives: const Instruction *inst - Instruction definition
-          char **operands - Array of operand strings
-          int operand_start - Index of first operand
-          SymbolTable *symtab - Pointer to symbol table
+          const Operand *operands - Array of parsed operands
+          FixupTable *fixups - Pointer to fixup table
           MemoryImage *memory - Pointer to memory image
           int *current_ic_ptr - Pointer to current IC value
           MemoryWord *instruction_word - Pointer to instruction word
+          int line_num - Source line number for error reporting
 Returns: int - TRUE if encoding succeeded, FALSE otherwise
 */
-static int encode_one_operand(const Instruction *inst, char **operands, int operand_start, SymbolTable *symtab, MemoryImage *memory, int *current_ic_ptr, MemoryWord *instruction_word) {
+static int encode_one_operand(const Instruction *inst, const Operand *operands, FixupTable *fixups, MemoryImage *memory, int *current_ic_ptr, MemoryWord *instruction_word, int line_num) {
     int src_mode;
-    MemoryWord operand_word, next_operand_word;
-    operand_word.raw = 0;
-    next_operand_word.raw = 0;
+    MemoryWord operand_word = 0, next_operand_word = 0;
 
-    if (!encode_operand(operands[operand_start], symtab, &operand_word, FALSE, &next_operand_word))
+    if (!encode_operand(&operands[0], fixups, IC_START + *current_ic_ptr, line_num, &operand_word, FALSE, &next_operand_word))
         return FALSE;
 
-    src_mode = get_addressing_mode(operands[operand_start]);
+    src_mode = operands[0].mode;
 
-    instruction_word->instr.dest = src_mode;
-    instruction_word->instr.src = 0;
+    *instruction_word = PACK_INSTR_WORD(inst->opcode, 0, src_mode);
 
     return process_operand_storage(memory, current_ic_ptr, src_mode, operand_word, next_operand_word, 2);
 }
 
 /*
 Function to encode a 2 operand instruction, handles special case of two registers in one word.
+Each operand is encoded right before it is stored, so its final address is known for fixups.
 Receives: const Instruction *inst - Instruction definition
-          char **operands - Array of operand strings
-          int operand_start - Index of first operand
-          SymbolTable *symtab - Pointer to symbol table
+          const Operand *operands - Array of parsed operands
+          FixupTable *fixups - Pointer to fixup table
           MemoryImage *memory - Pointer to memory image
           int *current_ic_ptr - Pointer to current IC value
           MemoryWord *instruction_word - Pointer to instruction word
+          int line_num - Source line number for error reporting
 Returns: int - TRUE if encoding succeeded, FALSE otherwise
 */
-static int encode_two_operands(const Instruction *inst, char **operands, int operand_start, SymbolTable *symtab, MemoryImage *memory, int *current_ic_ptr, MemoryWord *instruction_word) {
+static int encode_two_operands(const Instruction *inst, const Operand *operands, FixupTable *fixups, MemoryImage *memory, int *current_ic_ptr, MemoryWord *instruction_word, int line_num) {
     int src_mode, dest_mode;
-    MemoryWord src_operand_word, src_next_operand_word, dest_operand_word, dest_next_operand_word;
-
-    src_operand_word.raw = 0;
-    src_next_operand_word.raw = 0;
-    dest_operand_word.raw = 0;
-    dest_next_operand_word.raw = 0;
+    MemoryWord src_operand_word = 0, src_next_operand_word = 0, dest_operand_word = 0, dest_next_operand_word = 0;
 
-    /* Encode source operand */
-    if (!encode_operand(operands[operand_start], symtab, &src_operand_word, FALSE, &src_next_operand_word))
-        return FALSE;
-
-    src_mode = get_addressing_mode(operands[operand_start]);
-    instruction_word->instr.src = src_mode;
-
-    /* Encode destination operand */
-    if (!encode_operand(operands[operand_start + 1], symtab, &dest_operand_word, TRUE, &dest_next_operand_word))
-        return FALSE;
+    src_mode = operands[0].mode;
+    dest_mode = operands[1].mode;
 
-    dest_mode = get_addressing_mode(operands[operand_start + 1]);
-    instruction_word->instr.dest = dest_mode; /* Set destination addressing mode in instruction word */
+    *instruction_word = PACK_INSTR_WORD(inst->opcode, src_mode, dest_mode); /* Set addressing modes in instruction word */
 
     /* Two-register optimization: if both source and destination are registers, they share one word */
     if ((src_mode == ADDR_MODE_REGISTER) &&
-        (dest_mode == ADDR_MODE_REGISTER))
-        return store_two_registers(memory, current_ic_ptr, src_operand_word, dest_operand_word);
-    else {
-        /* Store source operand */
-        if (!process_operand_storage(memory, current_ic_ptr, src_mode, src_operand_word, src_next_operand_word, REG_SRC_SHIFT))
+        (dest_mode == ADDR_MODE_REGISTER)) {
+        if (!encode_operand(&operands[0], fixups, IC_START + *current_ic_ptr, line_num, &src_operand_word, FALSE, &src_next_operand_word))
             return FALSE;
 
-        /* Store destination operand */
-        return process_operand_storage(memory, current_ic_ptr, dest_mode, dest_operand_word, dest_next_operand_word, REG_DST_SHIFT);
-    }
-}
+        if (!encode_operand(&operands[1], fixups, IC_START + *current_ic_ptr, line_num, &dest_operand_word, TRUE, &dest_next_operand_word))
+            return FALSE;
 
-/* Outer methods */
-/* ==================================================================== */
-/*
-Function to parse operands from tokenized line, determines operand start index and count.
-Receives: char **tokens - Array of tokens from line
-          int token_count - Total number of tokens
-          int *operand_start_index - Output for operand start index
-          int *operand_count - Output for number of operands
-Returns: int - Always TRUE (validation done elsewhere)
-*/
-int parse_operands(char **tokens, int token_count, int *operand_start_index, int *operand_count) {
-    int i;
-    *operand_start_index = 0;
+        return store_two_registers(memory, current_ic_ptr, src_operand_word, dest_operand_word);
+    }
+    /* Encode & store source operand */
+    if (!encode_operand(&operands[0], fixups, IC_START + *current_ic_ptr, line_num, &src_operand_word, FALSE, &src_next_operand_word))
+        return FALSE;
 
-    if (is_first_token_label(tokens, token_count))
-        *operand_start_index = 2; /* Skip label and instruction name */
-    else
-        *operand_start_index = 1; /* Skip only instruction name */
+    if (!process_operand_storage(memory, current_ic_ptr, src_mode, src_operand_word, src_next_operand_word, REG_SRC_SHIFT))
+        return FALSE;
 
-    *operand_count = 0;
+    /* Encode & store destination operand */
+    if (!encode_operand(&operands[1], fixups, IC_START + *current_ic_ptr, line_num, &dest_operand_word, TRUE, &dest_next_operand_word))
+        return FALSE;
 
-    for (i = *operand_start_index; i < token_count; i++) {
-        (*operand_count)++;
-    }
-    return TRUE;
+    return process_operand_storage(memory, current_ic_ptr, dest_mode, dest_operand_word, dest_next_operand_word, REG_DST_SHIFT);
 }
 
+/* Outer methods */
+/* ==================================================================== */
 /*
 Function to validate operands against instruction requirements.
 Checks addressing modes and operand count.
 Receives: const Instruction *inst - Instruction definition
-          char **operands - Array of operand strings
+          const Operand *operands - Array of parsed operands
           int operand_count - Number of operands
 Returns: int - TRUE if operands are valid, FALSE otherwise
 */
-int check_operands(const Instruction *inst, char **operands, int operand_count) {
+int check_operands(const Instruction *inst, const Operand *operands, int operand_count) {
     int i, addr_mode_flag, legal_modes;
 
     for (i = 0; i < operand_count; i++) {
-        addr_mode_flag = get_addressing_mode(operands[i]);
+        addr_mode_flag = operands[i].mode;
 
         switch (inst->num_operands) {
             case TWO_OPERANDS:
@@ -491,7 +423,7 @@ int check_operands(const Instruction *inst, char **operands, int operand_count)
         }
         /* Check if the operand's addressing mode is allowed */
         if (!(legal_modes & (1 << addr_mode_flag))) {
-            print_error("Invalid addressing mode for instruction operand", operands[i]);
+            print_error("Invalid addressing mode for instruction operand", operands[i].text);
             return FALSE;
         }
     }
@@ -510,37 +442,66 @@ int encode_instruction_word(const Instruction *inst, MemoryImage *memory, int *c
     if (!check_ic_limit(*current_ic_ptr + 1))
         return FALSE;
 
-    *current_word_ptr = &memory->words[IC_START + *current_ic_ptr];
+    *current_word_ptr = &memory->code[*current_ic_ptr];
     (*current_ic_ptr)++;
 
-    clear_bits(*current_word_ptr);
-    (*current_word_ptr)->instr.opcode = inst->opcode;
-    (*current_word_ptr)->instr.are = ARE_ABSOLUTE;
+    **current_word_ptr = PACK_INSTR_WORD(inst->opcode, 0, 0);
 
     return TRUE;
 }
 
 /*
 Function to route to appropriate encoder based on operand count.
+Symbol operands are left empty and recorded in the fixup table.
 Receives: const Instruction *inst - Instruction definition
-          char **operands - Array of operand strings
-          int operand_start - Index of first operand
+          const Operand *operands - Array of parsed operands
           int operand_count - Number of operands
-          SymbolTable *symtab - Pointer to symbol table
+          FixupTable *fixups - Pointer to fixup table
           MemoryImage *memory - Pointer to memory image
           int *current_ic_ptr - Pointer to current IC value
           MemoryWord *instruction_word - Pointer to instruction word
+          int line_num - Source line number for error reporting
 Returns: int - TRUE if encoding succeeded, FALSE otherwise
 */
-int encode_operands(const Instruction *inst, char **operands, int operand_start, int operand_count, SymbolTable *symtab, MemoryImage *memory, int *current_ic_ptr, MemoryWord *instruction_word) {
+int encode_operands(const Instruction *inst, const Operand *operands, int operand_count, FixupTable *fixups, MemoryImage *memory, int *current_ic_ptr, MemoryWord *instruction_word, int line_num) {
     if (inst->num_operands == NO_OPERANDS) 
         return TRUE;
 
     if (inst->num_operands == ONE_OPERAND)
-        return encode_one_operand(inst, operands, operand_start, symtab, memory, current_ic_ptr, instruction_word);
+        return encode_one_operand(inst, operands, fixups, memory, current_ic_ptr, instruction_word, line_num);
 
     else if (inst->num_operands == TWO_OPERANDS)
-        return encode_two_operands(inst, operands, operand_start, symtab, memory, current_ic_ptr, instruction_word);
+        return encode_two_operands(inst, operands, fixups, memory, current_ic_ptr, instruction_word, line_num);
 
     return FALSE;
+}
+
+/*
+Function to encode a symbol / label operand, handles both external and relocatable symbols.
+Used when patching fixups, after all label addresses are final.
+The operand word is also recorded in the relocation list of the memory image.
+Receives: const char *operand - Start of the symbol name (not necessarily null terminated)
+          int length - Length of the symbol name
+          SymbolTable *symtab - Pointer to symbol table
+          MemoryImage *memory - Pointer to memory image
+          int address - Absolute address of the operand word
+Returns: int - TRUE if encoding succeeded, FALSE if symbol not found
+*/
+int encode_symbol_operand(const char *operand, int length, SymbolTable *symtab, MemoryImage *memory, int address) {
+    Symbol *sym = find_symbol_span(symtab, operand, length);
+    int are;
+    
+    if (!sym) {
+        print_span_error("Symbol not found", operand, length);
+        return FALSE;
+    }
+    if (sym->type == EXTERNAL_SYMBOL) {
+        are = ARE_EXTERNAL;
+        CODE_WORD(memory, address) = PACK_OPERAND_WORD(0, ARE_EXTERNAL);
+    } else {
+        are = ARE_RELOCATABLE;
+        CODE_WORD(memory, address) = PACK_OPERAND_WORD(sym->value, ARE_RELOCATABLE);
+    }
+    add_relocation(memory, address, are, (int)(sym - symtab->symbols));
+    return TRUE;
 }
\ No newline at end of file
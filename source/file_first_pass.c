@@ -10,145 +10,166 @@
 #include "instructions.h"
 #include "directives.h"
 #include "symbol_table.h"
-#include "line_process.h"
+#include "fixup_table.h"
+#include "encoder.h"
+#include "statement.h"
 #include "file_io.h"
+#include "diagnostics.h"
 
 /* Inner STATIC methods */
 /* ==================================================================== */
 /*
-Function to process a single instruction line during first pass.
-Handles labels, validates instruction, and updates instruction counter.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
+Function to add the label defined by a statement to the symbol table.
+Receives: const Statement *statement - Statement with a label
           SymbolTable *symtab - Pointer to the symbol table
-          MemoryImage *memory - Pointer to memory image tracking counters
-          int line_num - Current line number for error reporting
-Returns: int - TRUE if processing succeeded, FALSE on error
+          int address - Address (IC or DC) to assign to the label
+          int symbol_type - CODE_SYMBOL / DATA_SYMBOL
+Returns: int - TRUE if label was added, FALSE on error
 */
-static int process_instruction_line(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int line_num) {
-    char **operands;
-    int inst_index, operand_count, inst_length;
-    const Instruction *inst;
+static int define_label(const Statement *statement, SymbolTable *symtab, int address, int symbol_type) {
+    char label[MAX_LINE_LENGTH];
 
-    inst_index = is_first_token_label(tokens, token_count) ? 1 : 0;
+    bounded_string_copy(label, statement->label, MAX_LINE_LENGTH, NULL);
 
-    if ((inst_index == 1) &&
-        (!process_label(tokens[0], symtab, IC_START + memory->ic, CODE_SYMBOL))) {
-        print_line_error("Failed to process label", tokens[0], line_num);
+    if (!process_label(label, symtab, address, symbol_type)) {
+        print_line_error("Failed to process label", label, statement->line_num);
         return FALSE;
     }
-    inst = get_instruction(tokens[inst_index]);
+    return TRUE;
+}
 
-    if (!inst) {
-        print_line_error("Unknown instruction", tokens[inst_index], line_num);
+/*
+Function to encode an instruction into memory, at the current instruction counter.
+Handles opcode, addressing modes, and operand encoding.
+Symbol operands are left for the second pass, via the fixup table.
+Receives: const Instruction *inst - Pointer to instruction definition
+          const Operand *operands - Array of parsed operands
+          int operand_count - Number of operands in the array
+          FixupTable *fixups - Pointer to fixup table
+          MemoryImage *memory - Pointer to memory image
+          int line_num - Current line number for error reporting
+Returns: int - TRUE if encoding succeeded, FALSE on error
+*/
+static int encode_instruction(const Instruction *inst, const Operand *operands, int operand_count, FixupTable *fixups, MemoryImage *memory, int line_num) {
+    int current_ic = memory->ic;
+    MemoryWord *instruction_word;
+
+    if (!check_operands(inst, operands, operand_count)) 
         return FALSE;
-    }
-    operands = tokens + inst_index + 1;
-    operand_count = token_count - (inst_index + 1);
-    inst_length = calculate_instruction_length(inst, operands, operand_count);
 
-    if (inst_length == -1) {
-        print_line_error("Invalid instruction length", inst->name, line_num);
+    if (!encode_instruction_word(inst, memory, &current_ic, &instruction_word))
         return FALSE;
-    }
-    if (!check_ic_limit(memory->ic + inst_length))
+
+    if (!encode_operands(inst, operands, operand_count, fixups, memory, &current_ic, instruction_word, line_num))
         return FALSE;
 
-    memory->ic += inst_length;
+    memory->ic = current_ic;
     return TRUE;
 }
 
 /*
-Function to process a single directive line during first pass.
-Handles labels and delegates to specific directive processors.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
+Function to process a single instruction statement during first pass.
+Handles labels, validates instruction, encodes it and updates instruction counter.
+Receives: const StatementTable *statements - Table owning the statement
+          const Statement *statement - Instruction statement to process
           SymbolTable *symtab - Pointer to the symbol table
           MemoryImage *memory - Pointer to memory image tracking counters
-          int line_num - Current line number for error reporting
+          FixupTable *fixups - Pointer to fixup table
 Returns: int - TRUE if processing succeeded, FALSE on error
 */
-static int process_directive_line(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int line_num) {
-    const char *directive_name;
-    int direct_index;
+static int process_instruction_statement(const StatementTable *statements, const Statement *statement, SymbolTable *symtab, MemoryImage *memory, FixupTable *fixups) {
+    const Operand *operands = STATEMENT_OPERANDS(statements, statement);
+    const Instruction *inst = statement->inst;
+    int inst_length;
 
-    direct_index = is_first_token_label(tokens, token_count) ? 1 : 0;
+    if (HAS_LABEL(statement) &&
+        !define_label(statement, symtab, IC_START + memory->ic, CODE_SYMBOL))
+        return FALSE;
 
-    if (direct_index >= token_count) {
-        print_line_error("Missing directive after label", tokens[0], line_num);
+    if (!inst) {
+        print_line_error("Unknown instruction", statement->name, statement->line_num);
         return FALSE;
     }
-    if (direct_index == 1) {
-        directive_name = tokens[direct_index];
-
-        if (strcmp(directive_name, ENTRY_DIRECTIVE) == 0)
-            print_line_warning("Label before .entry is redundant", tokens[0], line_num);
-
-        else if (strcmp(directive_name, EXTERN_DIRECTIVE) == 0)
-            print_line_warning("Label before .extern is redundant", tokens[0], line_num);
+    inst_length = calculate_instruction_length(inst, operands, statement->operand_count);
 
-        else if (!process_label(tokens[0], symtab, memory->dc, DATA_SYMBOL)) {
-            print_line_error("Failed to process label", tokens[0], line_num);
-            return FALSE;
-        }
+    if (inst_length == -1) {
+        print_line_error("Invalid instruction length", inst->name, statement->line_num);
+        return FALSE;
     }
-    return process_directive(tokens + direct_index, token_count - direct_index, symtab, memory, FALSE);
+    if (!check_ic_limit(memory->ic + inst_length))
+        return FALSE;
+
+    return encode_instruction(inst, operands, statement->operand_count, fixups, memory, statement->line_num);
 }
 
 /*
-Function to process a single line during first pass.
-Determines if line is instruction or directive, and routes accordingly.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
+Function to process a single directive statement during first pass.
+Handles labels and delegates to specific directive processors.
+Receives: const StatementTable *statements - Table owning the statement
+          const Statement *statement - Directive statement to process
           SymbolTable *symtab - Pointer to the symbol table
           MemoryImage *memory - Pointer to memory image tracking counters
-          int line_num - Current line number for error reporting
 Returns: int - TRUE if processing succeeded, FALSE on error
 */
-static int process_line(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int line_num) {
-    if (!check_line_format(tokens, token_count, line_num))
-        return FALSE;
+static int process_directive_statement(const StatementTable *statements, const Statement *statement, SymbolTable *symtab, MemoryImage *memory) {
+    if (HAS_LABEL(statement)) {
+        if (statement->directive == DIRECTIVE_ENTRY)
+            print_line_warning("Label before .entry is redundant", statement->label, statement->line_num);
+
+        else if (statement->directive == DIRECTIVE_EXTERN)
+            print_line_warning("Label before .extern is redundant", statement->label, statement->line_num);
 
-    if (is_directive_line(tokens, token_count)) {
-        if (!process_directive_line(tokens, token_count, symtab, memory, line_num))
+        else if (!define_label(statement, symtab, memory->dc, DATA_SYMBOL))
             return FALSE;
     }
-    else if (!process_instruction_line(tokens, token_count, symtab, memory, line_num))
-        return FALSE;
-    
-    return TRUE;
+    return process_directive(statement->directive, STATEMENT_OPERANDS(statements, statement), statement->operand_count, symtab, memory);
 }
 
 /*
-Function to process all lines from .am file during first pass.
-Manages memory for tokens and tracks errors across the entire file.
-Receives: FILE *fp - Pointer to the open source file
+Function to process all lines of the expanded source during first pass.
+Every line is tokenized & classified once into the statement table, then processed.
+Lines are taken as spans of the source buffer (no copy), their tokens point into it.
+Line tokens are bump-allocated from a line arena, which is reset after every line.
+Receives: const SourceBuffer *am_source - Expanded (.am) source buffer
+          StatementTable *statements - Statement table to fill
           SymbolTable *symtab - Pointer to the symbol table
           MemoryImage *memory - Pointer to memory image tracking counters
+          FixupTable *fixups - Pointer to fixup table
+          Arena *line_arena - Arena for line-scoped token storage
 Returns: int - TRUE if all lines processed successfully, FALSE otherwise
 */
-static int process_file_lines(FILE *fp, SymbolTable *symtab, MemoryImage *memory) {
-    char line[MAX_LINE_LENGTH];
-    char **tokens = NULL;
-    int token_count = 0, line_num = 0, error_flag = 0;
-
-    while (fgets(line, sizeof(line), fp)) {
+static int process_file_lines(const SourceBuffer *am_source, StatementTable *statements, SymbolTable *symtab, MemoryImage *memory, FixupTable *fixups, Arena *line_arena) {
+    const char *line;
+    Token *tokens = NULL;
+    int token_count = 0, line_num = 0, error_flag = 0, result;
+    size_t length, position = 0;
+    Statement *statement;
+
+    while (next_source_line(am_source, &position, &line, &length)) {
         line_num++;
+        reset_arena(line_arena);
 
-        if (!parse_tokens(line, &tokens, &token_count)) {
+        if (!parse_tokens(line, length, line_arena, &tokens, &token_count)) {
             print_line_error("Syntax error", NULL, line_num);
             error_flag = TRUE;
             continue;
         }
-        if (token_count == 0) {
-            free_tokens(tokens, token_count);
+        if (token_count == 0)
             continue;
-        }
-        if (!process_line(tokens, token_count, symtab, memory, line_num)) {
+
+        statement = add_statement(statements, tokens, token_count, line_num);
+
+        if (!statement)
+            result = FALSE;
+        else if (statement->kind == STATEMENT_DIRECTIVE)
+            result = process_directive_statement(statements, statement, symtab, memory);
+        else
+            result = process_instruction_statement(statements, statement, symtab, memory, fixups);
+
+        if (!result) {
             print_line_error("Detected issue while processing line", NULL, line_num);
             error_flag = TRUE;
         }
-        free_tokens(tokens, token_count);
     }
     return (error_flag ? FALSE : TRUE);
 }
@@ -156,30 +177,26 @@ static int process_file_lines(FILE *fp, SymbolTable *symtab, MemoryImage *memory
 /* Outer methods */
 /* ==================================================================== */
 /*
-Function to perform the first pass (second stage) of assembler on an .am file.
-Opens file, processes all lines, updates data symbols, and reports counters.
-Receives: const char *filename - Name of the source file to process
+Function to perform the first pass (second stage) of assembler on the expanded source.
+This is the only pass over the source lines: classifies every line into the statement table,
+builds the symbol table, encodes all instructions & data, and records label references
+in the fixup table. Updates data symbols, and reports counters.
+Receives: const char *filename - Name of the expanded (.am) source, for reporting
+          const SourceBuffer *am_source - Expanded (.am) source buffer
+          StatementTable *statements - Statement table to fill
           SymbolTable *symtab - Pointer to the symbol table
           MemoryImage *memory - Pointer to memory image tracking counters
+          FixupTable *fixups - Pointer to fixup table
+          Arena *line_arena - Arena for line-scoped token storage
 Returns: int - TRUE if first pass completed successfully, PASS_ERROR otherwise
 */
-int first_pass(const char *filename, SymbolTable *symtab, MemoryImage *memory) {
-    FILE *fp = NULL;
-
-    fp = open_source_file(filename);
-
-    if (!fp) {
-        safe_fclose(&fp);
-        return PASS_ERROR;
-    }
-    if (!process_file_lines(fp, symtab, memory)) {
-        safe_fclose(&fp);
+int first_pass(const char *filename, const SourceBuffer *am_source, StatementTable *statements, SymbolTable *symtab, MemoryImage *memory, FixupTable *fixups, Arena *line_arena) {
+    if (!process_file_lines(am_source, statements, symtab, memory, fixups, line_arena))
         return PASS_ERROR;
-    }
-    safe_fclose(&fp);
+
     update_data_symbols(symtab, memory->ic);
 
-    printf("%s: IC = %d, DC = %d\n", filename, memory->ic, memory->dc);
+    print_message("%s: IC = %d, DC = %d\n", filename, memory->ic, memory->dc);
 
     return TRUE;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "protocol.h"
+#include "file_overlay.h"
+
+/* Overlay of the running request, process wide since its files are assembled on several threads */
+static FileOverlay *active_overlay = NULL;
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to find the last record of a file in a buffer of records.
+Receives: const SourceBuffer *records - Buffer of records
+          const char *kind - Record kind to look for (RECORD_*)
+          const char *filename - Name of file
+          Record *found - Output record
+Returns: int - TRUE if file has a record, FALSE otherwise
+*/
+static int find_file_record(const SourceBuffer *records, const char *kind, const char *filename, Record *found) {
+    Record record;
+    size_t position = 0;
+    int result = FALSE;
+
+    while (next_record(records, &position, &record)) {
+        if (IS_RECORD(&record, kind) && IS_RECORD_NAME(&record, filename)) {
+            *found = record;
+            result = TRUE;
+        }
+    }
+    return result;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to initialize a file overlay once, before it is bound to its first request.
+Receives: FileOverlay *overlay - Overlay to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+int init_file_overlay(FileOverlay *overlay) {
+    overlay->inputs = NULL;
+
+    if (!init_source_buffer(&overlay->outputs))
+        return FALSE;
+
+    pthread_mutex_init(&overlay->lock, NULL);
+    return TRUE;
+}
+
+/*
+Function to free a file overlay, after its last request.
+Receives: FileOverlay *overlay - Overlay to free
+*/
+void free_file_overlay(FileOverlay *overlay) {
+    free_source_buffer(&overlay->outputs);
+    pthread_mutex_destroy(&overlay->lock);
+}
+
+/*
+Function to bind an overlay for the files of a request, with no captured outputs yet.
+Must not be called while files are assembled.
+Receives: FileOverlay *overlay - Overlay to bind, NULL to use the disk only again
+          const SourceBuffer *inputs - In-memory sources of the request (RECORD_INPUT records)
+*/
+void set_file_overlay(FileOverlay *overlay, const SourceBuffer *inputs) {
+    if (overlay) {
+        overlay->inputs = inputs;
+        reset_source_buffer(&overlay->outputs);
+    }
+    active_overlay = overlay;
+}
+
+/*
+Function to read a file from the bound overlay: an output captured earlier, or an in-memory source.
+Receives: const char *filename - Name of file
+          SourceBuffer *buffer - Buffer receiving the file contents (reset first)
+Returns: int - TRUE if read, FALSE on memory error, OVERLAY_NOT_FOUND if the overlay doesn't hold the file
+*/
+int read_overlay_file(const char *filename, SourceBuffer *buffer) {
+    Record record;
+    int result = OVERLAY_NOT_FOUND;
+
+    if (!active_overlay)
+        return OVERLAY_NOT_FOUND;
+
+    pthread_mutex_lock(&active_overlay->lock);
+
+    if (find_file_record(&active_overlay->outputs, RECORD_OUTPUT, filename, &record)) {
+        reset_source_buffer(buffer);
+        result = append_source_span(buffer, record.data, record.data_length);
+    }
+    pthread_mutex_unlock(&active_overlay->lock);
+
+    if ((result == OVERLAY_NOT_FOUND) && active_overlay->inputs &&
+        find_file_record(active_overlay->inputs, RECORD_INPUT, filename, &record)) {
+        reset_source_buffer(buffer);
+        result = append_source_span(buffer, record.data, record.data_length);
+    }
+    return result;
+}
+
+/*
+Function to capture an output file into the bound overlay, instead of writing it.
+Receives: const char *filename - Name of file
+          const char *text - File contents
+          size_t length - Length of text
+Returns: int - TRUE if captured, FALSE on memory error, OVERLAY_NOT_FOUND if no overlay is bound
+*/
+int write_overlay_file(const char *filename, const char *text, size_t length) {
+    int result;
+
+    if (!active_overlay)
+        return OVERLAY_NOT_FOUND;
+
+    pthread_mutex_lock(&active_overlay->lock);
+    result = append_record(&active_overlay->outputs, RECORD_OUTPUT, filename, strlen(filename), text, length);
+    pthread_mutex_unlock(&active_overlay->lock);
+
+    return result;
+}
\ No newline at end of file
@@ -5,306 +5,291 @@
 
 #include "utils.h"
 #include "errors.h"
-#include "tokenizer.h"
 #include "memory.h"
-#include "instructions.h"
-#include "directives.h"
 #include "symbol_table.h"
+#include "fixup_table.h"
 #include "encoder.h"
-#include "line_process.h"
+#include "statement.h"
+#include "source_buffer.h"
 #include "file_io.h"
+#include "binary_object.h"
 
 /* Inner STATIC methods */
 /* ==================================================================== */
 /*
-Function to check the starting index of an instruction / directive in a token array.
-Accounts for potential label at the beginning of the line.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
-Returns: int - Index where instruction/directive begins (0 or 1)
+Function to mark the label of an .entry statement as entry, now that all labels are known.
+Receives: const StatementTable *statements - Table owning the statement
+          const Statement *statement - .entry statement
+          SymbolTable *symtab - Pointer to symbol table
+Returns: int - TRUE if label was found, FALSE otherwise
 */
-static int get_item_index(char **tokens, int token_count) {
-    return is_first_token_label(tokens, token_count) ? 1 : 0;
+static int resolve_entry(const StatementTable *statements, const Statement *statement, SymbolTable *symtab) {
+    Symbol *symbol_ptr = find_symbol(symtab, STATEMENT_OPERANDS(statements, statement)[0].text);
+
+    if (symbol_ptr) {
+        symbol_ptr->is_entry = TRUE;
+        return TRUE;
+    }
+    return FALSE;
 }
 
 /*
-Function to encode an instruction into memory during second pass.
-Handles opcode, addressing modes, and operand parsing & encoding.
-Receives: const Instruction *inst - Pointer to instruction definition
-          char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
+Function to patch the operand words of a single statement, now that all label addresses are final.
+Fixups are stored in source order, so the statement's fixups start at the cursor.
+Receives: const Statement *statement - Statement whose fixups are patched
+          const FixupTable *fixups - Pointer to fixup table
+          int *cursor - Index of next unprocessed fixup, advanced past the statement's fixups
           SymbolTable *symtab - Pointer to symbol table
           MemoryImage *memory - Pointer to memory image
-          int *current_ic_ptr - Pointer to current instruction counter
-Returns: int - TRUE if encoding succeeded, FALSE on error
+Returns: int - TRUE if all fixups of statement resolved, FALSE on first unknown label
 */
-static int encode_instruction(const Instruction *inst, char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int *current_ic_ptr) {
-    int operand_start_index, operand_count;
-    MemoryWord *instruction_word;
+static int resolve_statement_fixups(const Statement *statement, const FixupTable *fixups, int *cursor, SymbolTable *symtab, MemoryImage *memory) {
+    const Fixup *fixup;
+    int result = TRUE;
 
-    if (!parse_operands(tokens, token_count, &operand_start_index, &operand_count))
-        return FALSE;
+    while ((*cursor < fixups->count) &&
+           (fixups->fixups[*cursor].line_num == statement->line_num)) {
+        fixup = &fixups->fixups[(*cursor)++];
 
-    if (!check_operands(inst, tokens + operand_start_index, operand_count)) 
-        return FALSE;
-
-    if (!encode_instruction_word(inst, memory, current_ic_ptr, &instruction_word))
-        return FALSE;
-
-    return encode_operands(inst, tokens, operand_start_index, operand_count, symtab, memory, current_ic_ptr, instruction_word);
+        if (result && !encode_symbol_operand(fixup->symbol, fixup->symbol_length, symtab, memory, fixup->address))
+            result = FALSE;
+    }
+    return result;
 }
 
 /*
-Function to process a single instruction line during second pass.
-Validates instruction and delegates to encoding function.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
+Function to walk the statement table once, resolving entries & label references.
+Only the first failing label reference of each statement is reported.
+Receives: const StatementTable *statements - Statement table built by first pass
+          const FixupTable *fixups - Pointer to fixup table filled by first pass
           SymbolTable *symtab - Pointer to symbol table
           MemoryImage *memory - Pointer to memory image
-          int *current_ic_ptr - Pointer to current instruction counter
-          int line_num - Current line number for error reporting
-Returns: int - TRUE if processing succeeded, FALSE on error
+Returns: int - TRUE if all statements resolved successfully, FALSE otherwise
 */
-static int process_instruction_line(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int *current_ic_ptr, int line_num) {
-    int inst_index;
-    const Instruction *inst;
+static int resolve_statements(const StatementTable *statements, const FixupTable *fixups, SymbolTable *symtab, MemoryImage *memory) {
+    const Statement *statement;
+    int i, result, cursor = 0, error_flag = 0;
 
-    inst_index = get_item_index(tokens, token_count);
-    inst = get_instruction(tokens[inst_index]);
+    for (i = 0; i < statements->count; i++) {
+        statement = &statements->statements[i];
 
-    if (!inst) {
-        print_line_error("Unknown instruction", tokens[inst_index], line_num);
-        return FALSE;
+        if (IS_ENTRY_STATEMENT(statement))
+            result = resolve_entry(statements, statement, symtab);
+        else
+            result = resolve_statement_fixups(statement, fixups, &cursor, symtab, memory);
+
+        if (!result) {
+            print_line_error("Detected issue while processing line", NULL, statement->line_num);
+            error_flag = TRUE;
+        }
     }
-    return encode_instruction(inst, tokens, token_count, symtab, memory, current_ic_ptr);
+    return (error_flag ? FALSE : TRUE);
 }
 
 /*
-Function to process a single directive line during second pass.
-Handles data directives and symbol declarations.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
-          SymbolTable *symtab - Pointer to symbol table
+Function to create and write the .ob file, rendered in memory and written at once.
+Receives: const char *filename - Name of output file
           MemoryImage *memory - Pointer to memory image
-          int line_num - Current line number for error reporting
-Returns: int - TRUE if processing succeeded, FALSE on error
+          SourceBuffer *output - Buffer to render the file into
+Returns: int - TRUE if the file was written, FALSE otherwise
 */
-static int process_directive_line(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int line_num) {
-    int direct_index;
-    
-    direct_index = get_item_index(tokens, token_count);
-    
-    if (direct_index >= token_count) {
-        print_line_error("Missing operand", "Missing directive after label", line_num);
-        return FALSE;
-    }
-    return process_directive(tokens + direct_index, token_count - direct_index, symtab, memory, TRUE);
+static int write_object_file(const char *filename, MemoryImage *memory, SourceBuffer *output) {
+    return render_object_file(memory, output) && write_source_file(output, filename);
 }
 
 /*
-Function to process a single line during second pass.
-Determines if line is instruction or directive, and routes accordingly.
-Receives: char **tokens - Array of tokens from the line
-          int token_count - Number of tokens in the array
+Function to create and write the .ent file, rendered in memory and written at once.
+Receives: const char *filename - Name of output file
           SymbolTable *symtab - Pointer to symbol table
-          MemoryImage *memory - Pointer to memory image
-          int *current_ic_ptr - Pointer to current instruction counter
-          int line_num - Current line number for error reporting
-Returns: int - TRUE if processing succeeded, FALSE on error
+          SourceBuffer *output - Buffer to render the file into
+Returns: int - TRUE if the file was written, FALSE otherwise
 */
-static int process_line(char **tokens, int token_count, SymbolTable *symtab, MemoryImage *memory, int *current_ic_ptr, int line_num) {
-    if (!check_line_format(tokens, token_count, line_num))
-        return FALSE;
-
-    if (is_directive_line(tokens, token_count)) {
-        if (!process_directive_line(tokens, token_count, symtab, memory, line_num))
-            return FALSE;
-    } 
-    else if (!process_instruction_line(tokens, token_count, symtab, memory, current_ic_ptr, line_num))
-        return FALSE;
-
-    return TRUE;
+static int write_entry_file(const char *filename, SymbolTable *symtab, SourceBuffer *output) {
+    return render_entry_file(symtab, output) && write_source_file(output, filename);
 }
 
 /*
-Function to process all lines from .am file during second pass.
-Manages memory for tokens and tracks errors across the entire file.
-Receives: FILE *fp - Pointer to open source file
-          SymbolTable *symtab - Pointer to symbol table
+Function to create and write the .ext file, rendered in memory and written at once.
+Receives: const char *filename - Name of output file
           MemoryImage *memory - Pointer to memory image
-Returns: int - TRUE if all lines processed successfully, FALSE otherwise
+          SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer to render the file into
+Returns: int - TRUE if the file was written, FALSE otherwise
 */
-static int process_file_lines(FILE *fp, SymbolTable *symtab, MemoryImage *memory) {
-    char line[MAX_LINE_LENGTH];
-    char **tokens = NULL;
-    int token_count = 0, line_num = 0, error_flag = 0, second_pass_ic = 0;
-
-    while (fgets(line, sizeof(line), fp)) {
-        line_num++;
-
-        if (!parse_tokens(line, &tokens, &token_count)) {
-            print_line_error("Syntax error", NULL, line_num);
-            error_flag = TRUE;
-            continue;
-        }
-        if (token_count == 0) {
-            free_tokens(tokens, token_count);
-            continue;
-        }
-        if (!process_line(tokens, token_count, symtab, memory, &second_pass_ic, line_num)) {
-            print_line_error("Detected issue while processing line", NULL, line_num);
-            error_flag = TRUE;
-        }
-        free_tokens(tokens, token_count);
-    }
-    return (error_flag ? FALSE : TRUE);
+static int write_extern_file(const char *filename, MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output) {
+    return render_extern_file(memory, symtab, output) && write_source_file(output, filename);
 }
 
 /*
-Function to write instruction memory contents to .ob file in base4 format
-Receives: FILE *fp - Pointer to output file
+Function to create and write the .rel file, rendered in memory and written at once.
+Receives: const char *filename - Name of output file
           MemoryImage *memory - Pointer to memory image
+          SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer to render the file into
+Returns: int - TRUE if the file was written, FALSE otherwise
 */
-static void write_instruction_lines(FILE *fp, MemoryImage *memory) {
-    char addr_str[ADDR_LENGTH], value_str[WORD_LENGTH];
-    int i, current_address;
-
-    for (i = 0; i < memory->ic; i++) {
-        current_address = IC_START + i;
-
-        convert_to_base4_address(current_address, addr_str);
-        convert_to_base4_word(memory->words[current_address].raw, value_str);
-        write_file_line(fp, addr_str, value_str);
-    }
+static int write_relocation_file(const char *filename, MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output) {
+    return render_relocation_file(memory, symtab, output) && write_source_file(output, filename);
 }
 
 /*
-Function to write data memory contents to .ob file in base4 format.
-Receives: FILE *fp - Pointer to output file
+Function to create and write the binary object file, rendered in memory and written at once.
+Receives: const char *filename - Name of output file
           MemoryImage *memory - Pointer to memory image
+          SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer to render the file into
+Returns: int - TRUE if the file was written, FALSE otherwise
 */
-static void write_data_lines(FILE *fp, MemoryImage *memory) {
-    char addr_str[ADDR_LENGTH], value_str[WORD_LENGTH];
-    int i, current_address;
+static int write_binary_object_file(const char *filename, MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output) {
+    return render_binary_object(memory, symtab, output) && write_source_file(output, filename);
+}
 
-    for (i = 0; i < memory->dc; i++) {
-        current_address = IC_START + memory->ic + i;
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to perform the second pass of assembler.
+Walks the statement table, marking entries & patching all label references
+recorded during the first pass.
+Receives: SymbolTable *symtab - Pointer to symbol table
+          MemoryImage *memory - Pointer to memory image
+          const StatementTable *statements - Statement table built by first pass
+          const FixupTable *fixups - Pointer to fixup table filled by first pass
+Returns: int - TRUE if second pass completed successfully, PASS_ERROR otherwise
+*/
+int second_pass(SymbolTable *symtab, MemoryImage *memory, const StatementTable *statements, const FixupTable *fixups) {
+    if (!resolve_statements(statements, fixups, symtab, memory))
+        return PASS_ERROR;
 
-        convert_to_base4_address(current_address, addr_str);
-        convert_to_base4_word(memory->words[i].raw, value_str);
-        write_file_line(fp, addr_str, value_str);
-    }
+    return TRUE;
 }
 
 /*
-Function to create & write the .ob file.
-Writes header with IC/DC, alongside instruction / data words.
-Receives: const char *filename - Name of output file
-          MemoryImage *memory - Pointer to memory image
+Function to render the .ob file contents: the header with IC/DC, alongside instruction / data words.
+Receives: MemoryImage *memory - Pointer to memory image
+          SourceBuffer *output - Buffer receiving the rendered file (reset first)
+Returns: int - TRUE if rendered, FALSE on memory error
 */
-static void write_object_file(const char *filename, MemoryImage *memory) {
-    char ic_str[6], dc_str[6];
-    FILE *fp = open_output_file(filename);
-    
-    if (!fp)
-        return;
-    
-    /* Write header */
-    convert_to_base4_header(memory->ic, ic_str);
-    convert_to_base4_header(memory->dc, dc_str);
-    write_file_line(fp, ic_str, dc_str);
-
-    write_instruction_lines(fp, memory);
-    write_data_lines(fp, memory);
-    
-    safe_fclose(&fp);
+int render_object_file(MemoryImage *memory, SourceBuffer *output) {
+    char text[MAX_OBJECT_TEXT_LENGTH];
+    size_t length = format_object_image(memory, text);
+
+    reset_source_buffer(output);
+    return append_source_span(output, text, length);
 }
 
 /*
-Function to create and write the .ent file.
-Lists all symbols marked as entry with their addresses.
-Receives: const char *filename - Name of output file
-          SymbolTable *symtab - Pointer to symbol table
+Function to render the .ent file contents: all symbols marked as entry with their addresses.
+Receives: SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer receiving the rendered file (reset first)
+Returns: int - TRUE if rendered, FALSE on memory error
 */
-static void write_entry_file(const char *filename, SymbolTable *symtab) {
+int render_entry_file(SymbolTable *symtab, SourceBuffer *output) {
     char addr_str[ADDR_LENGTH];
     int i;
-    FILE *fp = open_output_file(filename);
 
-    if (!fp)
-        return;
+    reset_source_buffer(output);
 
     for (i = 0; i < symtab->count; i++) {
         if (symtab->symbols[i].is_entry) {
             convert_to_base4_address(symtab->symbols[i].value, addr_str);
-            write_file_line(fp, symtab->symbols[i].name, addr_str);
+
+            if (!append_source_line(output, symtab->symbols[i].name, addr_str))
+                return FALSE;
         }
     }
-    safe_fclose(&fp);
+    return TRUE;
 }
 
 /*
-Function to create and write the .ext file.
-Lists all external symbol references with their usage locations.
-Receives: const char *filename - Name of output file
-          MemoryImage *memory - Pointer to memory image
+Function to render the .ext file contents: all external symbol references with their usage locations.
+Only the relocation list is walked, external references are found without scanning the code words.
+Receives: MemoryImage *memory - Pointer to memory image
           SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer receiving the rendered file (reset first)
+Returns: int - TRUE if rendered, FALSE on memory error
 */
-static void write_extern_file(const char *filename, MemoryImage *memory, SymbolTable *symtab) {
-    const char *symbol_name;
+int render_extern_file(MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output) {
+    const Relocation *relocation;
     char addr_str[ADDR_LENGTH];
-    int i, ext_index;
-    FILE *fp = open_output_file(filename);
+    int i;
 
-    if (!fp)
-        return;
+    reset_source_buffer(output);
 
-    for (i = IC_START; i < IC_START + memory->ic; i++) {
-        ext_index = memory->words[i].operand.ext_symbol_index;
+    for (i = 0; i < memory->relocation_count; i++) {
+        relocation = &memory->relocations[i];
 
-        if ((memory->words[i].operand.are == ARE_EXTERNAL) &&
-            (ext_index >= 0)) {
-            symbol_name = symtab->symbols[ext_index].name;
+        if (relocation->are == ARE_EXTERNAL) {
+            convert_to_base4_address(relocation->address, addr_str);
 
-            convert_to_base4_address(i, addr_str);
-            write_file_line(fp, symbol_name, addr_str);
+            if (!append_source_line(output, symtab->symbols[relocation->symbol_index].name, addr_str))
+                return FALSE;
         }
     }
-    safe_fclose(&fp);
+    return TRUE;
 }
 
-/* Outer methods */
-/* ==================================================================== */
 /*
-Function to perform the second pass (last stage) of assembler on an .am file.
-Opens file, processes all lines, resolves symbols, and generates output files.
-Receives: const char *filename - Name of source file
+Function to render the .rel file contents: the address & kind of every relocatable / external word,
+in address order, so a loader can rebase the .ob image without decoding its words.
+Lines are "<address> R" for label addresses, and "<address> E <symbol>" for external references.
+Receives: MemoryImage *memory - Pointer to memory image
           SymbolTable *symtab - Pointer to symbol table
+          SourceBuffer *output - Buffer receiving the rendered file (reset first)
+Returns: int - TRUE if rendered, FALSE on memory error
+*/
+int render_relocation_file(MemoryImage *memory, SymbolTable *symtab, SourceBuffer *output) {
+    const Relocation *relocation;
+    char addr_str[ADDR_LENGTH], kind[MAX_RELOC_KIND_LENGTH];
+    int i;
+
+    reset_source_buffer(output);
+
+    for (i = 0; i < memory->relocation_count; i++) {
+        relocation = &memory->relocations[i];
+        convert_to_base4_address(relocation->address, addr_str);
+
+        if (relocation->are == ARE_EXTERNAL)
+            sprintf(kind, "%s %s", RELOC_KIND_EXTERNAL, symtab->symbols[relocation->symbol_index].name);
+        else
+            strcpy(kind, RELOC_KIND_RELOCATABLE);
+
+        if (!append_source_line(output, addr_str, kind))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to generate the output files (last stage) of assembler, after a successful second pass.
+The .ent and .ext files are only created when the file has entries / externals, stale ones are removed otherwise.
+Receives: SymbolTable *symtab - Pointer to symbol table
           MemoryImage *memory - Pointer to memory image
+          SourceBuffer *output - Buffer each output file is rendered into
           const char *obj_file - Name for .ob file
           const char *ent_file - Name for .ent file
           const char *ext_file - Name for .ext file
-Returns: int - TRUE if second pass completed successfully, PASS_ERROR otherwise
+          const char *rel_file - Name for .rel file (NULL if not requested)
+          const char *bin_file - Name for binary object file (NULL if not requested)
+Returns: int - TRUE if all files were written, FALSE if any file failed (all files are still attempted)
 */
-int second_pass(const char *filename, SymbolTable *symtab, MemoryImage *memory, const char *obj_file, const char *ent_file, const char *ext_file) {
-    FILE *fp = open_source_file(filename);
-
-    if (!fp) {
-        safe_fclose(&fp);
-        return PASS_ERROR;
-    }
-    if (!process_file_lines(fp, symtab, memory)) {
-        safe_fclose(&fp);
-        return PASS_ERROR;
-    }
-    safe_fclose(&fp);
-    write_object_file(obj_file, memory);
+int write_output_files(SymbolTable *symtab, MemoryImage *memory, SourceBuffer *output, const char *obj_file, const char *ent_file, const char *ext_file, const char *rel_file, const char *bin_file) {
+    int result = write_object_file(obj_file, memory, output);
 
     if (has_entries(symtab))
-        write_entry_file(ent_file, symtab);
+        result = write_entry_file(ent_file, symtab, output) && result;
+    else
+        remove_output_file(ent_file);
 
     if (has_externs(symtab))
-        write_extern_file(ext_file, memory, symtab);
+        result = write_extern_file(ext_file, memory, symtab, output) && result;
+    else
+        remove_output_file(ext_file);
 
-    return TRUE;
+    if (rel_file)
+        result = write_relocation_file(rel_file, memory, symtab, output) && result;
+
+    if (bin_file)
+        result = write_binary_object_file(bin_file, memory, symtab, output) && result;
+
+    return result;
 }
\ No newline at end of file
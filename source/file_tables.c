@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utils.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "macro_table.h"
+#include "source_buffer.h"
+#include "fixup_table.h"
+#include "statement.h"
+#include "arena.h"
+#include "tokenizer.h"
+#include "keywords.h"
+#include "file_io.h"
+
+/*
+Function to initialize all per-file tables once, before they are used for the first file.
+Debug builds also check that keyword_slots.h is up to date with the keywords & instructions.
+Receives: FileTables *tables - Tables to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error (or a stale keyword table)
+*/
+int init_file_tables(FileTables *tables) {
+    int symtab_ok, macrotab_ok, input_ok, source_ok, output_ok, log_ok, entry_ok, statements_ok, fixups_ok, arena_ok;
+
+#ifndef NDEBUG
+    if (!check_keyword_slots()) {
+        print_error("Keyword perfect hash table is out of date", "make keyword-slots");
+        return FALSE;
+    }
+#endif
+
+    symtab_ok = init_symbol_table(&tables->symtab);
+    macrotab_ok = init_macro_table(&tables->macrotab);
+    input_ok = init_source_buffer(&tables->as_source);
+    source_ok = init_source_buffer(&tables->am_source);
+    output_ok = init_source_buffer(&tables->output);
+    log_ok = init_source_buffer(&tables->log);
+    entry_ok = init_source_buffer(&tables->cache_entry);
+    statements_ok = init_statement_table(&tables->statements);
+    fixups_ok = init_fixup_table(&tables->fixups);
+    arena_ok = init_arena(&tables->line_arena, LINE_ARENA_SIZE);
+    init_file_stats(&tables->stats);
+    init_file_stats(&tables->totals);
+
+    if (symtab_ok && macrotab_ok && input_ok && source_ok && output_ok && log_ok && entry_ok && statements_ok && fixups_ok && arena_ok)
+        return TRUE;
+
+    if (symtab_ok)
+        free_symbol_table(&tables->symtab);
+    if (macrotab_ok)
+        free_macro_table(&tables->macrotab);
+    if (input_ok)
+        free_source_buffer(&tables->as_source);
+    if (source_ok)
+        free_source_buffer(&tables->am_source);
+    if (output_ok)
+        free_source_buffer(&tables->output);
+    if (log_ok)
+        free_source_buffer(&tables->log);
+    if (entry_ok)
+        free_source_buffer(&tables->cache_entry);
+    if (statements_ok)
+        free_statement_table(&tables->statements);
+    if (fixups_ok)
+        free_fixup_table(&tables->fixups);
+
+    free_arena(&tables->line_arena);
+    return FALSE;
+}
+
+/*
+Function to empty all per-file tables before processing the next file, keeping their allocations.
+The accumulated statistics (totals) are kept.
+Receives: FileTables *tables - Tables to reset
+*/
+void reset_file_tables(FileTables *tables) {
+    reset_symbol_table(&tables->symtab);
+    reset_macro_table(&tables->macrotab);
+    reset_source_buffer(&tables->as_source);
+    reset_source_buffer(&tables->am_source);
+    reset_source_buffer(&tables->output);
+    reset_source_buffer(&tables->log);
+    reset_source_buffer(&tables->cache_entry);
+    reset_statement_table(&tables->statements);
+    reset_fixup_table(&tables->fixups);
+    reset_arena(&tables->line_arena);
+    init_file_stats(&tables->stats);
+    init_memory(&tables->memory);
+}
+
+/*
+Function to free all per-file tables, after the last file was processed.
+Receives: FileTables *tables - Tables to deallocate
+*/
+void free_file_tables(FileTables *tables) {
+    free_symbol_table(&tables->symtab);
+    free_macro_table(&tables->macrotab);
+    free_source_buffer(&tables->as_source);
+    free_source_buffer(&tables->am_source);
+    free_source_buffer(&tables->output);
+    free_source_buffer(&tables->log);
+    free_source_buffer(&tables->cache_entry);
+    free_statement_table(&tables->statements);
+    free_fixup_table(&tables->fixups);
+    free_arena(&tables->line_arena);
+}
\ No newline at end of file
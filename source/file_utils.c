@@ -5,7 +5,9 @@
 
 #include "utils.h"
 #include "errors.h"
+#include "source_buffer.h"
 #include "file_io.h"
+#include "file_overlay.h"
 
 /*
 Function to safely close a file pointer with null-checking and nullification.
@@ -32,6 +34,25 @@ FILE *open_source_file(const char *filename) {
     return fp;
 }
 
+/*
+Function to get the size of a file, without reporting errors.
+Receives: const char *filename - Path to file
+Returns: long - File size in bytes, -1 if file can't be opened
+*/
+long get_file_size(const char *filename) {
+    long size = -1;
+    FILE *fp = fopen(filename, "r");
+
+    if (!fp)
+        return -1;
+
+    if (fseek(fp, 0, SEEK_END) == 0)
+        size = ftell(fp);
+
+    safe_fclose(&fp);
+    return size;
+}
+
 /*
 Function to open a file for writing.
 Receives: const char *filename - Path to output file
@@ -47,11 +68,67 @@ FILE *open_output_file(const char *filename) {
 }
 
 /*
-Function to write a formatted line to an output file.
-Receives: FILE *fp - Valid file pointer (must be open for writing)
-          const char *part1 - First part of line (cannot be NULL)
-          const char *part2 - Second part of line (cannot be NULL)
+Function to write a whole rendered artifact into a file.
+The stream is unbuffered, so the text reaches the file with a single write call.
+Receives: const char *filename - Path of the output file
+          const char *text - Text to write
+          size_t length - Length of text
+Returns: int - TRUE if the file was written, FALSE otherwise
+*/
+int write_text_file(const char *filename, const char *text, size_t length) {
+    size_t written;
+    int closed;
+    FILE *fp = open_output_file(filename);
+
+    if (!fp)
+        return FALSE;
+
+    setvbuf(fp, NULL, _IONBF, 0);
+    written = fwrite(text, 1, length, fp);
+    closed = (fclose(fp) == 0);    /* a delayed write error (disk full, I/O) surfaces on close */
+
+    if ((written != length) || !closed) {
+        print_error("Failed to write to file", filename);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to read an input file, from the bound file overlay when it holds the file, otherwise from disk.
+Receives: SourceBuffer *buffer - Buffer receiving the file contents
+          const char *filename - Name of file
+Returns: int - TRUE if the file was read, FALSE otherwise
+*/
+int read_input_file(SourceBuffer *buffer, const char *filename) {
+    int result = read_overlay_file(filename, buffer);
+
+    if (result == OVERLAY_NOT_FOUND)
+        return read_source_file(buffer, filename);
+
+    return result;
+}
+
+/*
+Function to write an output file (.am/.ob/.ent/.ext), captured by the bound file overlay if any, otherwise to disk.
+Receives: const char *filename - Path of the output file
+          const char *text - Text to write
+          size_t length - Length of text
+Returns: int - TRUE if the file was written, FALSE otherwise
+*/
+int write_output_file(const char *filename, const char *text, size_t length) {
+    int result = write_overlay_file(filename, text, length);
+
+    if (result == OVERLAY_NOT_FOUND)
+        return write_text_file(filename, text, length);
+
+    return result;
+}
+
+/*
+Function to remove an output file left by an earlier build (e.g. a .ent file of a source that no longer has entries).
+Receives: const char *filename - Path of the output file, a missing file is not an error
 */
-void write_file_line(FILE *fp, const char *part1, const char *part2) {
-    fprintf(fp, "%s %s%c", part1, part2, NEWLINE);
+void remove_output_file(const char *filename) {
+    remove(filename);
 }
\ No newline at end of file
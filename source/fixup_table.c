@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "fixup_table.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to dynamically expand the fixup table capacity when full.
+Receives: FixupTable *table - Table to resize
+Returns: int - TRUE if resize succeeded, FALSE on memory error
+*/
+static int resize_fixup_table(FixupTable *table) {
+    int new_capacity;
+    Fixup *new_fixups;
+
+    new_capacity = (table->capacity == 0) ? INITIAL_FIXUPS_CAPACITY : table->capacity * 2;
+    new_fixups = REALLOC(table->fixups, new_capacity * sizeof(Fixup), ALLOC_SITE_FIXUPS);
+
+    if (!new_fixups) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize fixup table");
+        return FALSE;
+    }
+    table->fixups = new_fixups;
+    table->capacity = new_capacity;
+
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to initialize the fixup table with default capacity.
+Receives: FixupTable *table - Pointer to table structure to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+int init_fixup_table(FixupTable *table) {
+    table->fixups = ALLOC(INITIAL_FIXUPS_CAPACITY * sizeof(Fixup), ALLOC_SITE_FIXUPS);
+
+    if (!table->fixups) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to initialize fixup table");
+        return FALSE;
+    }
+    table->count = 0;
+    table->capacity = INITIAL_FIXUPS_CAPACITY;
+
+    return TRUE;
+}
+
+/*
+Function to free all resources associated with the fixup table.
+Receives: FixupTable *table - Table to deallocate
+*/
+void free_fixup_table(FixupTable *table) {
+    safe_free((void**)&table->fixups);
+
+    table->count = 0;
+    table->capacity = 0;
+}
+
+/*
+Function to empty the fixup table for the next source, keeping its allocation.
+Receives: FixupTable *table - Table to reset
+*/
+void reset_fixup_table(FixupTable *table) {
+    table->count = 0;
+}
+
+/*
+Function to record an operand reference that can only be resolved once all labels are known.
+Receives: FixupTable *table - Target fixup table
+          const char *symbol - Referenced symbol name, must outlive the table entries
+          int symbol_length - Length of symbol name
+          int address - Address of the operand word to patch
+          int line_num - Source line number for error reporting
+Returns: int - TRUE if recorded successfully, FALSE on memory error
+*/
+int add_fixup(FixupTable *table, const char *symbol, int symbol_length, int address, int line_num) {
+    Fixup *fixup;
+
+    if ((table->count >= table->capacity) &&
+        (!resize_fixup_table(table)))
+        return FALSE;
+
+    fixup = &table->fixups[table->count];
+    fixup->symbol = symbol;
+    fixup->symbol_length = symbol_length;
+    fixup->address = address;
+    fixup->line_num = line_num;
+
+    table->count++;
+    return TRUE;
+}
\ No newline at end of file
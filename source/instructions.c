@@ -6,9 +6,11 @@
 #include "utils.h"
 #include "memory.h"
 #include "instructions.h"
+#include "keywords.h"
+#include "diagnostics.h"
 
 /*
-Complete instruction collection for the assembler.
+Complete instruction collection for the assembler, indexed by opcode.
 Instruction Groups:
   I. Two-operand (mov, cmp, add, sub, lea)
   II. One-operand (clr, not, inc, dec, jmp, bne, jsr, red, prn)
@@ -90,7 +92,7 @@ Returns: int - TRUE if count matches, FALSE otherwise
 */
 static int check_operand_count(const Instruction *inst, int operand_count) {
     if (operand_count != inst->num_operands) {
-        printf("Invalid instruction operands amount (%d / %d)%c", inst->num_operands, operand_count, NEWLINE);
+        print_message("Invalid instruction operands amount (%d / %d)%c", inst->num_operands, operand_count, NEWLINE);
         return FALSE;
     }
     return TRUE;
@@ -135,19 +137,40 @@ static int get_operand_word_cost(int addressing_mode) {
 
 /* Outer methods */
 /* ==================================================================== */
+/*
+Function to find an instruction by name span (case-sensitive), through the keywords hash.
+Receives: const char *name - Start of name (not necessarily null terminated)
+          size_t length - Length of name
+Returns: const Instruction* - Pointer to instruction struct, NULL if not found
+*/
+const Instruction* get_instruction_span(const char *name, size_t length) {
+    const Keyword *keyword = find_keyword_span(name, length);
+
+    if (!keyword || (keyword->keyword_class != KEYWORD_INSTRUCTION))
+        return NULL;
+
+    return &instruction_set[keyword->id]; /* keyword ID is the opcode */
+}
+
 /*
 Function to find an instruction by name (case-sensitive).
 Receives: const char *name - string to search for
 Returns: const Instruction* - Pointer to instruction struct, NULL if not found
 */
 const Instruction* get_instruction(const char *name) {
-    int i;
+    return get_instruction_span(name, strlen(name));
+}
 
-    for (i = 0; i < INSTRUCTIONS_COUNT; i++) {
-        if (strcmp(name, instruction_set[i].name) == 0)
-            return &instruction_set[i];
-    }
-    return NULL;
+/*
+Function to get an instruction by its opcode.
+Receives: int opcode - Opcode of instruction
+Returns: const Instruction* - Pointer to instruction struct, NULL if opcode is out of range
+*/
+const Instruction* get_instruction_by_opcode(int opcode) {
+    if ((opcode < 0) || (opcode >= INSTRUCTIONS_COUNT))
+        return NULL;
+
+    return &instruction_set[opcode];
 }
 
 /*
@@ -174,15 +197,15 @@ int get_addressing_mode(const char *operand) {
 /*
 Function to calculate total words required for an instruction.
 Receives: const Instruction *inst - Instruction definition
-          char **operands - Array of operand strings
+          const Operand *operands - Array of parsed operands
           int operand_count - Number of operands
 Returns: int - Total words required or -1 if:
                - Invalid operands
                - Wrong operand count
                - Exceeds MAX_INSTRUCTION_WORDS
 */
-int calculate_instruction_length(const Instruction *inst, char **operands, int operand_count) {
-    int i, mode;
+int calculate_instruction_length(const Instruction *inst, const Operand *operands, int operand_count) {
+    int i;
     int length = 1;
 
     if (!inst || !operands)
@@ -192,20 +215,41 @@ int calculate_instruction_length(const Instruction *inst, char **operands, int o
         return -1;
 
     for (i = 0; i < operand_count; i++) {
-        mode = get_addressing_mode(operands[i]);
-
-        if (mode == -1)
+        if (operands[i].mode == -1)
             return -1;
         
-        length += get_operand_word_cost(mode);
+        length += get_operand_word_cost(operands[i].mode);
     }
     if ((operand_count == 2) &&
-        (get_addressing_mode(operands[0]) == ADDR_MODE_REGISTER) &&
-        (get_addressing_mode(operands[1]) == ADDR_MODE_REGISTER))
+        (operands[0].mode == ADDR_MODE_REGISTER) &&
+        (operands[1].mode == ADDR_MODE_REGISTER))
         length--;  /* Two registers share one word */
 
     if (!check_instruction_limit(inst, length))
         return -1;
 
     return length;
+}
+
+/*
+Function to calculate total words of an encoded instruction, from its first word (as a linker decodes code).
+The operand of a single operand instruction is encoded in the destination mode field.
+Receives: MemoryWord word - First word of instruction
+Returns: int - Total words of instruction
+*/
+int decode_instruction_length(MemoryWord word) {
+    const Instruction *inst = &instruction_set[(word >> OPCODE_SHIFT) & OPCODE_MASK];
+    int src_mode = (word >> SRC_MODE_SHIFT) & MODE_MASK;
+    int dest_mode = (word >> DEST_MODE_SHIFT) & MODE_MASK;
+
+    if (inst->num_operands == NO_OPERANDS)
+        return 1;
+
+    if (inst->num_operands == ONE_OPERAND)
+        return 1 + get_operand_word_cost(dest_mode);
+
+    if ((src_mode == ADDR_MODE_REGISTER) && (dest_mode == ADDR_MODE_REGISTER))
+        return 2;  /* Two registers share one word */
+
+    return 1 + get_operand_word_cost(src_mode) + get_operand_word_cost(dest_mode);
 }
\ No newline at end of file
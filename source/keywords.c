@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "memory.h"
+#include "instructions.h"
+#include "directives.h"
+#include "macro_table.h"
+#include "keywords.h"
+#include "keyword_slots.h"
+
+/*
+Complete reserved keywords collection of the assembler language.
+Instructions are kept in opcode order, matching instruction_set (checked by check_instruction_keywords).
+*/
+static const Keyword keywords[KEYWORDS_COUNT] = {
+    {"mov", KEYWORD_INSTRUCTION, 0}, {"cmp", KEYWORD_INSTRUCTION, 1},
+    {"add", KEYWORD_INSTRUCTION, 2}, {"sub", KEYWORD_INSTRUCTION, 3},
+    {"lea", KEYWORD_INSTRUCTION, 4}, {"clr", KEYWORD_INSTRUCTION, 5},
+    {"not", KEYWORD_INSTRUCTION, 6}, {"inc", KEYWORD_INSTRUCTION, 7},
+    {"dec", KEYWORD_INSTRUCTION, 8}, {"jmp", KEYWORD_INSTRUCTION, 9},
+    {"bne", KEYWORD_INSTRUCTION, 10}, {"jsr", KEYWORD_INSTRUCTION, 11},
+    {"red", KEYWORD_INSTRUCTION, 12}, {"prn", KEYWORD_INSTRUCTION, 13},
+    {"rts", KEYWORD_INSTRUCTION, 14}, {"stop", KEYWORD_INSTRUCTION, 15},
+
+    {DATA_DIRECTIVE, KEYWORD_DIRECTIVE, DIRECTIVE_DATA},
+    {STRING_DIRECTIVE, KEYWORD_DIRECTIVE, DIRECTIVE_STRING},
+    {MATRIX_DIRECTIVE, KEYWORD_DIRECTIVE, DIRECTIVE_MATRIX},
+    {ENTRY_DIRECTIVE, KEYWORD_DIRECTIVE, DIRECTIVE_ENTRY},
+    {EXTERN_DIRECTIVE, KEYWORD_DIRECTIVE, DIRECTIVE_EXTERN},
+    {"data", KEYWORD_DIRECTIVE, NO_DIRECTIVE}, {"string", KEYWORD_DIRECTIVE, NO_DIRECTIVE},
+    {"mat", KEYWORD_DIRECTIVE, NO_DIRECTIVE}, {"entry", KEYWORD_DIRECTIVE, NO_DIRECTIVE},
+    {"extern", KEYWORD_DIRECTIVE, NO_DIRECTIVE},
+
+    {"r0", KEYWORD_REGISTER, 0}, {"r1", KEYWORD_REGISTER, 1},
+    {"r2", KEYWORD_REGISTER, 2}, {"r3", KEYWORD_REGISTER, 3},
+    {"r4", KEYWORD_REGISTER, 4}, {"r5", KEYWORD_REGISTER, 5},
+    {"r6", KEYWORD_REGISTER, 6}, {"r7", KEYWORD_REGISTER, 7},
+    {PSW_REGISTER, KEYWORD_REGISTER, PSW_REGISTER_ID},
+
+    {MACRO_START, KEYWORD_MACRO, MACRO_KEYWORD_START},
+    {MACRO_END, KEYWORD_MACRO, MACRO_KEYWORD_END}
+};
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to compute the perfect hash slot of a candidate keyword.
+Mixes the length with the first, second and last chars, with coefficients
+chosen so that all keywords land in distinct slots.
+Receives: const char *name - Candidate keyword span (at least 1 char)
+          size_t length - Length of the candidate
+Returns: int - Slot index in keyword_slots
+*/
+static int keyword_hash(const char *name, size_t length) {
+    unsigned long hash = length;
+
+    hash += (unsigned char)name[0];
+    hash += 2 * (unsigned long)((length > 1) ? (unsigned char)name[1] : 0);
+    hash += 29 * (unsigned long)(unsigned char)name[length - 1];
+
+    return (int)(hash & (KEYWORD_SLOTS - 1));
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to classify a token span as a reserved keyword, with a single hash probe.
+Receives: const char *name - Start of token (not necessarily null terminated)
+          size_t length - Length of token
+Returns: const Keyword* - Pointer to keyword (class & ID), NULL if not a keyword
+*/
+const Keyword *find_keyword_span(const char *name, size_t length) {
+    int index;
+
+    if (!name || (length == 0) || (length > MAX_KEYWORD_LENGTH))
+        return NULL;
+
+    index = keyword_slots[keyword_hash(name, length)];
+
+    if ((index < 0) ||
+        (strncmp(keywords[index].name, name, length) != 0) ||
+        (keywords[index].name[length] != NULL_TERMINATOR))
+        return NULL;
+
+    return &keywords[index];
+}
+
+/*
+Function to classify a token as a reserved keyword, with a single hash probe.
+Receives: const char *name - Token to classify
+Returns: const Keyword* - Pointer to keyword (class & ID), NULL if not a keyword
+*/
+const Keyword *find_keyword(const char *name) {
+    return name ? find_keyword_span(name, strlen(name)) : NULL;
+}
+
+/*
+Function to get the keyword class of a token span.
+Receives: const char *name - Start of token (not necessarily null terminated)
+          size_t length - Length of token
+Returns: int - KEYWORD_* class, KEYWORD_NONE if not a keyword
+*/
+int get_keyword_span_class(const char *name, size_t length) {
+    const Keyword *keyword = find_keyword_span(name, length);
+
+    return keyword ? keyword->keyword_class : KEYWORD_NONE;
+}
+
+/*
+Function to get the keyword class of a token.
+Receives: const char *name - Token to classify
+Returns: int - KEYWORD_* class, KEYWORD_NONE if not a keyword
+*/
+int get_keyword_class(const char *name) {
+    const Keyword *keyword = find_keyword(name);
+
+    return keyword ? keyword->keyword_class : KEYWORD_NONE;
+}
+
+/*
+Function to build the perfect hash table of the keywords: the keyword index of every slot, -1 for empty slots.
+Used by the generator of keyword_slots.h (make keyword-slots), and to check the generated table.
+Receives: signed char *slots - Output table (KEYWORD_SLOTS size)
+Returns: int - TRUE if every keyword has its own slot, FALSE on a collision (keyword_hash must be retuned)
+*/
+int build_keyword_slots(signed char *slots) {
+    int i, slot;
+
+    memset(slots, -1, KEYWORD_SLOTS);
+
+    for (i = 0; i < KEYWORDS_COUNT; i++) {
+        slot = keyword_hash(keywords[i].name, strlen(keywords[i].name));
+
+        if (slots[slot] >= 0)
+            return FALSE;
+
+        slots[slot] = (signed char)i;
+    }
+    return TRUE;
+}
+
+/*
+Function to check that the instruction keywords are exactly the instructions of instruction_set:
+one keyword per opcode, in opcode order, with the instruction's name.
+Returns: int - TRUE if they match, FALSE if keywords must be updated after instruction_set
+*/
+int check_instruction_keywords(void) {
+    const Instruction *inst;
+    int i, count = 0;
+
+    for (i = 0; i < KEYWORDS_COUNT; i++) {
+        if (keywords[i].keyword_class != KEYWORD_INSTRUCTION)
+            continue;
+
+        inst = get_instruction_by_opcode(count);
+
+        if (!inst || (keywords[i].id != inst->opcode) || (strcmp(keywords[i].name, inst->name) != 0))
+            return FALSE;
+
+        count++;
+    }
+    return count == INSTRUCTIONS_COUNT;
+}
+
+/*
+Function to check that the generated perfect hash table matches the keywords collection,
+so every keyword is found by its single probe, and that the instruction keywords match instruction_set.
+Returns: int - TRUE if the table is up to date, FALSE if keyword_slots.h must be regenerated
+*/
+int check_keyword_slots(void) {
+    signed char slots[KEYWORD_SLOTS];
+
+    return check_instruction_keywords() && build_keyword_slots(slots) &&
+           (memcmp(slots, keyword_slots, KEYWORD_SLOTS) == 0);
+}
\ No newline at end of file
@@ -0,0 +1,706 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "memory.h"
+#include "symbol_table.h"
+#include "source_buffer.h"
+#include "file_io.h"
+#include "instructions.h"
+#include "binary_object.h"
+#include "archive.h"
+#include "linker.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to report a linking error about a symbol of an object.
+Receives: const char *message - Error message
+          const LinkModule *module - Object the symbol belongs to
+          const char *name - Symbol name (NULL if unknown)
+*/
+static void print_link_error(const char *message, const LinkModule *module, const char *name) {
+    char context[MAX_LINK_CONTEXT_LENGTH];
+
+    sprintf(context, "%.*s in %.*s", MAX_LABEL_NAME_LENGTH - 1, name ? name : "?",
+            MAX_FILENAME_LENGTH - MAX_EXTENSION_LENGTH, module->name);
+    print_error(message, context);
+}
+
+/*
+Function to get the word of an object at an address, in the numbering of the words of all objects.
+Receives: const unsigned char *object - Binary object
+          const LinkModule *module - Object, with its words loaded
+          int address - Address within the object
+Returns: int - Index of word in Linker.words, -1 if address is outside the object
+*/
+static int get_module_word(const unsigned char *object, const LinkModule *module, int address) {
+    int code_start = (int)BINARY_U16(object, BINARY_CODE_BASE_FIELD);
+    int word_count = (int)BINARY_U16(object, BINARY_IC_FIELD) + (int)BINARY_U16(object, BINARY_DC_FIELD);
+
+    if ((address < code_start) || (address >= code_start + word_count))
+        return -1;
+
+    return module->first_word + address - code_start;
+}
+
+/*
+Function to find the object a word belongs to, for messages.
+Receives: const Linker *linker - Linker with the words of all objects loaded
+          int word - Index of word
+Returns: const LinkModule* - Object of the word
+*/
+static const LinkModule *find_word_module(const Linker *linker, int word) {
+    int i = linker->count - 1;
+
+    while ((i > 0) && (linker->modules[i].first_word > word)) {
+        i--;
+    }
+    return &linker->modules[i];
+}
+
+/*
+Function to load the words of all objects into Linker.words, numbered one after another (code, then data of each object).
+Until addresses are assigned, the address of every word is its number.
+Receives: Linker *linker - Linker holding the loaded objects
+Returns: int - TRUE if loaded, FALSE on memory error
+*/
+static int load_module_words(Linker *linker) {
+    const unsigned char *object;
+    unsigned long words;
+    LinkWord *new_words, *word;
+    int *new_pending;
+    int i, j, ic, count, total = 0;
+
+    for (i = 0; i < linker->count; i++) {
+        object = MODULE_OBJECT(linker, &linker->modules[i]);
+        total += (int)BINARY_U16(object, BINARY_IC_FIELD) + (int)BINARY_U16(object, BINARY_DC_FIELD);
+    }
+    if (total > linker->word_capacity) {
+        new_words = REALLOC(linker->words, total * sizeof(LinkWord), ALLOC_SITE_OTHER);
+
+        if (!new_words) {
+            print_error(ERR_MEMORY_ALLOCATION, "Failed to load object words");
+            return FALSE;
+        }
+        linker->words = new_words;
+        new_pending = REALLOC(linker->pending, total * sizeof(int), ALLOC_SITE_OTHER);
+
+        if (!new_pending) {
+            print_error(ERR_MEMORY_ALLOCATION, "Failed to load object words");
+            return FALSE;
+        }
+        linker->pending = new_pending;
+        linker->word_capacity = total;
+    }
+    linker->word_count = 0;
+
+    for (i = 0; i < linker->count; i++) {
+        object = MODULE_OBJECT(linker, &linker->modules[i]);
+        words = BINARY_U32(object, BINARY_WORDS_FIELD);
+        ic = (int)BINARY_U16(object, BINARY_IC_FIELD);
+        count = ic + (int)BINARY_U16(object, BINARY_DC_FIELD);
+        linker->modules[i].first_word = linker->word_count;
+
+        for (j = 0; j < count; j++, words += 2) {
+            word = &linker->words[linker->word_count];
+            word->value = (MemoryWord)BINARY_U16(object, words);
+            word->flags = (j < ic) ? LINK_WORD_CODE : 0;
+            word->address = linker->word_count;
+            word->target = -1;
+            linker->word_count++;
+        }
+    }
+    return TRUE;
+}
+
+/*
+Function to add the entry symbols of an object to the global index, at the addresses of their words.
+Entries of eliminated words are left out.
+Receives: Linker *linker - Linker building the image
+          const LinkModule *module - Object to index
+Returns: int - TRUE if all entries were added, FALSE on invalid / duplicate entry
+*/
+static int index_module_entries(Linker *linker, const LinkModule *module) {
+    const unsigned char *object = MODULE_OBJECT(linker, module);
+    unsigned long record = BINARY_U32(object, BINARY_ENTRIES_FIELD);
+    unsigned long i, count = BINARY_U32(object, BINARY_ENTRIES_FIELD + 4);
+    int address, word, data_start, result = TRUE;
+    const char *name;
+
+    data_start = (int)BINARY_U16(object, BINARY_CODE_BASE_FIELD) + (int)BINARY_U16(object, BINARY_IC_FIELD);
+
+    for (i = 0; i < count; i++, record += BINARY_RECORD_SIZE) {
+        name = get_binary_record_name(object, record);
+        address = (int)BINARY_U16(object, record + BINARY_RECORD_ADDRESS);
+        word = get_module_word(object, module, address);
+
+        if (!name || (word < 0)) {
+            print_link_error("Invalid entry record", module, name);
+            result = FALSE;
+        }
+        else if (linker->words[word].address < 0)
+            continue;
+
+        else if (find_symbol(&linker->symtab, name)) {
+            print_link_error("Entry symbol defined by more than one object", module, name);
+            result = FALSE;
+        }
+        else if (add_symbol(&linker->symtab, name, linker->words[word].address,
+                            (address < data_start) ? CODE_SYMBOL : DATA_SYMBOL))
+            linker->symtab.symbols[linker->symtab.count - 1].is_entry = TRUE;
+        else
+            result = FALSE;
+    }
+    return result;
+}
+
+/*
+Function to mark the block starts of an object, and link its label & external operand words to the words they refer to.
+Blocks start at the code & data of every object, at every label it defines, and at every word referred to by an operand.
+Invalid records are skipped here, and reported by relocate_module.
+Receives: Linker *linker - Linker with the words loaded, and the entries indexed by word number
+          const LinkModule *module - Object to scan
+*/
+static void mark_block_starts(Linker *linker, const LinkModule *module) {
+    const unsigned char *object = MODULE_OBJECT(linker, module);
+    unsigned long record, i, count;
+    int word, target, kind, data_word = module->first_word + (int)BINARY_U16(object, BINARY_IC_FIELD);
+    const Symbol *symbol;
+    const char *name;
+
+    if (module->first_word < linker->word_count)
+        linker->words[module->first_word].flags |= LINK_WORD_BLOCK_START;
+
+    if (data_word < linker->word_count)
+        linker->words[data_word].flags |= LINK_WORD_BLOCK_START;
+
+    record = BINARY_U32(object, BINARY_LABELS_FIELD);
+    count = BINARY_U32(object, BINARY_LABELS_FIELD + 4);
+
+    for (i = 0; i < count; i++, record += BINARY_RECORD_SIZE) {
+        word = get_module_word(object, module, (int)BINARY_U16(object, record + BINARY_RECORD_ADDRESS));
+
+        if (word >= 0)
+            linker->words[word].flags |= LINK_WORD_BLOCK_START;
+    }
+    record = BINARY_U32(object, BINARY_RELOCS_FIELD);
+    count = BINARY_U32(object, BINARY_RELOCS_FIELD + 4);
+
+    for (i = 0; i < count; i++, record += BINARY_RECORD_SIZE) {
+        word = get_module_word(object, module, (int)BINARY_U16(object, record + BINARY_RECORD_ADDRESS));
+        kind = (int)BINARY_U16(object, record + BINARY_RECORD_KIND);
+        target = -1;
+
+        if ((word < 0) || !(linker->words[word].flags & LINK_WORD_CODE))
+            continue;
+
+        if (kind == ARE_RELOCATABLE)
+            target = get_module_word(object, module, OPERAND_VALUE(linker->words[word].value));
+
+        else if (kind == ARE_EXTERNAL) {
+            name = get_binary_record_name(object, record);
+            symbol = name ? find_symbol(&linker->symtab, name) : NULL;
+            target = symbol ? symbol->value : -1;
+        }
+        linker->words[word].target = target;
+
+        if (target >= 0)
+            linker->words[target].flags |= LINK_WORD_BLOCK_START;
+    }
+}
+
+/*
+Function to mark a block as reachable, queueing it to be scanned.
+Receives: Linker *linker - Linker eliminating dead code
+          int word - First word of block (-1 if none)
+          int *pending_count - Number of queued blocks, updated
+*/
+static void mark_reachable_block(Linker *linker, int word, int *pending_count) {
+    if ((word < 0) || (linker->words[word].flags & LINK_WORD_REACHABLE))
+        return;
+
+    linker->words[word].flags |= LINK_WORD_REACHABLE;
+    linker->pending[(*pending_count)++] = word;
+}
+
+/*
+Function to scan a reachable block: all its words become reachable, and so do the blocks its operands refer to.
+A code block is decoded instruction by instruction, and ends at the next block start or after a jmp / rts / stop.
+The words after a jmp / rts / stop are reachable only through a label, and every label starts a block.
+Otherwise execution continues to the next code word, as the code of all objects is placed one after another.
+Receives: Linker *linker - Linker eliminating dead code
+          int start - First word of block
+          int *pending_count - Number of queued blocks, updated
+Returns: int - TRUE if scanned, FALSE on an instruction crossing its block
+*/
+static int scan_block(Linker *linker, int start, int *pending_count) {
+    LinkWord *words = linker->words;
+    int end, opcode, word = start;
+
+    if (!(words[start].flags & LINK_WORD_CODE)) {
+        do {
+            words[word++].flags |= LINK_WORD_REACHABLE;
+        } while ((word < linker->word_count) && !(words[word].flags & (LINK_WORD_CODE | LINK_WORD_BLOCK_START)));
+
+        return TRUE;
+    }
+    do {
+        opcode = (words[word].value >> OPCODE_SHIFT) & OPCODE_MASK;
+        end = word + decode_instruction_length(words[word].value);
+        words[word].flags |= LINK_WORD_REACHABLE;
+
+        for (word++; word < end; word++) {
+            if ((word >= linker->word_count) || ((words[word].flags & (LINK_WORD_CODE | LINK_WORD_BLOCK_START)) != LINK_WORD_CODE)) {
+                print_link_error("Invalid instruction", find_word_module(linker, start), NULL);
+                return FALSE;
+            }
+            words[word].flags |= LINK_WORD_REACHABLE;
+            mark_reachable_block(linker, words[word].target, pending_count);
+        }
+    } while (!ENDS_CONTROL_FLOW(opcode) && (word < linker->word_count) &&
+             ((words[word].flags & (LINK_WORD_CODE | LINK_WORD_BLOCK_START)) == LINK_WORD_CODE));
+
+    if (!ENDS_CONTROL_FLOW(opcode)) {
+        while ((word < linker->word_count) && !(words[word].flags & LINK_WORD_CODE)) {
+            word++;  /* Skip the data of the object, its code continues with the code of the next object */
+        }
+        if (word < linker->word_count)
+            mark_reachable_block(linker, word, pending_count);
+    }
+    return TRUE;
+}
+
+/*
+Function to mark the words reachable from the entry point of the program (its first instruction word, at IC_START).
+Blocks are delimited by the labels of all objects & by jmp / rts / stop, unreferenced blocks are never reached.
+Receives: Linker *linker - Linker with the words of all objects loaded
+Returns: int - TRUE if marked, FALSE on invalid / duplicate entry or invalid instruction
+*/
+static int mark_reachable_words(Linker *linker) {
+    int i, word = 0, pending_count = 0, result = TRUE;
+
+    reset_symbol_table(&linker->symtab);
+
+    for (i = 0; i < linker->count; i++) {
+        if (!index_module_entries(linker, &linker->modules[i]))
+            result = FALSE;
+    }
+    if (!result)
+        return FALSE;
+
+    for (i = 0; i < linker->symtab.count; i++) {
+        linker->words[linker->symtab.symbols[i].value].flags |= LINK_WORD_BLOCK_START;
+    }
+    for (i = 0; i < linker->count; i++) {
+        mark_block_starts(linker, &linker->modules[i]);
+    }
+    while ((word < linker->word_count) && !(linker->words[word].flags & LINK_WORD_CODE)) {
+        word++;
+    }
+    if (word < linker->word_count)
+        mark_reachable_block(linker, word, &pending_count);
+
+    while (pending_count > 0) {
+        if (!scan_block(linker, linker->pending[--pending_count], &pending_count))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to assign consecutive addresses to the kept code or data words of all objects, in object order.
+Every run of eliminated words is counted as a block, as is each block start within it.
+Receives: Linker *linker - Linker with the words of all objects loaded
+          int code - LINK_WORD_CODE to place code words, 0 to place data words
+          int address - Address of first placed word
+Returns: int - Address after the last placed word
+*/
+static int place_words(Linker *linker, int code, int address) {
+    LinkWord *word;
+    int i, removing = FALSE;
+
+    for (i = 0; i < linker->word_count; i++) {
+        word = &linker->words[i];
+
+        if ((word->flags & LINK_WORD_CODE) != code)
+            continue;
+
+        if (!linker->remove_dead_code || (word->flags & LINK_WORD_REACHABLE)) {
+            word->address = address++;
+            removing = FALSE;
+        }
+        else {
+            word->address = -1;
+            linker->removed_words++;
+
+            if (!removing || (word->flags & LINK_WORD_BLOCK_START))
+                linker->removed_blocks++;
+
+            removing = TRUE;
+        }
+    }
+    return address;
+}
+
+/*
+Function to assign the code words of all objects consecutive addresses from IC_START,
+and their data words addresses after all code (as in a single .ob file).
+Receives: Linker *linker - Linker with the words of all objects loaded
+Returns: int - TRUE if the placed words fit in memory, FALSE otherwise
+*/
+static int assign_word_addresses(Linker *linker) {
+    int ic, dc;
+
+    ic = place_words(linker, LINK_WORD_CODE, IC_START) - IC_START;
+    dc = place_words(linker, 0, IC_START + ic) - IC_START - ic;
+
+    if ((ic + dc > MAX_LINK_WORDS) || (ic > MAX_IC_SIZE) || (dc > MAX_DC_SIZE)) {
+        print_error("Linked image exceeds memory", "Code & data of all objects must fit in addresses 100-255");
+        return FALSE;
+    }
+    linker->image.ic = ic;
+    linker->image.dc = dc;
+
+    return TRUE;
+}
+
+/*
+Function to copy the kept words of all objects to their linked addresses.
+Receives: Linker *linker - Linker building the image
+*/
+static void copy_linked_words(Linker *linker) {
+    const LinkWord *word;
+    int i;
+
+    for (i = 0; i < linker->word_count; i++) {
+        word = &linker->words[i];
+
+        if (word->address < 0)
+            continue;
+
+        if (word->flags & LINK_WORD_CODE)
+            CODE_WORD(&linker->image, word->address) = word->value;
+        else
+            linker->image.data[word->address - IC_START - linker->image.ic] = word->value;
+    }
+}
+
+/*
+Function to patch the label words of an object by its relocation records:
+relocatable words are moved to the linked address of their label,
+and external words receive the linked address of the entry symbol they refer to.
+Every patched word is recorded as relocatable in the relocation list of the image, eliminated words are skipped.
+Receives: Linker *linker - Linker building the image (with all entries indexed)
+          const LinkModule *module - Object to relocate
+Returns: int - TRUE if all words were patched, FALSE on unresolved external / invalid record
+*/
+static int relocate_module(Linker *linker, const LinkModule *module) {
+    const unsigned char *object = MODULE_OBJECT(linker, module);
+    unsigned long record = BINARY_U32(object, BINARY_RELOCS_FIELD);
+    unsigned long i, count = BINARY_U32(object, BINARY_RELOCS_FIELD + 4);
+    int address, word, target, kind, result = TRUE;
+    const Symbol *symbol;
+    const char *name;
+    MemoryWord *image_word;
+
+    for (i = 0; i < count; i++, record += BINARY_RECORD_SIZE) {
+        word = get_module_word(object, module, (int)BINARY_U16(object, record + BINARY_RECORD_ADDRESS));
+        kind = (int)BINARY_U16(object, record + BINARY_RECORD_KIND);
+
+        if ((word < 0) || !(linker->words[word].flags & LINK_WORD_CODE) || (linker->image.relocation_count >= MAX_IC_SIZE)) {
+            print_link_error("Invalid relocation record", module, NULL);
+            result = FALSE;
+            continue;
+        }
+        address = linker->words[word].address;
+
+        if (address < 0)
+            continue;
+
+        image_word = &CODE_WORD(&linker->image, address);
+
+        if (kind == ARE_RELOCATABLE) {
+            target = get_module_word(object, module, OPERAND_VALUE(*image_word));
+
+            if ((target < 0) || (linker->words[target].address < 0)) {
+                print_link_error("Invalid relocation record", module, NULL);
+                result = FALSE;
+                continue;
+            }
+            *image_word = PACK_OPERAND_WORD(linker->words[target].address, ARE_RELOCATABLE);
+        }
+        else if (kind == ARE_EXTERNAL) {
+            name = get_binary_record_name(object, record);
+            symbol = name ? find_symbol(&linker->symtab, name) : NULL;
+
+            if (!symbol) {
+                print_link_error("Unresolved external symbol", module, name);
+                result = FALSE;
+                continue;
+            }
+            *image_word = PACK_OPERAND_WORD(symbol->value, ARE_RELOCATABLE);
+        }
+        else {
+            print_link_error("Invalid relocation record", module, NULL);
+            result = FALSE;
+            continue;
+        }
+        add_relocation(&linker->image, address, ARE_RELOCATABLE, -1);
+    }
+    return result;
+}
+
+/*
+Function to add the entry symbols of an object to the set of defined symbols, while archive members are pulled.
+Entries already defined are skipped, duplicates are reported by link_objects.
+Receives: Linker *linker - Linker pulling archive members
+          int module_index - Index of object
+Returns: int - TRUE if added, FALSE on memory error
+*/
+static int add_defined_entries(Linker *linker, int module_index) {
+    const unsigned char *object = MODULE_OBJECT(linker, &linker->modules[module_index]);
+    unsigned long record = BINARY_U32(object, BINARY_ENTRIES_FIELD);
+    unsigned long i, count = BINARY_U32(object, BINARY_ENTRIES_FIELD + 4);
+    const char *name;
+
+    for (i = 0; i < count; i++, record += BINARY_RECORD_SIZE) {
+        name = get_binary_record_name(object, record);
+
+        if (name && !find_symbol(&linker->symtab, name) &&
+            !add_symbol(&linker->symtab, name, 0, CODE_SYMBOL))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to read the first archive member defining a symbol (in command line order) and add it to the objects being linked.
+Each member is added at most once.
+Receives: Linker *linker - Linker pulling archive members
+          Archive archives[] - Opened archives
+          int archive_count - Number of archives
+          const char *name - Undefined symbol
+Returns: int - TRUE if added or no archive defines the symbol, FALSE on read / invalid member
+*/
+static int pull_archive_member(Linker *linker, Archive archives[], int archive_count, const char *name) {
+    long member;
+    int i;
+
+    for (i = 0; i < archive_count; i++) {
+        member = find_archive_symbol(&archives[i], name);
+
+        if (member < 0)
+            continue;
+
+        if (archives[i].loaded[member])
+            return TRUE;
+
+        archives[i].loaded[member] = TRUE;
+
+        return read_archive_member(&archives[i], (unsigned long)member, &linker->scratch) &&
+               add_link_module(linker, get_archive_member_name(&archives[i], (unsigned long)member),
+                               linker->scratch.text, linker->scratch.length) &&
+               add_defined_entries(linker, linker->count - 1);
+    }
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to initialize a linker with no objects.
+Receives: Linker *linker - Linker to initialize
+Returns: int - TRUE if initialized, FALSE on memory error
+*/
+int init_linker(Linker *linker) {
+    linker->modules = NULL;
+    linker->count = 0;
+    linker->capacity = 0;
+    linker->words = NULL;
+    linker->pending = NULL;
+    linker->word_count = 0;
+    linker->word_capacity = 0;
+    linker->remove_dead_code = FALSE;
+    linker->removed_blocks = 0;
+    linker->removed_words = 0;
+    init_memory(&linker->image);
+
+    if (!init_source_buffer(&linker->objects))
+        return FALSE;
+
+    if (!init_source_buffer(&linker->scratch)) {
+        free_source_buffer(&linker->objects);
+        return FALSE;
+    }
+    if (!init_symbol_table(&linker->symtab)) {
+        free_source_buffer(&linker->objects);
+        free_source_buffer(&linker->scratch);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to free all resources held by a linker.
+Receives: Linker *linker - Linker to free
+*/
+void free_linker(Linker *linker) {
+    FREE(linker->modules);
+    linker->modules = NULL;
+    linker->count = 0;
+    linker->capacity = 0;
+
+    FREE(linker->words);
+    FREE(linker->pending);
+    linker->words = NULL;
+    linker->pending = NULL;
+    linker->word_count = 0;
+    linker->word_capacity = 0;
+
+    free_source_buffer(&linker->objects);
+    free_source_buffer(&linker->scratch);
+    free_symbol_table(&linker->symtab);
+}
+
+/*
+Function to add a binary object held in memory to the objects being linked (copied, in command line order).
+Receives: Linker *linker - Linker to add to
+          const char *name - Object name for messages (kept by caller until linking ends)
+          const char *data - Binary object contents
+          size_t length - Length of contents
+Returns: int - TRUE if added, FALSE on invalid object / memory error
+*/
+int add_link_module(Linker *linker, const char *name, const char *data, size_t length) {
+    LinkModule *new_modules, *module;
+
+    if (!check_binary_object((const unsigned char *)data, length)) {
+        print_error("Invalid binary object", name);
+        return FALSE;
+    }
+    if (linker->count == linker->capacity) {
+        new_modules = REALLOC(linker->modules, (linker->capacity ? linker->capacity * 2 : INITIAL_LINK_MODULES) * sizeof(LinkModule), ALLOC_SITE_OTHER);
+
+        if (!new_modules) {
+            print_error(ERR_MEMORY_ALLOCATION, "Failed to add object");
+            return FALSE;
+        }
+        linker->modules = new_modules;
+        linker->capacity = linker->capacity ? linker->capacity * 2 : INITIAL_LINK_MODULES;
+    }
+    module = &linker->modules[linker->count];
+    module->name = name;
+    module->offset = linker->objects.length;
+    module->length = length;
+
+    if (!append_source_span(&linker->objects, data, length))
+        return FALSE;
+
+    linker->count++;
+    return TRUE;
+}
+
+/*
+Function to read a binary object file (<base_filename>.bin) and add it to the objects being linked.
+Receives: Linker *linker - Linker to add to
+          const char *base_filename - Object filename without extension (kept by caller until linking ends)
+Returns: int - TRUE if added, FALSE if missing / invalid
+*/
+int add_link_object(Linker *linker, const char *base_filename) {
+    char filename[MAX_FILENAME_LENGTH];
+
+    if (strlen(base_filename) + strlen(FILE_EXT_BINARY) >= MAX_FILENAME_LENGTH) {
+        print_error("Filename is too long", base_filename);
+        return FALSE;
+    }
+    sprintf(filename, "%s%s", base_filename, FILE_EXT_BINARY);
+
+    if (!read_input_file(&linker->scratch, filename)) {
+        print_error("File not found", filename);
+        return FALSE;
+    }
+    return add_link_module(linker, base_filename, linker->scratch.text, linker->scratch.length);
+}
+
+/*
+Function to add the archive members needed by the objects being linked, as a static library:
+every external symbol not defined by an added object is looked up in the symbol index of the archives,
+and the member defining it is read & added. Added members are scanned too, until no external is left to pull.
+Only the archive directories and the needed members are read.
+Receives: Linker *linker - Linker holding the command line objects
+          Archive archives[] - Opened archives (member names are used until linking ends)
+          int archive_count - Number of archives
+Returns: int - TRUE if all needed members were added, FALSE on read / invalid member
+*/
+int add_archive_members(Linker *linker, Archive archives[], int archive_count) {
+    const unsigned char *object;
+    unsigned long record, j, count;
+    const char *name;
+    int i;
+
+    reset_symbol_table(&linker->symtab);
+
+    for (i = 0; i < linker->count; i++) {
+        if (!add_defined_entries(linker, i))
+            return FALSE;
+    }
+    for (i = 0; i < linker->count; i++) {
+        object = MODULE_OBJECT(linker, &linker->modules[i]);
+        record = BINARY_U32(object, BINARY_EXTERNS_FIELD);
+        count = BINARY_U32(object, BINARY_EXTERNS_FIELD + 4);
+
+        for (j = 0; j < count; j++, record += BINARY_RECORD_SIZE) {
+            name = get_binary_record_name(object, record);
+
+            if (!name || find_symbol(&linker->symtab, name))
+                continue;
+
+            if (!pull_archive_member(linker, archives, archive_count, name))
+                return FALSE;
+
+            /* Adding a member may move the objects buffer */
+            object = MODULE_OBJECT(linker, &linker->modules[i]);
+        }
+    }
+    return TRUE;
+}
+
+/*
+Function to link all added objects into a single executable image:
+loads the words of all objects, keeps only the blocks reachable from the entry point when remove_dead_code is set,
+assigns addresses to the kept words, indexes the entry symbols of all objects in the global symbol table (hashed),
+copies the kept words, then patches their relocatable & external words.
+Elimination happens before addresses are assigned, so the objects only have to fit in memory once shrunk.
+Each stage is linear in the total words & symbols, whatever the number of objects.
+Receives: Linker *linker - Linker holding the objects
+Returns: int - TRUE if linked (image & symtab are valid), FALSE on any error (all errors are reported)
+*/
+int link_objects(Linker *linker) {
+    int i, result = TRUE;
+
+    init_memory(&linker->image);
+    linker->removed_blocks = 0;
+    linker->removed_words = 0;
+
+    if (!load_module_words(linker) ||
+        (linker->remove_dead_code && !mark_reachable_words(linker)) ||
+        !assign_word_addresses(linker))
+        return FALSE;
+
+    reset_symbol_table(&linker->symtab);
+
+    for (i = 0; i < linker->count; i++) {
+        if (!index_module_entries(linker, &linker->modules[i]))
+            result = FALSE;
+    }
+    copy_linked_words(linker);
+
+    for (i = 0; i < linker->count; i++) {
+        if (!relocate_module(linker, &linker->modules[i]))
+            result = FALSE;
+    }
+    return result;
+}
\ No newline at end of file
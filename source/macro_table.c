@@ -9,6 +9,8 @@
 #include "instructions.h"
 #include "directives.h"
 #include "macro_table.h"
+#include "keywords.h"
+#include "alloc_tracking.h"
 
 /* Inner STATIC methods */
 /* ==================================================================== */
@@ -25,7 +27,7 @@ static int resize_macro_body(Macro *macro) {
         return FALSE;
 
     new_capacity = (macro->body_capacity == 0) ? INITIAL_MACRO_BODY_CAPACITY : macro->body_capacity * 2;
-    new_body = realloc(macro->body, new_capacity * sizeof(char*));
+    new_body = REALLOC(macro->body, new_capacity * sizeof(char*), ALLOC_SITE_MACRO_BODIES);
 
     if (!new_body) {
         print_error(ERR_MEMORY_ALLOCATION, "Failed to resize macro body");
@@ -37,8 +39,26 @@ static int resize_macro_body(Macro *macro) {
     return TRUE;
 }
 
+/*
+Function to empty a range of macro slots, with no body allocated.
+Receives: Macro *macros - Macros array
+          int from - First slot to empty
+          int to - Slot right after the last one to empty
+*/
+static void clear_macro_slots(Macro *macros, int from, int to) {
+    int i;
+
+    for (i = from; i < to; i++) {
+        macros[i].name[0] = NULL_TERMINATOR;
+        macros[i].body = NULL;
+        macros[i].line_count = 0;
+        macros[i].body_capacity = 0;
+    }
+}
+
 /*
 Function to resize the macro table when more space is needed.
+New slots are emptied, so every slot up to the capacity owns a valid (maybe NULL) body.
 Receives: MacroTable *table - Pointer to the macro table to resize
 Returns: int - TRUE if resizing succeeded, FALSE otherwise
 */
@@ -47,18 +67,100 @@ static int resize_macro_table(MacroTable *table) {
     Macro *new_macros;
 
     new_capacity = (table->capacity == 0) ? INITIAL_MACROS_CAPACITY : table->capacity * 2;
-    new_macros = realloc(table->macros, new_capacity * sizeof(Macro));
+    new_macros = REALLOC(table->macros, new_capacity * sizeof(Macro), ALLOC_SITE_MACROS);
 
     if (!new_macros) {
         print_error(ERR_MEMORY_ALLOCATION, "Failed to resize macro table");
         return FALSE;
     }
+    clear_macro_slots(new_macros, table->capacity, new_capacity);
     table->macros = new_macros;
     table->capacity = new_capacity;
 
     return TRUE;
 }
 
+/*
+Function to locate the index slot of a macro name span, using linear probing.
+Receives: const MacroTable *table - Table to search
+          const char *name - Start of the name (not necessarily null terminated)
+          size_t length - Length of the name
+          unsigned long hash - Hash of the name span
+Returns: int - Slot holding the macro, or the empty slot where it belongs
+*/
+static int find_slot(const MacroTable *table, const char *name, size_t length, unsigned long hash) {
+    int mask = table->index_capacity - 1;
+    int slot = (int)(hash & mask);
+    const char *slot_name;
+
+    while (table->index[slot] != EMPTY_MACRO_SLOT) {
+        slot_name = table->macros[table->index[slot]].name;
+
+        if ((strncmp(slot_name, name, length) == 0) &&
+            (slot_name[length] == NULL_TERMINATOR))
+            break;
+
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/*
+Function to allocate an empty hash index with the given amount of slots.
+Receives: MacroTable *table - Table owning the index
+          int capacity - Amount of slots (power of 2)
+Returns: int - TRUE if allocation succeeded, FALSE otherwise
+*/
+static int allocate_index(MacroTable *table, int capacity) {
+    int i;
+    int *new_index = ALLOC(capacity * sizeof(int), ALLOC_SITE_MACRO_INDEX);
+
+    if (!new_index) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize macro index");
+        return FALSE;
+    }
+    for (i = 0; i < capacity; i++) {
+        new_index[i] = EMPTY_MACRO_SLOT;
+    }
+    safe_free((void**)&table->index);
+    table->index = new_index;
+    table->index_capacity = capacity;
+
+    return TRUE;
+}
+
+/*
+Function to register the macro at the given position in the hash index & bloom bits.
+Receives: MacroTable *table - Table owning the index
+          int position - Position of the macro in macros array
+*/
+static void index_macro(MacroTable *table, int position) {
+    const char *name = table->macros[position].name;
+    size_t length = strlen(name);
+    unsigned long hash = hash_span(name, length);
+
+    table->index[find_slot(table, name, length, hash)] = position;
+    table->bloom[BLOOM_WORD(hash)] |= BLOOM_MASK(hash);
+    table->bloom[BLOOM_WORD(hash >> 16)] |= BLOOM_MASK(hash >> 16);
+}
+
+/*
+Function to double the hash index, and re-insert all stored macros.
+Receives: MacroTable *table - Table to re-index
+Returns: int - TRUE if resize succeeded, FALSE otherwise
+*/
+static int resize_macro_index(MacroTable *table) {
+    int i;
+
+    if (!allocate_index(table, table->index_capacity * 2))
+        return FALSE;
+
+    for (i = 0; i < table->count; i++) {
+        index_macro(table, i);
+    }
+    return TRUE;
+}
+
 /*
 Function to validate macro syntax.
 Checks:
@@ -97,7 +199,7 @@ static int is_valid_syntax(const char *macro) {
 }
 
 /*
-Function to check if macro matches any reserved keywords.
+Function to check if macro matches any reserved keywords, with a single keyword lookup.
 Checks:
 - Register names (r0-r7, PSW)
 - Instruction names
@@ -107,27 +209,27 @@ Receives: const char *macro - The macro name to check
 Returns: int - TRUE if name is a reserved word, FALSE otherwise
 */
 static int is_reserved_word(const char *macro) {
-    if (IS_REGISTER_OR_PSW(macro)) {
-        print_error("Macro name cannot be register (r0 - r7 / PSW)", macro);
-        return TRUE;
-    }
-    if (IS_INSTRUCTION(macro)) {
-        print_error("Macro name cannot be instruction (mov / cmp / add / ...)", macro);
-        return TRUE;
-    }
-    if (IS_DIRECTIVE(macro)) {
-        print_error("Macro name cannot be directive (.data / .string / .mat / .entry / .extern)", macro);
-        return TRUE;
-    }
-    if (IS_MACRO_KEYWORD(macro)) {
-        print_error("Macro name cannot be macro keyword (mcro / mcroend)", macro);
-        return TRUE;
+    switch (get_keyword_class(macro)) {
+        case KEYWORD_REGISTER:
+            print_error("Macro name cannot be register (r0 - r7 / PSW)", macro);
+            return TRUE;
+        case KEYWORD_INSTRUCTION:
+            print_error("Macro name cannot be instruction (mov / cmp / add / ...)", macro);
+            return TRUE;
+        case KEYWORD_DIRECTIVE:
+            print_error("Macro name cannot be directive (.data / .string / .mat / .entry / .extern)", macro);
+            return TRUE;
+        case KEYWORD_MACRO:
+            print_error("Macro name cannot be macro keyword (mcro / mcroend)", macro);
+            return TRUE;
+        default:
+            return FALSE;
     }
-    return FALSE;
 }
 
 /*
 Function to initialize a macro with default values and sets its name.
+A body left in the slot by a previous source is kept, and reused for the new lines.
 Receives: Macro *macro - Pointer to the Macro structure to initialize
           const char *name - Name to assign to the macro
 Returns: int - TRUE if initialization succeeded, FALSE otherwise
@@ -140,15 +242,13 @@ static int init_macro(Macro *macro, const char *name) {
     strncpy(macro->name, name, MAX_MACRO_NAME_LENGTH - 1);
     macro->name[MAX_MACRO_NAME_LENGTH - 1] = NULL_TERMINATOR;
 
-    macro->body = NULL;
     macro->line_count = 0;
-    macro->body_capacity = INITIAL_MACRO_BODY_CAPACITY;
 
     return TRUE;
 }
 
 /*
-Function to store a new macro in the macro table.
+Function to store a new macro in the macro table, and register it in the hash index.
 Receives: MacroTable *table - Pointer to the macro table
           const char *name - Name of the macro to store
 Returns: int - TRUE if storage succeeded, FALSE otherwise
@@ -157,26 +257,22 @@ static int store_macro(MacroTable *table, const char *name) {
     if (!init_macro(&table->macros[table->count], name))
         return FALSE;
 
+    index_macro(table, table->count);
     table->count++;
     return TRUE;
 }
 
 /*
 Function to free all memory allocated for a macro and resets it.
+Body lines themselves are owned by the table arena.
 Receives: Macro *macro - Pointer to the macro to free
 */
 void free_macro(Macro *macro) {
-    int i;
-
     if (!macro)
         return;
 
-    if (macro->body) {
-        for (i = 0; i < macro->line_count; i++) {
-            safe_free((void**)&macro->body[i]);
-        }
-        safe_free((void**)&macro->body);
-    }
+    safe_free((void**)&macro->body);
+
     macro->line_count = 0;
     macro->body_capacity = 0;
     macro->name[0] = NULL_TERMINATOR;
@@ -185,19 +281,31 @@ void free_macro(Macro *macro) {
 /* Outer methods */
 /* ==================================================================== */
 /*
-Function to initialize an empty macro table with default capacity.
+Function to initialize an empty macro table & its hash index with default capacity.
 Receives: MacroTable *table - Pointer to the table to initialize
 Returns: int - TRUE if initialization succeeded, FALSE otherwise
 */
 int init_macro_table(MacroTable *table) {
-    table->macros = malloc(INITIAL_MACROS_CAPACITY * sizeof(Macro));
+    int i;
 
-    if (!table->macros) {
+    table->count = 0;
+    table->index = NULL;
+    table->macros = ALLOC(INITIAL_MACROS_CAPACITY * sizeof(Macro), ALLOC_SITE_MACROS);
+
+    if (!init_arena(&table->text, TEXT_ARENA_SIZE) || !table->macros ||
+        !allocate_index(table, INITIAL_MACRO_INDEX_CAPACITY)) {
         print_error(ERR_MEMORY_ALLOCATION, "for macro table initialization");
+        safe_free((void**)&table->macros);
+        safe_free((void**)&table->index);
+        free_arena(&table->text);
         return FALSE;
     }
-    table->count = 0;
     table->capacity = INITIAL_MACROS_CAPACITY;
+    clear_macro_slots(table->macros, 0, table->capacity);
+
+    for (i = 0; i < MACRO_BLOOM_WORDS; i++) {
+        table->bloom[i] = 0;
+    }
 
     return TRUE;
 }
@@ -212,13 +320,38 @@ void free_macro_table(MacroTable *table) {
     if (!table || !table->macros)
         return;
 
-    for (i = 0; i < table->count; i++) {
+    for (i = 0; i < table->capacity; i++) {
         free_macro(&table->macros[i]);
     }
     safe_free((void**)&table->macros);
+    safe_free((void**)&table->index);
+    free_arena(&table->text);
 
     table->count = 0;
     table->capacity = 0;
+    table->index_capacity = 0;
+}
+
+/*
+Function to empty the macro table for the next source, keeping its allocations.
+Macro bodies are kept in their slots, and reused by the macros of the next source.
+Receives: MacroTable *table - Pointer to the table to reset
+*/
+void reset_macro_table(MacroTable *table) {
+    int i;
+
+    for (i = 0; i < table->count; i++) {
+        table->macros[i].line_count = 0;
+        table->macros[i].name[0] = NULL_TERMINATOR;
+    }
+    for (i = 0; i < table->index_capacity; i++) {
+        table->index[i] = EMPTY_MACRO_SLOT;
+    }
+    for (i = 0; i < MACRO_BLOOM_WORDS; i++) {
+        table->bloom[i] = 0;
+    }
+    reset_arena(&table->text);
+    table->count = 0;
 }
 
 /*
@@ -236,6 +369,32 @@ int is_valid_macro_start(const char *macro) {
     return TRUE;
 }
 
+/*
+Function to find a macro in the table by a name span, without copying it.
+Names that miss a bloom bit are rejected before touching the hash index.
+Receives: const MacroTable *table - Pointer to the table to search
+          const char *name - Start of the name (not necessarily null terminated)
+          size_t length - Length of the name
+Returns: const Macro* - Pointer to found macro or NULL if not found
+*/
+const Macro *find_macro_span(const MacroTable *table, const char *name, size_t length) {
+    unsigned long hash;
+    int position;
+
+    if ((table->count == 0) || (length == 0) || (length >= MAX_MACRO_NAME_LENGTH))
+        return NULL;
+
+    hash = hash_span(name, length);
+
+    if (!(table->bloom[BLOOM_WORD(hash)] & BLOOM_MASK(hash)) ||
+        !(table->bloom[BLOOM_WORD(hash >> 16)] & BLOOM_MASK(hash >> 16)))
+        return NULL;
+
+    position = table->index[find_slot(table, name, length, hash)];
+
+    return (position == EMPTY_MACRO_SLOT) ? NULL : &table->macros[position];
+}
+
 /*
 Function to find a macro in the table by name.
 Receives: const MacroTable *table - Pointer to the table to search
@@ -243,13 +402,7 @@ Receives: const MacroTable *table - Pointer to the table to search
 Returns: const Macro* - Pointer to found macro or NULL if not found
 */
 const Macro *find_macro(const MacroTable *table, const char *macro) {
-    int i;
-
-    for (i = 0; i < table->count; i++) {
-        if (strcmp(table->macros[i].name, macro) == 0)
-            return &table->macros[i];
-    }
-    return NULL;
+    return find_macro_span(table, macro, strlen(macro));
 }
 
 /*
@@ -271,6 +424,10 @@ int add_macro(MacroTable *table, const char *name) {
         (!resize_macro_table(table)))
         return FALSE;
 
+    if (((table->count + 1) * 2 > table->index_capacity) &&
+        (!resize_macro_index(table)))
+        return FALSE;
+
     if (!store_macro(table, name)) {
         print_error("Failed to store macro", name);
         return FALSE;
@@ -280,16 +437,18 @@ int add_macro(MacroTable *table, const char *name) {
 
 /*
 Function to add a string line to a macro, resizing body if needed.
-Receives: Macro *macro - Pointer to the macro to add to
+The line text is copied into the table arena.
+Receives: MacroTable *table - Pointer to the macro table owning the text
+          Macro *macro - Pointer to the macro to add to
           const char *line_content - The line content to add
 Returns: int - TRUE if addition succeeded, FALSE otherwise
 */
-int add_line_to_macro(Macro *macro, const char *line_content) {
+int add_line_to_macro(MacroTable *table, Macro *macro, const char *line_content) {
     if (!macro || !line_content || (line_content[0] == NULL_TERMINATOR))
         return FALSE;
 
     if (!macro->body) {
-        macro->body = malloc(INITIAL_MACRO_BODY_CAPACITY * sizeof(char*));
+        macro->body = ALLOC(INITIAL_MACRO_BODY_CAPACITY * sizeof(char*), ALLOC_SITE_MACRO_BODIES);
 
         if (!macro->body) {
             print_error(ERR_MEMORY_ALLOCATION, "Failed to allocate macro body");
@@ -301,7 +460,7 @@ int add_line_to_macro(Macro *macro, const char *line_content) {
              (!resize_macro_body(macro)))
         return FALSE;
 
-    macro->body[macro->line_count] = copy_string(line_content);
+    macro->body[macro->line_count] = arena_copy_string(&table->text, line_content);
 
     if (!macro->body[macro->line_count]) {
         print_error(ERR_MEMORY_ALLOCATION, "Failed to allocate memory for macro line");
@@ -313,29 +472,38 @@ int add_line_to_macro(Macro *macro, const char *line_content) {
 
 /*
 Function to check if a line contains a valid macro call.
+The line is scanned in place (no copy), and the name span is looked up directly.
 Receives: const char *line - The line to check
           const MacroTable *table - Pointer to the macro table
 Returns: int - TRUE if line contains a macro call, FALSE otherwise
 */
 int is_macro_call(const char *line, const MacroTable *table) {
-    char trimmed[MAX_LINE_LENGTH];
-    char *colon_pos, *macro_part;
+    const char *start, *end, *colon_pos;
 
-    strcpy(trimmed, line);
-    trim_whitespace(trimmed);
+    if (table->count == 0)
+        return FALSE;
+
+    start = line;
 
-    colon_pos = strchr(trimmed, LABEL_TERMINATOR);
+    while (isspace(*start)) {
+        start++;
+    }
+    end = start + strlen(start);
+
+    while ((end > start) && isspace(*(end - 1))) {
+        end--;
+    }
+    colon_pos = memchr(start, LABEL_TERMINATOR, end - start);
 
     if (colon_pos) {
-        if (!isspace(*(colon_pos + 1)))
+        if ((colon_pos + 1 == end) || !isspace(*(colon_pos + 1)))
             return FALSE;
 
-        macro_part = colon_pos + 1;
+        start = colon_pos + 1;
 
-        while (isspace(*macro_part)) {
-            macro_part++;
+        while (isspace(*start)) {
+            start++;
         }
-        return (find_macro(table, macro_part) != NULL);
     }
-    return (find_macro(table, trimmed) != NULL);
+    return (find_macro_span(table, start, end - start) != NULL);
 }
\ No newline at end of file
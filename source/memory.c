@@ -6,18 +6,14 @@
 #include "errors.h"
 
 /*
-Function to initialize a MemoryImage structure with default values, and clears all memory words
+Function to initialize a MemoryImage structure with default values.
+Words are not cleared, as only words below the counters are ever read, and each is written before counted.
 Receives: MemoryImage *memory - Pointer to memory structure to initialize
 */
 void init_memory(MemoryImage *memory) {
-    int i;
-
     memory->ic = 0;
     memory->dc = 0;
-
-    for (i = 0; i < MAX_WORD_COUNT; i++) {
-        memset(&memory->words[i], 0, sizeof(MemoryWord));
-    }
+    memory->relocation_count = 0;
 }
 
 /*
@@ -59,8 +55,24 @@ int store_value(MemoryImage *memory, int value) {
     if (!check_dc_limit(memory->dc))
         return FALSE;
 
-    memory->words[memory->dc].data.value = value & WORD_MASK;
+    memory->data[memory->dc] = (MemoryWord)(value & WORD_MASK);
     memory->dc++;
 
     return TRUE;
+}
+
+/*
+Function to record a resolved symbol operand word in the relocation list.
+Symbol operands are resolved in source order, so the list stays in address order.
+Receives: MemoryImage *memory - Target memory structure
+          int address - Absolute address of the operand word
+          int are - ARE_RELOCATABLE / ARE_EXTERNAL
+          int symbol_index - Index of the symbol in the symbol table
+*/
+void add_relocation(MemoryImage *memory, int address, int are, int symbol_index) {
+    Relocation *relocation = &memory->relocations[memory->relocation_count++];
+
+    relocation->address = (unsigned short)address;
+    relocation->symbol_index = symbol_index;
+    relocation->are = (unsigned char)are;
 }
\ No newline at end of file
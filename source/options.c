@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "options.h"
+#include "file_io.h"
+#include "cache.h"
+#include "protocol.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to apply a single command line flag to the options structure.
+Receives: const char *arg - Command line flag (starts with "--")
+          AssemblerOptions *options - Options to update
+Returns: int - TRUE if flag is known, FALSE otherwise
+*/
+static int apply_option(const char *arg, AssemblerOptions *options) {
+    if (strcmp(arg, OPTION_KEEP_AM) == 0) {
+        options->keep_am = TRUE;
+        return TRUE;
+    }
+    if (strcmp(arg, OPTION_STATS) == 0) {
+        options->stats = TRUE;
+        return TRUE;
+    }
+    if (strcmp(arg, OPTION_RELOC) == 0) {
+        options->write_relocations = TRUE;
+        return TRUE;
+    }
+    if (strcmp(arg, OPTION_BINARY) == 0) {
+        options->write_binary = TRUE;
+        return TRUE;
+    }
+    print_error("Unknown option", arg);
+    return FALSE;
+}
+
+/*
+Function to parse a numeric flag value within a range.
+Receives: const char *arg - Value to parse
+          long min - Lowest valid value
+          long max - Highest valid value
+          long *value - Output parsed value
+Returns: int - TRUE if arg is a number between min and max, FALSE otherwise
+*/
+static int parse_number(const char *arg, long min, long max, long *value) {
+    char *end;
+
+    *value = strtol(arg, &end, BASE10_ENCODING);
+
+    return ((end != arg) && (*end == NULL_TERMINATOR) && (*value >= min) && (*value <= max));
+}
+
+/*
+Function to apply a command line flag that is followed by a value (-j N, --cache-dir DIR, --cache-size KB, --serve PATH).
+Receives: const char *flag - Command line flag
+          const char *arg - Argument following the flag (NULL if missing)
+          AssemblerOptions *options - Options to update
+Returns: int - TRUE if value is valid for the flag, FALSE otherwise
+*/
+static int apply_value_option(const char *flag, const char *arg, AssemblerOptions *options) {
+    long value;
+
+    if (!arg) {
+        print_error("Missing value of option", flag);
+        return FALSE;
+    }
+    if (strcmp(flag, OPTION_CACHE_DIR) == 0) {
+        if ((*arg == NULL_TERMINATOR) || (strlen(arg) >= MAX_CACHE_DIR_LENGTH)) {
+            print_error("Invalid cache directory", arg);
+            return FALSE;
+        }
+        options->cache_dir = arg;
+        return TRUE;
+    }
+    if (strcmp(flag, OPTION_SERVE) == 0) {
+        if ((*arg == NULL_TERMINATOR) || (strlen(arg) >= MAX_SOCKET_PATH_LENGTH)) {
+            print_error("Invalid socket path", arg);
+            return FALSE;
+        }
+        options->serve_socket = arg;
+        return TRUE;
+    }
+    if (strcmp(flag, OPTION_CACHE_SIZE) == 0) {
+        if (!parse_number(arg, 0, MAX_CACHE_SIZE, &value)) {
+            print_error("Invalid cache size (expected 0-1048576 KB)", arg);
+            return FALSE;
+        }
+        options->cache_size = value * BYTES_PER_KILOBYTE;
+        return TRUE;
+    }
+    if (!parse_number(arg, 1, MAX_JOBS, &value)) {
+        print_error("Invalid job count (expected 1-64)", arg);
+        return FALSE;
+    }
+    options->jobs = (int)value;
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to split command line arguments into flags and base filenames.
+Receives: int argc - Number of command line arguments
+          char *argv[] - Array of command line arguments
+          AssemblerOptions *options - Output options structure
+Returns: int - TRUE if arguments are valid, FALSE otherwise
+*/
+int parse_options(int argc, char *argv[], AssemblerOptions *options) {
+    int i;
+
+    options->file_count = 0;
+    options->keep_am = FALSE;
+    options->stats = FALSE;
+    options->write_relocations = FALSE;
+    options->write_binary = FALSE;
+    options->jobs = 1;
+    options->cache_dir = NULL;
+    options->cache_size = 0;
+    options->serve_socket = NULL;
+    options->files = ALLOC(argc * sizeof(char *), ALLOC_SITE_OTHER);
+
+    if (!options->files) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to parse command line");
+        return FALSE;
+    }
+    for (i = 1; i < argc; i++) {
+        if (IS_VALUE_OPTION(argv[i])) {
+            if (!apply_value_option(argv[i], (i + 1 < argc) ? argv[i + 1] : NULL, options)) {
+                free_options(options);
+                return FALSE;
+            }
+            i++; /* skip the value */
+        }
+        else if (!IS_OPTION(argv[i])) {
+            if (strlen(argv[i]) >= MAX_FILENAME_LENGTH - MAX_EXTENSION_LENGTH) {
+                print_error("Filename too long", NULL);
+                free_options(options);
+                return FALSE;
+            }
+            options->files[options->file_count++] = argv[i];
+        }
+
+        else if (!apply_option(argv[i], options)) {
+            free_options(options);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*
+Function to free resources held by the options structure.
+Receives: AssemblerOptions *options - Options to free
+*/
+void free_options(AssemblerOptions *options) {
+    safe_free((void**)&options->files);
+    options->file_count = 0;
+}
\ No newline at end of file
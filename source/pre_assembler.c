@@ -6,6 +6,7 @@
 #include "utils.h"
 #include "errors.h"
 #include "macro_table.h"
+#include "source_buffer.h"
 #include "file_io.h"
 
 /* Inner STATIC methods */
@@ -30,21 +31,19 @@ static int is_empty_line(const char *line) {
 
 /*
 Function to validate that a line doesn't exceed max of 80 characters.
-Receives: const char *line - The line to check
-          FILE *fp - Pointer to the source file (for consuming long lines)
+Receives: const char *line - Start of the line span
+          size_t length - Length of the line span (including newline, if present)
           int line_num - Current line number for error reporting
 Returns: int - TRUE if line length is valid, FALSE otherwise
 */
-static int check_line_length(const char *line, FILE *fp, int line_num) {
-    int character;
+static int check_line_length(const char *line, size_t length, int line_num) {
+    size_t content_length = length;
 
-    if (strlen(line) == MAX_LINE_LENGTH - 1 &&
-        line[MAX_LINE_LENGTH - 2] != NEWLINE) {
-        print_line_error("Line over 80 characters", NULL, line_num);
+    if ((length > 0) && (line[length - 1] == NEWLINE))
+        content_length--;
 
-        while (((character = fgetc(fp)) != NEWLINE) && (character != EOF)){
-            /* Consume the rest of the oversized line to sync the file pointer */
-        }
+    if (content_length >= MAX_LINE_LENGTH - 1) {
+        print_line_error("Line over 80 characters", NULL, line_num);
         return FALSE;
     }
     return TRUE;
@@ -53,11 +52,11 @@ static int check_line_length(const char *line, FILE *fp, int line_num) {
 /*
 Function to extract the macro name from a line that may contain a label.
 Receives: const char *line - The line containing potential macro call
-Returns: char* - Pointer to static buffer containing extracted macro name
+          char *temp_buffer - Caller buffer (MAX_LINE_LENGTH size) receiving the name
+Returns: char* - Pointer to temp_buffer containing extracted macro name
                 (NULL if no valid macro name found)
 */
-static char *extract_macro_name(const char *line) {
-    static char temp_buffer[MAX_LINE_LENGTH];
+static char *extract_macro_name(const char *line, char *temp_buffer) {
     char *macro_name_start, *colon_pos;
     size_t length;
 
@@ -93,28 +92,28 @@ static char *extract_macro_name(const char *line) {
 
 /*
 Function to process a macro definition line (starting with 'mcro').
-Receives: char *line - The definition line to process
+Receives: char *line - The definition line to process (modified)
           MacroTable *macrotab - Pointer to macro table
           Macro **current_macro - Pointer to track current macro being defined
           int line_num - Current line number for error reporting
 Returns: int - TRUE if definition processed successfully, FALSE otherwise
 */
 static int process_macro_definition(char *line, MacroTable *macrotab, Macro **current_macro, int line_num) {
-    char temp_line[MAX_LINE_LENGTH];
-    char *name, *rest;
-    size_t length;
+    char *name, *name_end, *rest;
 
-    strcpy(temp_line, line);
-    length = strlen(MACRO_START);
+    /* Split "mcro <name>" by hand, strtok() keeps hidden state and is not reentrant */
+    name = line + strlen(MACRO_START);
+    name += strspn(name, SPACE_TAB);
+    name_end = name + strcspn(name, SPACE_TAB);
+    rest = name_end + strspn(name_end, SPACE_TAB);
 
-    name = strtok(temp_line + length, SPACE_TAB);
-    rest = strtok(NULL, SPACE_TAB);
-
-    if (rest != NULL) {
+    if (*rest != NULL_TERMINATOR) {
         print_line_error("Extra content after macro definition", NULL, line_num);
         return FALSE;
     }
-    if (!name) {
+    *name_end = NULL_TERMINATOR;
+
+    if (name == name_end) {
         print_line_error("Missing macro name", NULL, line_num);
         return FALSE;
     }
@@ -133,16 +132,17 @@ static int process_macro_definition(char *line, MacroTable *macrotab, Macro **cu
 /*
 Function to process a line of macro, and add it to the body.
 Receives: const char *original_line - The unprocessed line
+          MacroTable *macrotab - Pointer to macro table
           Macro *current_macro - Pointer to current macro being defined
           int line_num - Current line number for error reporting
 */
-static void process_macro_body(const char *original_line, Macro *current_macro, int line_num) {
+static void process_macro_body(const char *original_line, MacroTable *macrotab, Macro *current_macro, int line_num) {
     char clean_line[MAX_LINE_LENGTH];
 
     strcpy(clean_line, original_line);
     preprocess_line(clean_line);
 
-    if (!add_line_to_macro(current_macro, clean_line))
+    if (!add_line_to_macro(macrotab, current_macro, clean_line))
         print_line_error("Failed to add line to macro", current_macro->name, line_num);
 }
 
@@ -163,37 +163,40 @@ static void get_indentation(const char *line, char *indent) {
 }
 
 /*
-Function to writes a macro's body to .am file,
+Function to write a macro's body to the expanded source buffer,
 while preserving original indentation of macro call.
-Receives: FILE *am - Pointer to output (.am) file
+Receives: SourceBuffer *am_source - Expanded (.am) source buffer
           const Macro *macro - Pointer to macro being expanded
           const char *indent - Indentation string to preserve
+Returns: int - TRUE if body was written, FALSE on memory error
 */
-static void write_macro_body(FILE *am, const Macro *macro, const char *indent) {
+static int write_macro_body(SourceBuffer *am_source, const Macro *macro, const char *indent) {
     int i;
 
     for (i = 0; i < macro->line_count; i++) {
         if (macro->body[i] &&
-            macro->body[i][0] != NULL_TERMINATOR)
-            write_file_line(am, indent, macro->body[i]);
+            macro->body[i][0] != NULL_TERMINATOR &&
+            !append_source_line(am_source, indent, macro->body[i]))
+            return FALSE;
     }
+    return TRUE;
 }
 
 /*
 Function to process a macro call line by expanding the macro contents.
 Handles labels and preserves indentation in expansion.
 Receives: const char *line - The line containing macro call
-          FILE *am - Pointer to output (.am) file
+          SourceBuffer *am_source - Expanded (.am) source buffer
           const MacroTable *macrotab - Pointer to macro table
           int line_num - Current line number for error reporting
 Returns: int - TRUE if expansion succeeded, FALSE otherwise
 */
-static int process_macro_call_line(const char *line, FILE *am, const MacroTable *macrotab, int line_num) {
-    char *macro_name;
+static int process_macro_call_line(const char *line, SourceBuffer *am_source, const MacroTable *macrotab, int line_num) {
+    char *macro_name, name_buffer[MAX_LINE_LENGTH];
     char indent[MAX_LINE_LENGTH] = "";
     const Macro *macro;
 
-    macro_name = extract_macro_name(line);
+    macro_name = extract_macro_name(line, name_buffer);
 
     if (!macro_name) {
         print_line_error("Empty macro name after declaration", NULL, line_num);
@@ -206,9 +209,8 @@ static int process_macro_call_line(const char *line, FILE *am, const MacroTable
         return FALSE;
     }
     get_indentation(line, indent);
-    write_macro_body(am, macro, indent);
 
-    return TRUE;
+    return write_macro_body(am_source, macro, indent);
 }
 
 /*
@@ -216,33 +218,34 @@ Function to handle lines encountered while inside a macro definition.
 Processes either macro body content or macro termination.
 Receives: const char *original_line - The unprocessed line
           const char *processed_line - The preprocessed line
+          MacroTable *macrotab - Pointer to macro table
           Macro *current_macro - Pointer to current macro being defined
           int *in_macro_definition - Flag tracking definition state
           int line_num - Current line number for error reporting
 Returns: int - TRUE if processing succeeded, FALSE on error
 */
-static int handle_in_macro_definition(const char *original_line, const char *processed_line, Macro *current_macro, int *in_macro_definition, int line_num) {
+static int handle_in_macro_definition(const char *original_line, const char *processed_line, MacroTable *macrotab, Macro *current_macro, int *in_macro_definition, int line_num) {
     if (IS_MACRO_END(processed_line))
         *in_macro_definition = FALSE;
     else
-        process_macro_body(original_line, current_macro, line_num);
+        process_macro_body(original_line, macrotab, current_macro, line_num);
 
     return TRUE;
 }
 
 /*
 Function to handle lines encountered outside macro definitions.
-Processes macro definitions, calls, or regular lines, and writes to .am file accordingly.
+Processes macro definitions, calls, or regular lines, and writes to .am buffer accordingly.
 Receives: const char *original_line - The unprocessed line
           const char *processed_line - The preprocessed line
-          FILE *am_fp - Pointer to output (.am) file
+          SourceBuffer *am_source - Expanded (.am) source buffer
           MacroTable *macrotab - Pointer to macro table
           Macro **current_macro - Pointer to track current macro
           int *in_macro_definition - Flag tracking definition state
           int line_num - Current line number for error reporting
 Returns: int - TRUE if processing succeeded, FALSE on error
 */
-static int handle_outside_macro_definition(const char *original_line, const char *processed_line, FILE *am_fp, MacroTable *macrotab, Macro **current_macro, int *in_macro_definition, int line_num) {
+static int handle_outside_macro_definition(const char *original_line, const char *processed_line, SourceBuffer *am_source, MacroTable *macrotab, Macro **current_macro, int *in_macro_definition, int line_num) {
     char temp_line[MAX_LINE_LENGTH];
 
     if (IS_MACRO_DEFINITION(processed_line)) {
@@ -251,10 +254,9 @@ static int handle_outside_macro_definition(const char *original_line, const char
         return *in_macro_definition;
     }
     if (is_macro_call(processed_line, macrotab))
-        return process_macro_call_line(original_line, am_fp, macrotab, line_num);
+        return process_macro_call_line(original_line, am_source, macrotab, line_num);
 
-    fprintf(am_fp, "%s", original_line);
-    return TRUE;
+    return append_source_text(am_source, original_line);
 }
 
 /*
@@ -262,49 +264,53 @@ Function to process a single line during macro preprocessing,
 based on current macro definition state.
 Receives: const char *original_line - The unprocessed line
           const char *processed_line - The preprocessed line
-          FILE *am_fp - Pointer to output (.am) file
+          SourceBuffer *am_source - Expanded (.am) source buffer
           MacroTable *macrotab - Pointer to macro table
           Macro **current_macro - Pointer to track current macro
           int *in_macro_definition - Flag tracking definition state
           int line_num - Current line number for error reporting
 Returns: int - TRUE if line processed successfully, FALSE on error
 */
-static int process_line(const char *original_line, const char *processed_line, FILE *am_fp, MacroTable *macrotab, Macro **current_macro, int *in_macro_definition, int line_num) {
+static int process_line(const char *original_line, const char *processed_line, SourceBuffer *am_source, MacroTable *macrotab, Macro **current_macro, int *in_macro_definition, int line_num) {
     if (is_empty_line(processed_line))
         return TRUE; 
 
     if (*in_macro_definition)
-        return handle_in_macro_definition(original_line, processed_line, *current_macro, in_macro_definition, line_num);
+        return handle_in_macro_definition(original_line, processed_line, macrotab, *current_macro, in_macro_definition, line_num);
     else
-        return handle_outside_macro_definition(original_line, processed_line, am_fp, macrotab, current_macro, in_macro_definition, line_num);
+        return handle_outside_macro_definition(original_line, processed_line, am_source, macrotab, current_macro, in_macro_definition, line_num);
 }
 
 /*
-Function to process all lines from .as file during macro preprocessing.
+Function to process all lines of the .as source during macro preprocessing.
+Lines are taken as spans of the source buffer, and copied only once their length is validated.
 Manages macro definition state and error tracking.
-Receives: FILE *src_fp - Pointer to source (.as) file
-          FILE *am_fp - Pointer to output (.am) file
+Receives: const SourceBuffer *as_source - Source (.as) file contents
+          SourceBuffer *am_source - Expanded (.am) source buffer
           MacroTable *macrotab - Pointer to macro table
 Returns: int - TRUE if all lines processed successfully, FALSE on any error
 */
-static int process_file_lines(FILE *src_fp, FILE *am_fp, MacroTable *macrotab) {
-    char line[MAX_LINE_LENGTH], original_line[MAX_LINE_LENGTH], processed_line[MAX_LINE_LENGTH];
+static int process_file_lines(const SourceBuffer *as_source, SourceBuffer *am_source, MacroTable *macrotab) {
+    char original_line[MAX_LINE_LENGTH], processed_line[MAX_LINE_LENGTH];
+    const char *line;
+    size_t length, position = 0;
     int line_num = 0;
     int in_macro_definition = FALSE, has_error = FALSE;
     Macro *current_macro = NULL;
 
-    while (fgets(line, MAX_LINE_LENGTH, src_fp)) {
+    while (next_source_line(as_source, &position, &line, &length)) {
         line_num++;
 
-        if (!check_line_length(line, src_fp, line_num)) {
+        if (!check_line_length(line, length, line_num)) {
             has_error = TRUE;
             continue;
         }
-        strcpy(original_line, line);
-        strcpy(processed_line, line);
+        memcpy(original_line, line, length);
+        original_line[length] = NULL_TERMINATOR;
+        memcpy(processed_line, original_line, length + 1);
         preprocess_line(processed_line);
 
-        if (!process_line(original_line, processed_line, am_fp, macrotab, &current_macro, &in_macro_definition, line_num))
+        if (!process_line(original_line, processed_line, am_source, macrotab, &current_macro, &in_macro_definition, line_num))
             has_error = TRUE;
     }
     return (has_error ? FALSE : TRUE);
@@ -313,38 +319,17 @@ static int process_file_lines(FILE *src_fp, FILE *am_fp, MacroTable *macrotab) {
 /* Outer methods */
 /* ==================================================================== */
 /*
-Function to perform the macro preprocessing (first stage) of assembler on an .as file.
-Opens file, processes all lines, resolves symbols, and generates output files.
-Opens files, processes all lines & macros, and creates expanded output.
-Deletes output file if errors occurred during processing.
-Receives: const char *filename - Name of source (.as) file
-          const char *am_filename - Name for output (.am) file
+Function to perform the macro preprocessing (first stage) of assembler on the contents of an .as file.
+Processes all lines & macros of the already read source, and creates expanded output in memory.
+The expanded source is written to an .am file only when requested by the caller.
+Receives: const SourceBuffer *as_source - Source (.as) file contents
+          SourceBuffer *am_source - Output buffer for expanded (.am) source
           MacroTable *macrotab - Pointer to macro table
 Returns: int - TRUE if preprocessing succeeded, PASS_ERROR on failure
 */
-int preprocess_macros(const char *filename, const char *am_filename, MacroTable *macrotab) {
-    int result = TRUE;
-    FILE *src_fp = NULL, *am_fp = NULL;
-
-    src_fp = open_source_file(filename);
-
-    if (!src_fp)
+int preprocess_macros(const SourceBuffer *as_source, SourceBuffer *am_source, MacroTable *macrotab) {
+    if (!process_file_lines(as_source, am_source, macrotab))
         return PASS_ERROR;
 
-    am_fp = open_output_file(am_filename);
-
-    if (!am_fp) {
-        safe_fclose(&src_fp);
-        return PASS_ERROR;
-    }
-    if (!process_file_lines(src_fp, am_fp, macrotab))
-        result = PASS_ERROR;
-
-    safe_fclose(&src_fp);
-    safe_fclose(&am_fp);
-
-    if (result == PASS_ERROR)
-        remove(am_filename);
-
-    return result;
+    return TRUE;
 }
\ No newline at end of file
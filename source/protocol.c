@@ -0,0 +1,132 @@
+/* read() & write() are POSIX, not part of C90 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "source_buffer.h"
+#include "protocol.h"
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to append a record ("<kind> <name length> <data length>" line, name & data) to a buffer.
+Receives: SourceBuffer *buffer - Target buffer
+          const char *kind - Record kind (RECORD_*)
+          const char *name - Record name (may be NULL if name_length is 0)
+          size_t name_length - Length of name
+          const char *data - Record data (may be NULL if data_length is 0)
+          size_t data_length - Length of data
+Returns: int - TRUE if appended, FALSE on memory error
+*/
+int append_record(SourceBuffer *buffer, const char *kind, const char *name, size_t name_length, const char *data, size_t data_length) {
+    char header[MAX_RECORD_HEADER_LENGTH];
+
+    sprintf(header, "%s %lu %lu%c", kind, (unsigned long)name_length, (unsigned long)data_length, NEWLINE);
+
+    return append_source_text(buffer, header) &&
+           ((name_length == 0) || append_source_span(buffer, name, name_length)) &&
+           ((data_length == 0) || append_source_span(buffer, data, data_length));
+}
+
+/*
+Function to take the next record of a buffer.
+Receives: const SourceBuffer *buffer - Buffer of records
+          size_t *position - Offset of next record, advanced past it
+          Record *record - Output record, its name & data point into the buffer
+Returns: int - TRUE if a complete record was taken, FALSE at the end of buffer or on a malformed record
+*/
+int next_record(const SourceBuffer *buffer, size_t *position, Record *record) {
+    const char *line, *field;
+    char *end;
+    size_t line_length, kind_length;
+    unsigned long name_length, data_length;
+
+    if (!next_source_line(buffer, position, &line, &line_length))
+        return FALSE;
+
+    kind_length = strcspn(line, SPACE_TAB_NEWLINE);
+
+    if ((kind_length == 0) || (kind_length >= MAX_RECORD_KIND_LENGTH) || (line[kind_length] != ' '))
+        return FALSE;
+
+    field = line + kind_length + 1;
+    name_length = strtoul(field, &end, BASE10_ENCODING);
+
+    if ((end == field) || (*end != ' '))
+        return FALSE;
+
+    field = end + 1;
+    data_length = strtoul(field, &end, BASE10_ENCODING);
+
+    if ((end == field) || (*end != NEWLINE) ||
+        (name_length > buffer->length - *position) ||
+        (data_length > buffer->length - *position - name_length))
+        return FALSE;
+
+    memcpy(record->kind, line, kind_length);
+    record->kind[kind_length] = NULL_TERMINATOR;
+    record->name = buffer->text + *position;
+    record->name_length = name_length;
+    record->data = record->name + name_length;
+    record->data_length = data_length;
+    *position += name_length + data_length;
+
+    return TRUE;
+}
+
+/*
+Function to read from a socket until the peer stops sending.
+Receives: int fd - Connected socket
+          SourceBuffer *buffer - Buffer receiving all bytes (reset first)
+Returns: int - TRUE if read until end of stream, FALSE on error
+*/
+int read_socket(int fd, SourceBuffer *buffer) {
+    char chunk[SOCKET_BUFFER_SIZE];
+    long read_count;
+
+    reset_source_buffer(buffer);
+
+    while ((read_count = (long)read(fd, chunk, sizeof(chunk))) != 0) {
+        if (read_count < 0) {
+            if (errno == EINTR)
+                continue;
+
+            print_error("Failed to read from socket", strerror(errno));
+            return FALSE;
+        }
+        if (!append_source_span(buffer, chunk, (size_t)read_count))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to write a whole text to a socket.
+Receives: int fd - Connected socket
+          const char *text - Text to write
+          size_t length - Length of text
+Returns: int - TRUE if all bytes were written, FALSE on error
+*/
+int write_socket(int fd, const char *text, size_t length) {
+    long written;
+
+    while (length > 0) {
+        written = (long)write(fd, text, length);
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            print_error("Failed to write to socket", strerror(errno));
+            return FALSE;
+        }
+        text += written;
+        length -= (size_t)written;
+    }
+    return TRUE;
+}
\ No newline at end of file
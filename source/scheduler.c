@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "diagnostics.h"
+#include "options.h"
+#include "file_io.h"
+#include "stats.h"
+#include "scheduler.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to order jobs by descending file size (ties kept in command line order).
+Receives: const void *a - First Job
+          const void *b - Second Job
+Returns: int - Negative if a goes first, positive if b goes first
+*/
+static int compare_jobs(const void *a, const void *b) {
+    const Job *job_a = a, *job_b = b;
+
+    if (job_a->size != job_b->size)
+        return (job_a->size > job_b->size) ? -1 : 1;
+
+    return job_a->file_index - job_b->file_index;
+}
+
+/*
+Function to size all input files and sort them, so large files are scheduled first.
+Receives: const AssemblerOptions *options - Command line options
+Returns: Job* - Allocated array of options->file_count jobs, NULL on memory error
+*/
+static Job *create_sorted_jobs(const AssemblerOptions *options) {
+    char input_file[MAX_FILENAME_LENGTH];
+    int i;
+    Job *jobs = ALLOC(options->file_count * sizeof(Job), ALLOC_SITE_SCHEDULER);
+
+    if (!jobs) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to create job list");
+        return NULL;
+    }
+    for (i = 0; i < options->file_count; i++) {
+        sprintf(input_file, "%s%s", options->files[i], FILE_EXT_INPUT);
+
+        jobs[i].file_index = i;
+        jobs[i].size = get_file_size(input_file);
+    }
+    qsort(jobs, options->file_count, sizeof(Job), compare_jobs);
+
+    return jobs;
+}
+
+/*
+Function to initialize a worker with an empty queue, its own tables & log.
+Receives: Worker *worker - Worker to initialize
+          Scheduler *scheduler - Owning scheduler
+          int index - Position in scheduler workers
+          int queue_capacity - Maximum jobs dealt to the worker
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+static int init_worker(Worker *worker, Scheduler *scheduler, int index, int queue_capacity) {
+    worker->queue.file_indexes = ALLOC(queue_capacity * sizeof(int), ALLOC_SITE_SCHEDULER);
+
+    if (!worker->queue.file_indexes) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to create job queue");
+        return FALSE;
+    }
+    if (!init_file_tables(&worker->tables)) {
+        safe_free((void**)&worker->queue.file_indexes);
+        return FALSE;
+    }
+    if (!init_source_buffer(&worker->log)) {
+        free_file_tables(&worker->tables);
+        safe_free((void**)&worker->queue.file_indexes);
+        return FALSE;
+    }
+    worker->queue.head = 0;
+    worker->queue.tail = 0;
+    pthread_mutex_init(&worker->queue.lock, NULL);
+
+    worker->started = FALSE;
+    worker->index = index;
+    worker->scheduler = scheduler;
+
+    return TRUE;
+}
+
+/*
+Function to free all resources held by a worker.
+Receives: Worker *worker - Worker to deallocate
+*/
+static void free_worker(Worker *worker) {
+    pthread_mutex_destroy(&worker->queue.lock);
+    safe_free((void**)&worker->queue.file_indexes);
+    free_file_tables(&worker->tables);
+    free_source_buffer(&worker->log);
+}
+
+/*
+Function to take the next job of a worker: the head of its own queue,
+or when empty, a job stolen from the tail of another worker's queue.
+Receives: Worker *worker - Worker looking for a job
+          int *file_index - Output index of file to assemble
+Returns: int - TRUE if a job was taken, FALSE if all queues are empty
+*/
+static int take_job(Worker *worker, int *file_index) {
+    Scheduler *scheduler = worker->scheduler;
+    JobQueue *queue = &worker->queue;
+    int i, found = FALSE;
+
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->head < queue->tail) {
+        *file_index = queue->file_indexes[queue->head++];
+        found = TRUE;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    /* Jobs are never added after dealing, so one sweep over the victims is enough */
+    for (i = 1; (!found) && (i < scheduler->worker_count); i++) {
+        queue = &scheduler->workers[(worker->index + i) % scheduler->worker_count].queue;
+
+        pthread_mutex_lock(&queue->lock);
+
+        if (queue->head < queue->tail) {
+            *file_index = queue->file_indexes[--queue->tail];
+            found = TRUE;
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return found;
+}
+
+/*
+Function to print the log of a job, to the log of the thread that started the scheduler if bound, or to stdout.
+Called under the output lock.
+Receives: Scheduler *scheduler - Owning scheduler
+          const char *text - Log to print
+*/
+static void print_job_log(Scheduler *scheduler, const char *text) {
+    if (scheduler->output_log)
+        append_source_text(scheduler->output_log, text);
+    else
+        fputs(text, stdout);
+}
+
+/*
+Function to record a finished job, and print the logs of all jobs finished in command line order.
+Logs are printed whole under the output lock, so diagnostics of different files never interleave.
+Receives: Scheduler *scheduler - Owning scheduler
+          int file_index - Index of finished file
+          const SourceBuffer *log - Diagnostics of finished job
+          int success - Job result
+*/
+static void publish_result(Scheduler *scheduler, int file_index, const SourceBuffer *log, int success) {
+    JobResult *result;
+
+    pthread_mutex_lock(&scheduler->output_lock);
+
+    result = &scheduler->results[file_index];
+    result->success = success;
+    result->done = TRUE;
+    result->log = ALLOC(log->length + 1, ALLOC_SITE_SCHEDULER);
+
+    if (result->log)
+        memcpy(result->log, log->text, log->length + 1);
+    else
+        print_job_log(scheduler, log->text); /* out of order, but still whole */
+
+    if (success)
+        scheduler->success_count++;
+
+    while ((scheduler->next_output < scheduler->options->file_count) &&
+           (scheduler->results[scheduler->next_output].done)) {
+        result = &scheduler->results[scheduler->next_output++];
+
+        if (result->log) {
+            print_job_log(scheduler, result->log);
+            safe_free((void**)&result->log);
+        }
+    }
+    fflush(stdout);
+
+    pthread_mutex_unlock(&scheduler->output_lock);
+}
+
+/*
+Function to run jobs on a worker until no queue has pending jobs.
+Receives: void *arg - Worker to run (Worker*)
+Returns: void* - Always NULL
+*/
+static void *run_worker(void *arg) {
+    Worker *worker = arg;
+    Scheduler *scheduler = worker->scheduler;
+    SourceBuffer *previous_log = get_diagnostic_log();
+    int file_index, success;
+
+    while (take_job(worker, &file_index)) {
+        reset_source_buffer(&worker->log);
+        set_diagnostic_log(&worker->log);
+
+        success = scheduler->job(scheduler->options, file_index, &worker->tables);
+
+        set_diagnostic_log(previous_log);
+        publish_result(scheduler, file_index, &worker->log, success);
+    }
+    return NULL;
+}
+
+/*
+Function to create the workers, and deal the sorted jobs between them round-robin,
+so each queue starts with its largest files.
+Receives: Scheduler *scheduler - Scheduler with options & worker_count set
+          const Job *jobs - Jobs sorted by descending size
+Returns: int - TRUE if all workers were created, FALSE on memory error
+*/
+static int create_workers(Scheduler *scheduler, const Job *jobs) {
+    Worker *worker;
+    int i, file_count = scheduler->options->file_count;
+    int queue_capacity = (file_count + scheduler->worker_count - 1) / scheduler->worker_count;
+
+    scheduler->workers = ALLOC(scheduler->worker_count * sizeof(Worker), ALLOC_SITE_SCHEDULER);
+
+    if (!scheduler->workers) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to create workers");
+        return FALSE;
+    }
+    for (i = 0; i < scheduler->worker_count; i++) {
+        if (!init_worker(&scheduler->workers[i], scheduler, i, queue_capacity)) {
+            while (i-- > 0) {
+                free_worker(&scheduler->workers[i]);
+            }
+            safe_free((void**)&scheduler->workers);
+            return FALSE;
+        }
+    }
+    for (i = 0; i < file_count; i++) {
+        worker = &scheduler->workers[i % scheduler->worker_count];
+        worker->queue.file_indexes[worker->queue.tail++] = jobs[i].file_index;
+    }
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to assemble all input files concurrently, on options->jobs worker threads.
+The calling thread works as the first worker, if other threads can't be created
+their queues are drained by stealing, so every job still runs.
+Diagnostics of each file are buffered, and printed whole in command line order.
+Receives: const AssemblerOptions *options - Command line options
+          FileJob job - Function assembling a single file
+          FileStats *totals - Statistics accumulated over all files (of all workers)
+Returns: int - Number of files assembled successfully, -1 on memory error
+*/
+int run_parallel_jobs(const AssemblerOptions *options, FileJob job, FileStats *totals) {
+    Scheduler scheduler;
+    Job *jobs;
+    int i;
+
+    scheduler.options = options;
+    scheduler.job = job;
+    scheduler.worker_count = (options->jobs < options->file_count) ? options->jobs : options->file_count;
+    scheduler.output_log = get_diagnostic_log();
+    scheduler.next_output = 0;
+    scheduler.success_count = 0;
+    scheduler.results = ALLOC_ZEROED(options->file_count, sizeof(JobResult), ALLOC_SITE_SCHEDULER);
+
+    if (!scheduler.results) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to create job results");
+        return -1;
+    }
+    jobs = create_sorted_jobs(options);
+
+    if (!jobs || !create_workers(&scheduler, jobs)) {
+        safe_free((void**)&jobs);
+        safe_free((void**)&scheduler.results);
+        return -1;
+    }
+    safe_free((void**)&jobs);
+    pthread_mutex_init(&scheduler.output_lock, NULL);
+
+    for (i = 1; i < scheduler.worker_count; i++) {
+        scheduler.workers[i].started =
+            (pthread_create(&scheduler.workers[i].thread, NULL, run_worker, &scheduler.workers[i]) == 0);
+    }
+    run_worker(&scheduler.workers[0]);
+
+    /* Join all threads before freeing any worker, a running thread may still steal from any queue */
+    for (i = 1; i < scheduler.worker_count; i++) {
+        if (scheduler.workers[i].started)
+            pthread_join(scheduler.workers[i].thread, NULL);
+    }
+    for (i = 0; i < scheduler.worker_count; i++) {
+        add_file_stats(totals, &scheduler.workers[i].tables.totals);
+        free_worker(&scheduler.workers[i]);
+    }
+    pthread_mutex_destroy(&scheduler.output_lock);
+    safe_free((void**)&scheduler.workers);
+    safe_free((void**)&scheduler.results);
+
+    return scheduler.success_count;
+}
\ No newline at end of file
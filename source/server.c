@@ -0,0 +1,309 @@
+/* Sockets, chdir() & signal(SIGPIPE) are POSIX, not part of C90 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "source_buffer.h"
+#include "options.h"
+#include "file_io.h"
+#include "file_overlay.h"
+#include "diagnostics.h"
+#include "protocol.h"
+#include "server.h"
+
+#define LISTEN_BACKLOG 16
+
+static char program_name[] = "assembler";
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to initialize the buffers & overlay of the server, once before the first request.
+Receives: Server *server - Server to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+static int init_server(Server *server) {
+    int request_ok, arguments_ok, log_ok, response_ok, overlay_ok;
+
+    server->listen_fd = -1;
+    server->argc = 0;
+    server->has_inputs = FALSE;
+    server->stop = FALSE;
+    request_ok = init_source_buffer(&server->request);
+    arguments_ok = init_source_buffer(&server->arguments);
+    log_ok = init_source_buffer(&server->log);
+    response_ok = init_source_buffer(&server->response);
+    overlay_ok = init_file_overlay(&server->overlay);
+
+    if (request_ok && arguments_ok && log_ok && response_ok && overlay_ok)
+        return TRUE;
+
+    if (request_ok)
+        free_source_buffer(&server->request);
+    if (arguments_ok)
+        free_source_buffer(&server->arguments);
+    if (log_ok)
+        free_source_buffer(&server->log);
+    if (response_ok)
+        free_source_buffer(&server->response);
+    if (overlay_ok)
+        free_file_overlay(&server->overlay);
+
+    return FALSE;
+}
+
+/*
+Function to free the buffers & overlay of the server, after the last request.
+Receives: Server *server - Server to free
+*/
+static void free_server(Server *server) {
+    free_source_buffer(&server->request);
+    free_source_buffer(&server->arguments);
+    free_source_buffer(&server->log);
+    free_source_buffer(&server->response);
+    free_file_overlay(&server->overlay);
+}
+
+/*
+Function to create the listening socket, replacing a stale socket file of an earlier server.
+Receives: Server *server - Server to listen on
+          const char *socket_path - Path of the socket file
+Returns: int - TRUE if listening, FALSE on error
+*/
+static int open_server_socket(Server *server, const char *socket_path) {
+    struct sockaddr_un address;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    server->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (server->listen_fd < 0) {
+        print_error("Failed to create socket", strerror(errno));
+        return FALSE;
+    }
+    unlink(socket_path);
+
+    if ((bind(server->listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0) ||
+        (listen(server->listen_fd, LISTEN_BACKLOG) != 0)) {
+        print_error("Failed to listen on socket", socket_path);
+        close(server->listen_fd);
+        server->listen_fd = -1;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to check the lengths of the parsed request arguments, before they reach fixed size filename buffers.
+Base filenames must leave room for any extension, flags & flag values must fit the longest valid value.
+Receives: const Server *server - Server holding the parsed arguments
+Returns: int - TRUE if all arguments fit, FALSE otherwise
+*/
+static int check_request_arguments(const Server *server) {
+    size_t limit;
+    int i;
+
+    for (i = 1; i < server->argc; i++) {
+        limit = IS_OPTION(server->argv[i]) ? MAX_REQUEST_OPTION_LENGTH : (MAX_FILENAME_LENGTH - MAX_EXTENSION_LENGTH);
+
+        if (IS_VALUE_OPTION(server->argv[i]) && (i + 1 < server->argc))
+            i++; /* check the value */
+
+        if (strlen(server->argv[i]) >= limit)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Function to split a received request into its working directory, arguments & flags.
+Arguments are copied null terminated, the first one being the working directory.
+Receives: Server *server - Server holding the request
+Returns: int - TRUE if request is well formed (arguments within length limits), FALSE otherwise
+*/
+static int parse_request(Server *server) {
+    size_t offsets[MAX_REQUEST_ARGS + 1];
+    size_t position = 0;
+    Record record;
+    int i, count = 0;
+
+    reset_source_buffer(&server->arguments);
+    server->has_inputs = FALSE;
+    server->stop = FALSE;
+
+    while (position < server->request.length) {
+        if (!next_record(&server->request, &position, &record))
+            return FALSE;
+
+        if (IS_RECORD(&record, RECORD_STOP))
+            server->stop = TRUE;
+
+        else if (IS_RECORD(&record, RECORD_INPUT))
+            server->has_inputs = TRUE;
+
+        else if (IS_RECORD(&record, RECORD_CWD) || IS_RECORD(&record, RECORD_ARG)) {
+            /* The working directory comes first, and only once */
+            if ((count >= MAX_REQUEST_ARGS) || (IS_RECORD(&record, RECORD_CWD) != (count == 0)))
+                return FALSE;
+
+            offsets[count++] = server->arguments.length;
+
+            if (!append_source_span(&server->arguments, record.data, record.data_length) ||
+                !append_source_span(&server->arguments, "", 1))
+                return FALSE;
+        }
+    }
+    if (count == 0)
+        return server->stop;
+
+    server->argv[0] = program_name;
+
+    for (i = 1; i < count; i++) {
+        server->argv[i] = server->arguments.text + offsets[i];
+    }
+    server->argv[count] = NULL;
+    server->argc = count;
+
+    return check_request_arguments(server);
+}
+
+/*
+Function to run the assembler on a parsed request, from the client's working directory.
+Receives: Server *server - Server holding the parsed request
+          RequestRun run - Function running the assembler
+          FileTables *tables - Warm tables, reused by all requests
+Returns: int - Exit code of the request
+*/
+static int run_request(Server *server, RequestRun run, FileTables *tables) {
+    AssemblerOptions options;
+    const char *cwd = server->arguments.text;
+    int result;
+
+    if (chdir(cwd) != 0) {
+        print_error("Failed to change directory", cwd);
+        return 1;
+    }
+    if (!parse_options(server->argc, server->argv, &options))
+        return 1;
+
+    if (options.serve_socket) {
+        print_error("Unexpected option in request", OPTION_SERVE);
+        free_options(&options);
+        return 1;
+    }
+    set_file_overlay(server->has_inputs ? &server->overlay : NULL, &server->request);
+    result = run(&options, tables);
+    set_file_overlay(NULL, NULL);
+
+    free_options(&options);
+    return result;
+}
+
+/*
+Function to serve a single connection: read its request, run it, and send back the response
+(messages, captured output files & exit code).
+Receives: Server *server - Server state
+          int fd - Accepted connection
+          RequestRun run - Function running the assembler
+          FileTables *tables - Warm tables, reused by all requests
+*/
+static void serve_connection(Server *server, int fd, RequestRun run, FileTables *tables) {
+    char exit_code[MAX_EXIT_CODE_LENGTH];
+    int result = 1;
+
+    if (!read_socket(fd, &server->request))
+        return;
+
+    reset_source_buffer(&server->log);
+    reset_source_buffer(&server->response);
+    reset_source_buffer(&server->overlay.outputs);
+    set_diagnostic_log(&server->log);
+
+    if (!parse_request(server))
+        print_error("Malformed request", NULL);
+
+    else if (server->stop)
+        result = 0;
+
+    else
+        result = run_request(server, run, tables);
+
+    set_diagnostic_log(NULL);
+    sprintf(exit_code, "%d", result);
+
+    if (append_record(&server->response, RECORD_LOG, NULL, 0, server->log.text, server->log.length) &&
+        append_source_span(&server->response, server->overlay.outputs.text, server->overlay.outputs.length) &&
+        append_record(&server->response, RECORD_EXIT, NULL, 0, exit_code, strlen(exit_code)))
+        write_socket(fd, server->response.text, server->response.length);
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to stay resident and assemble the requests of clients, one connection at a time.
+Tables, buffers & the keywords hash stay warm between requests, so only the first request pays for them.
+Receives: const char *socket_path - Path of the Unix domain socket to listen on
+          RequestRun run - Function running the assembler on the options of a request
+          FileTables *tables - Tables reused by all requests
+Returns: int - 0 when stopped by a client, 1 on error
+*/
+int serve_requests(const char *socket_path, RequestRun run, FileTables *tables) {
+    Server server;
+    int fd, in_start_dir = TRUE;
+
+    if (!getcwd(server.start_dir, sizeof(server.start_dir))) {
+        print_error("Failed to get working directory", NULL);
+        return 1;
+    }
+    if (!init_server(&server))
+        return 1;
+
+    if (!open_server_socket(&server, socket_path)) {
+        free_server(&server);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); /* a client that went away must not kill the server */
+    print_message("Serving requests on %s%c", socket_path, NEWLINE);
+    fflush(stdout);
+
+    while (!server.stop) {
+        fd = accept(server.listen_fd, NULL, NULL);
+
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+
+            print_error("Failed to accept connection", strerror(errno));
+            break;
+        }
+        serve_connection(&server, fd, run, tables);
+        close(fd);
+
+        /* Requests run from the client's directory, a relative socket path is resolved from the starting one */
+        if (chdir(server.start_dir) != 0) {
+            print_error("Failed to return to directory", server.start_dir);
+            in_start_dir = FALSE;
+            break;
+        }
+    }
+    close(server.listen_fd);
+
+    if (in_start_dir)
+        unlink(socket_path);
+
+    free_server(&server);
+
+    return server.stop ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "file_io.h"
+#include "source_buffer.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to make sure the buffer can hold additional text, doubling capacity as needed.
+Receives: SourceBuffer *buffer - Buffer to grow
+          size_t extra_length - Amount of characters about to be appended
+Returns: int - TRUE if enough space is available, FALSE on memory error
+*/
+static int reserve_source_space(SourceBuffer *buffer, size_t extra_length) {
+    char *new_text;
+    size_t new_capacity;
+
+    if (buffer->length + extra_length + 1 <= buffer->capacity)
+        return TRUE;
+
+    new_capacity = (buffer->capacity == 0) ? INITIAL_SOURCE_CAPACITY : buffer->capacity;
+
+    while (buffer->length + extra_length + 1 > new_capacity) {
+        new_capacity *= 2;
+    }
+    new_text = REALLOC(buffer->text, new_capacity, ALLOC_SITE_SOURCES);
+
+    if (!new_text) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize source buffer");
+        return FALSE;
+    }
+    buffer->text = new_text;
+    buffer->capacity = new_capacity;
+
+    return TRUE;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to initialize an empty source buffer with default capacity.
+Receives: SourceBuffer *buffer - Pointer to buffer structure to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+int init_source_buffer(SourceBuffer *buffer) {
+    buffer->text = ALLOC(INITIAL_SOURCE_CAPACITY, ALLOC_SITE_SOURCES);
+
+    if (!buffer->text) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to initialize source buffer");
+        return FALSE;
+    }
+    buffer->text[0] = NULL_TERMINATOR;
+    buffer->length = 0;
+    buffer->capacity = INITIAL_SOURCE_CAPACITY;
+
+    return TRUE;
+}
+
+/*
+Function to free all resources associated with the source buffer.
+Receives: SourceBuffer *buffer - Buffer to deallocate
+*/
+void free_source_buffer(SourceBuffer *buffer) {
+    safe_free((void**)&buffer->text);
+
+    buffer->length = 0;
+    buffer->capacity = 0;
+}
+
+/*
+Function to empty the source buffer for the next source, keeping its allocation.
+Receives: SourceBuffer *buffer - Buffer to reset
+*/
+void reset_source_buffer(SourceBuffer *buffer) {
+    buffer->text[0] = NULL_TERMINATOR;
+    buffer->length = 0;
+}
+
+/*
+Function to append raw text (as read from the source file) to the end of the buffer.
+Receives: SourceBuffer *buffer - Target buffer
+          const char *text - Text to append (kept as is, including its newline)
+Returns: int - TRUE if appended successfully, FALSE on memory error
+*/
+int append_source_text(SourceBuffer *buffer, const char *text) {
+    return append_source_span(buffer, text, strlen(text));
+}
+
+/*
+Function to append a text span (not necessarily null terminated) to the end of the buffer.
+Receives: SourceBuffer *buffer - Target buffer
+          const char *text - Start of span
+          size_t length - Length of span
+Returns: int - TRUE if appended successfully, FALSE on memory error
+*/
+int append_source_span(SourceBuffer *buffer, const char *text, size_t length) {
+    if (!reserve_source_space(buffer, length))
+        return FALSE;
+
+    memcpy(buffer->text + buffer->length, text, length);
+    buffer->length += length;
+    buffer->text[buffer->length] = NULL_TERMINATOR;
+
+    return TRUE;
+}
+
+/*
+Function to append a line built from 2 parts, separated by a space ("part1 part2\n").
+Receives: SourceBuffer *buffer - Target buffer
+          const char *part1 - First part of line (cannot be NULL)
+          const char *part2 - Second part of line (cannot be NULL)
+Returns: int - TRUE if appended successfully, FALSE on memory error
+*/
+int append_source_line(SourceBuffer *buffer, const char *part1, const char *part2) {
+    size_t length1 = strlen(part1), length2 = strlen(part2);
+    char *dest;
+
+    if (!reserve_source_space(buffer, length1 + length2 + 2))
+        return FALSE;
+
+    dest = buffer->text + buffer->length;
+    memcpy(dest, part1, length1);
+    dest[length1] = ' ';
+    memcpy(dest + length1 + 1, part2, length2);
+    dest[length1 + length2 + 1] = NEWLINE;
+    dest[length1 + length2 + 2] = NULL_TERMINATOR;
+
+    buffer->length += length1 + length2 + 2;
+    return TRUE;
+}
+
+/*
+Function to load a whole source file into the buffer, with as few reads as possible.
+The file size is queried first, so the text is normally read by a single fread.
+Receives: SourceBuffer *buffer - Target buffer (emptied first)
+          const char *filename - Path of the source file
+Returns: int - TRUE if the file was read, FALSE otherwise
+*/
+int read_source_file(SourceBuffer *buffer, const char *filename) {
+    FILE *fp = open_source_file(filename);
+    long file_size;
+    size_t read_count;
+    int result = TRUE;
+
+    if (!fp)
+        return FALSE;
+
+    reset_source_buffer(buffer);
+
+    if ((fseek(fp, 0, SEEK_END) == 0) && ((file_size = ftell(fp)) > 0) &&
+        (!reserve_source_space(buffer, (size_t)file_size)))
+        result = FALSE;
+
+    rewind(fp);
+
+    while (result) {
+        if ((buffer->capacity - buffer->length <= 1) &&
+            (!reserve_source_space(buffer, buffer->capacity))) {
+            result = FALSE;
+            break;
+        }
+        read_count = fread(buffer->text + buffer->length, 1, buffer->capacity - buffer->length - 1, fp);
+
+        if (read_count == 0)
+            break;
+
+        buffer->length += read_count;
+    }
+    buffer->text[buffer->length] = NULL_TERMINATOR;
+
+    if (ferror(fp)) {
+        print_error("Failed to read file", filename);
+        result = FALSE;
+    }
+    safe_fclose(&fp);
+
+    return result;
+}
+
+/*
+Function to read a span of an open file into the buffer, with a single fread.
+Receives: SourceBuffer *buffer - Target buffer (emptied first)
+          FILE *fp - Open file, positioned at the start of the span
+          size_t length - Length of span
+Returns: int - TRUE if the whole span was read, FALSE on memory error / short read
+*/
+int read_source_span(SourceBuffer *buffer, FILE *fp, size_t length) {
+    reset_source_buffer(buffer);
+
+    if (!reserve_source_space(buffer, length))
+        return FALSE;
+
+    buffer->length = fread(buffer->text, 1, length, fp);
+    buffer->text[buffer->length] = NULL_TERMINATOR;
+
+    return (buffer->length == length);
+}
+
+/*
+Function to get the next line of the buffer as a span, without copying it.
+Lines are found by scanning for the newline, the span includes it (if present).
+Receives: const SourceBuffer *buffer - Buffer to read from
+          size_t *position - Read position, advanced past the returned line
+          const char **line - Output pointer to line start, inside the buffer
+          size_t *length - Output line length (including newline)
+Returns: int - TRUE if a line was found, FALSE at end of buffer
+*/
+int next_source_line(const SourceBuffer *buffer, size_t *position, const char **line, size_t *length) {
+    const char *start, *newline;
+    size_t remaining;
+
+    if (*position >= buffer->length)
+        return FALSE;
+
+    start = buffer->text + *position;
+    remaining = buffer->length - *position;
+    newline = memchr(start, NEWLINE, remaining);
+
+    *line = start;
+    *length = newline ? (size_t)(newline - start) + 1 : remaining;
+    *position += *length;
+
+    return TRUE;
+}
+
+/*
+Function to count the lines of the buffer (a last line without newline counts too).
+Receives: const SourceBuffer *buffer - Buffer to scan
+Returns: long - Number of lines
+*/
+long count_source_lines(const SourceBuffer *buffer) {
+    const char *p = buffer->text, *end = buffer->text + buffer->length;
+    long count = 0;
+
+    while ((p < end) && (p = memchr(p, NEWLINE, end - p))) {
+        count++;
+        p++;
+    }
+    if ((buffer->length > 0) && (buffer->text[buffer->length - 1] != NEWLINE))
+        count++;
+
+    return count;
+}
+
+/*
+Function to read the next line from the buffer, in the same manner as fgets().
+Reads until a newline (kept) or until line_size - 1 characters were copied.
+Receives: const SourceBuffer *buffer - Buffer to read from
+          size_t *position - Read position, advanced past the returned line
+          char *line - Output buffer for the line
+          int line_size - Size of the output buffer
+Returns: int - TRUE if a line was read, FALSE at end of buffer
+*/
+int read_source_line(const SourceBuffer *buffer, size_t *position, char *line, int line_size) {
+    const char *start, *newline;
+    size_t length;
+
+    if (*position >= buffer->length || line_size < 2)
+        return FALSE;
+
+    start = buffer->text + *position;
+    length = buffer->length - *position;
+
+    if (length > (size_t)line_size - 1)
+        length = line_size - 1;
+
+    newline = memchr(start, NEWLINE, length);
+
+    if (newline)
+        length = (size_t)(newline - start) + 1;
+
+    memcpy(line, start, length);
+    line[length] = NULL_TERMINATOR;
+    *position += length;
+
+    return TRUE;
+}
+
+/*
+Function to write the whole buffer into a file (.am source, or a rendered output file).
+Receives: const SourceBuffer *buffer - Buffer to write
+          const char *filename - Path of the output file
+Returns: int - TRUE if the file was written, FALSE otherwise
+*/
+int write_source_file(const SourceBuffer *buffer, const char *filename) {
+    return write_output_file(filename, buffer->text, buffer->length);
+}
\ No newline at end of file
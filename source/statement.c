@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "errors.h"
+#include "instructions.h"
+#include "directives.h"
+#include "symbol_table.h"
+#include "line_process.h"
+#include "statement.h"
+#include "alloc_tracking.h"
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to dynamically expand the statements array capacity when full.
+Receives: StatementTable *table - Table to resize
+Returns: int - TRUE if resize succeeded, FALSE on memory error
+*/
+static int resize_statements(StatementTable *table) {
+    int new_capacity;
+    Statement *new_statements;
+
+    new_capacity = (table->capacity == 0) ? INITIAL_STATEMENTS_CAPACITY : table->capacity * 2;
+    new_statements = REALLOC(table->statements, new_capacity * sizeof(Statement), ALLOC_SITE_STATEMENTS);
+
+    if (!new_statements) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize statement table");
+        return FALSE;
+    }
+    table->statements = new_statements;
+    table->capacity = new_capacity;
+
+    return TRUE;
+}
+
+/*
+Function to make sure the operands array can hold additional operands.
+Receives: StatementTable *table - Table to resize
+          int extra_count - Amount of operands about to be added
+Returns: int - TRUE if enough space is available, FALSE on memory error
+*/
+static int reserve_operands(StatementTable *table, int extra_count) {
+    int new_capacity;
+    Operand *new_operands;
+
+    if (table->operand_count + extra_count <= table->operand_capacity)
+        return TRUE;
+
+    new_capacity = (table->operand_capacity == 0) ? INITIAL_OPERANDS_CAPACITY : table->operand_capacity;
+
+    while (table->operand_count + extra_count > new_capacity) {
+        new_capacity *= 2;
+    }
+    new_operands = REALLOC(table->operands, new_capacity * sizeof(Operand), ALLOC_SITE_STATEMENTS);
+
+    if (!new_operands) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize statement operands");
+        return FALSE;
+    }
+    table->operands = new_operands;
+    table->operand_capacity = new_capacity;
+
+    return TRUE;
+}
+
+/*
+Function to copy a token (line span) into the text arena of the table.
+This is the only copy a token's text gets, it outlives the line buffer.
+Receives: StatementTable *table - Table owning the text arena
+          const Token *token - Token to copy
+Returns: char* - Pointer to the stored copy, NULL on memory error
+*/
+static char *store_text(StatementTable *table, const Token *token) {
+    char *dest = arena_copy_span(&table->text, token->start, token->length);
+
+    if (!dest)
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to store statement text");
+
+    return dest;
+}
+
+/*
+Function to store the operands of a line (tokens after instruction / directive name).
+Addressing modes are computed here, once, for instruction operands.
+Receives: StatementTable *table - Target table
+          Statement *statement - Statement the operands belong to
+          const Token *tokens - Operand tokens
+          int count - Number of operand tokens
+Returns: int - TRUE if stored successfully, FALSE on memory error
+*/
+static int store_operands(StatementTable *table, Statement *statement, const Token *tokens, int count) {
+    int i;
+    Operand *operand;
+
+    if (!reserve_operands(table, count))
+        return FALSE;
+
+    statement->first_operand = table->operand_count;
+    statement->operand_count = count;
+
+    for (i = 0; i < count; i++) {
+        operand = &table->operands[table->operand_count + i];
+        operand->text = store_text(table, &tokens[i]);
+        operand->length = tokens[i].length;
+
+        if (!operand->text)
+            return FALSE;
+
+        if (statement->kind == STATEMENT_INSTRUCTION)
+            operand->mode = get_addressing_mode(operand->text);
+        else
+            operand->mode = -1;
+    }
+    table->operand_count += count;
+
+    return TRUE;
+}
+
+/*
+Function to classify a validated token line into a statement.
+Receives: StatementTable *table - Target table (owns the text arena)
+          Statement *statement - Statement to fill
+          const Token *tokens - Tokenized line
+          int token_count - Number of tokens
+          int line_num - Source line number
+Returns: int - TRUE if statement was built, FALSE on memory error
+*/
+static int build_statement(StatementTable *table, Statement *statement, const Token *tokens, int token_count, int line_num) {
+    const Token *item;
+    int item_index = is_first_token_label(tokens, token_count) ? 1 : 0;
+
+    statement->line_num = line_num;
+    statement->inst = NULL;
+    statement->directive = NO_DIRECTIVE;
+    statement->label = NULL;
+
+    item = &tokens[item_index];
+
+    if (item_index == 1 && !(statement->label = store_text(table, &tokens[0])))
+        return FALSE;
+
+    if (!(statement->name = store_text(table, item)))
+        return FALSE;
+
+    if (is_directive_line(tokens, token_count)) {
+        statement->kind = STATEMENT_DIRECTIVE;
+        statement->directive = get_directive_span(item->start, item->length);
+    } else {
+        statement->kind = STATEMENT_INSTRUCTION;
+        statement->inst = get_instruction_span(item->start, item->length);
+    }
+    return store_operands(table, statement, tokens + item_index + 1, token_count - (item_index + 1));
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to initialize an empty statement table.
+Token text is kept in an arena, so token pointers stay valid as the table grows.
+Receives: StatementTable *table - Pointer to table structure to initialize
+Returns: int - TRUE if initialization succeeded, FALSE on memory error
+*/
+int init_statement_table(StatementTable *table) {
+    table->statements = ALLOC(INITIAL_STATEMENTS_CAPACITY * sizeof(Statement), ALLOC_SITE_STATEMENTS);
+    table->operands = ALLOC(INITIAL_OPERANDS_CAPACITY * sizeof(Operand), ALLOC_SITE_STATEMENTS);
+
+    if (!init_arena(&table->text, TEXT_ARENA_SIZE) || !table->statements || !table->operands) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to initialize statement table");
+        free_statement_table(table);
+        return FALSE;
+    }
+    table->count = 0;
+    table->capacity = INITIAL_STATEMENTS_CAPACITY;
+    table->operand_count = 0;
+    table->operand_capacity = INITIAL_OPERANDS_CAPACITY;
+
+    return TRUE;
+}
+
+/*
+Function to free all resources associated with the statement table.
+Receives: StatementTable *table - Table to deallocate
+*/
+void free_statement_table(StatementTable *table) {
+    safe_free((void**)&table->statements);
+    safe_free((void**)&table->operands);
+    free_arena(&table->text);
+
+    table->count = 0;
+    table->capacity = 0;
+    table->operand_count = 0;
+    table->operand_capacity = 0;
+}
+
+/*
+Function to empty the statement table for the next source, keeping its allocations.
+Receives: StatementTable *table - Table to reset
+*/
+void reset_statement_table(StatementTable *table) {
+    reset_arena(&table->text);
+
+    table->count = 0;
+    table->operand_count = 0;
+}
+
+/*
+Function to validate, classify and append a tokenized line to the table.
+Receives: StatementTable *table - Target table
+          const Token *tokens - Tokenized line (views into the line buffer)
+          int token_count - Number of tokens (non-zero)
+          int line_num - Source line number for error reporting
+Returns: Statement* - Pointer to the new statement (valid until next addition),
+                      NULL on format or memory error
+*/
+Statement *add_statement(StatementTable *table, const Token *tokens, int token_count, int line_num) {
+    Statement *statement;
+
+    if (!check_line_format(tokens, token_count, line_num))
+        return NULL;
+
+    if ((table->count >= table->capacity) &&
+        (!resize_statements(table)))
+        return NULL;
+
+    statement = &table->statements[table->count];
+
+    if (!build_statement(table, statement, tokens, token_count, line_num))
+        return NULL;
+
+    table->count++;
+    return statement;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/* clock_gettime() is POSIX, not part of C90 */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+
+#include "utils.h"
+#include "diagnostics.h"
+#include "stats.h"
+
+/* Phase names, indexed by PHASE_* */
+static const char *phase_names[PHASE_COUNT] = {
+    "preprocess", "first pass", "second pass", "output"
+};
+
+/* Inner STATIC methods */
+/* ==================================================================== */
+/*
+Function to read a clock in seconds.
+Receives: clockid_t clock_id - Clock to read
+Returns: double - Clock time in seconds, 0 if the clock can't be read
+*/
+static double read_clock(clockid_t clock_id) {
+    struct timespec now;
+
+    if (clock_gettime(clock_id, &now) != 0)
+        return 0;
+
+    return now.tv_sec + (now.tv_nsec / NANOSECONDS_PER_SECOND);
+}
+
+/*
+Function to divide a count by a duration, without dividing by zero.
+Receives: long count - Amount to divide
+          double seconds - Duration
+Returns: double - Count per second, 0 for an empty duration
+*/
+static double per_second(long count, double seconds) {
+    return (seconds > 0) ? (count / seconds) : 0;
+}
+
+/* Outer methods */
+/* ==================================================================== */
+/*
+Function to clear statistics before a file (or a total) is accumulated.
+Receives: FileStats *stats - Statistics to clear
+*/
+void init_file_stats(FileStats *stats) {
+    int i;
+
+    for (i = 0; i < PHASE_COUNT; i++) {
+        stats->phases[i].wall = 0;
+        stats->phases[i].cpu = 0;
+    }
+    stats->files = 0;
+    stats->lines = 0;
+    stats->words = 0;
+    stats->symbols = 0;
+    stats->macros = 0;
+    stats->macro_lines = 0;
+    stats->cache_hits = 0;
+    stats->cache_misses = 0;
+}
+
+/*
+Function to take the current wall & CPU time of the calling thread.
+Receives: Timestamp *timestamp - Output timestamp
+*/
+void get_timestamp(Timestamp *timestamp) {
+    timestamp->wall = read_clock(CLOCK_MONOTONIC);
+    timestamp->cpu = read_clock(CLOCK_THREAD_CPUTIME_ID);
+}
+
+/*
+Function to add the time since a timestamp to a phase, and restart the timestamp for the next phase.
+Receives: FileStats *stats - Statistics to update
+          int phase - Phase to charge (PHASE_*)
+          Timestamp *start - Start of phase, set to now on return
+*/
+void add_phase_time(FileStats *stats, int phase, Timestamp *start) {
+    Timestamp now;
+
+    get_timestamp(&now);
+    stats->phases[phase].wall += now.wall - start->wall;
+    stats->phases[phase].cpu += now.cpu - start->cpu;
+    *start = now;
+}
+
+/*
+Function to accumulate a file's statistics into a total.
+Times, lines & words are summed, table sizes keep their peak.
+Receives: FileStats *total - Accumulated statistics
+          const FileStats *stats - Statistics to add
+*/
+void add_file_stats(FileStats *total, const FileStats *stats) {
+    int i;
+
+    for (i = 0; i < PHASE_COUNT; i++) {
+        total->phases[i].wall += stats->phases[i].wall;
+        total->phases[i].cpu += stats->phases[i].cpu;
+    }
+    total->files += stats->files;
+    total->lines += stats->lines;
+    total->words += stats->words;
+    total->cache_hits += stats->cache_hits;
+    total->cache_misses += stats->cache_misses;
+
+    if (stats->symbols > total->symbols)
+        total->symbols = stats->symbols;
+    if (stats->macros > total->macros)
+        total->macros = stats->macros;
+    if (stats->macro_lines > total->macro_lines)
+        total->macro_lines = stats->macro_lines;
+}
+
+/*
+Function to print a statistics report: time per phase, throughput & peak table sizes.
+Receives: const char *title - Report title (filename, or total)
+          const FileStats *stats - Statistics to print
+          double elapsed - Wall time the report covers (0 to use the sum of phases)
+*/
+void print_file_stats(const char *title, const FileStats *stats, double elapsed) {
+    double wall = 0, cpu = 0;
+    int i;
+
+    print_message("%cStats for %s:%c", NEWLINE, title, NEWLINE);
+
+    for (i = 0; i < PHASE_COUNT; i++) {
+        print_message("  %-12s wall %.6f s, cpu %.6f s%c", phase_names[i], stats->phases[i].wall, stats->phases[i].cpu, NEWLINE);
+        wall += stats->phases[i].wall;
+        cpu += stats->phases[i].cpu;
+    }
+    if (elapsed <= 0)
+        elapsed = wall;
+
+    print_message("  %-12s wall %.6f s, cpu %.6f s (elapsed %.6f s)%c", "total", wall, cpu, elapsed, NEWLINE);
+    print_message("  files %ld, lines %ld (%.0f lines/sec), words emitted %ld%c",
+                  stats->files, stats->lines, per_second(stats->lines, elapsed), stats->words, NEWLINE);
+    print_message("  peak symbols %ld, macros %ld, macro lines %ld%c",
+                  stats->symbols, stats->macros, stats->macro_lines, NEWLINE);
+
+    if (stats->cache_hits + stats->cache_misses > 0)
+        print_message("  cache hits %ld, misses %ld%c", stats->cache_hits, stats->cache_misses, NEWLINE);
+}
\ No newline at end of file
@@ -8,7 +8,9 @@
 #include "instructions.h"
 #include "directives.h"
 #include "macro_table.h"
+#include "keywords.h"
 #include "symbol_table.h"
+#include "alloc_tracking.h"
 
 /* Inner STATIC methods */
 /* ==================================================================== */
@@ -22,7 +24,7 @@ static int resize_symbol_table(SymbolTable *table) {
     Symbol *new_symbols;
 
     new_capacity = (table->capacity == 0) ? INITIAL_SYMBOLS_CAPACITY : table->capacity * 2;
-    new_symbols = realloc(table->symbols, new_capacity * sizeof(Symbol));
+    new_symbols = REALLOC(table->symbols, new_capacity * sizeof(Symbol), ALLOC_SITE_SYMBOLS);
 
     if (!new_symbols) {
         print_error(ERR_MEMORY_ALLOCATION, "Failed to resize symbol table");
@@ -34,6 +36,71 @@ static int resize_symbol_table(SymbolTable *table) {
     return TRUE;
 }
 
+/*
+Function to locate the index slot of a name span, using linear probing.
+Receives: const SymbolTable *table - Table to search
+          const char *name - Start of symbol name (not necessarily null terminated)
+          size_t length - Length of symbol name
+Returns: unsigned int - Slot holding the symbol, or the empty slot where it belongs
+*/
+static unsigned int find_slot(const SymbolTable *table, const char *name, size_t length) {
+    unsigned int mask = table->index_capacity - 1;
+    unsigned int slot = (unsigned int)hash_span(name, length) & mask;
+    const char *slot_name;
+
+    while (table->index[slot] != EMPTY_SLOT) {
+        slot_name = table->symbols[table->index[slot]].name;
+
+        if ((strncmp(slot_name, name, length) == 0) &&
+            (slot_name[length] == NULL_TERMINATOR))
+            break;
+
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/*
+Function to allocate an empty hash index with the given amount of slots.
+Receives: SymbolTable *table - Table owning the index
+          unsigned int capacity - Amount of slots (power of 2)
+Returns: int - TRUE if allocation succeeded, FALSE on memory error
+*/
+static int allocate_index(SymbolTable *table, unsigned int capacity) {
+    unsigned int i;
+    int *new_index = ALLOC(capacity * sizeof(int), ALLOC_SITE_SYMBOL_INDEX);
+
+    if (!new_index) {
+        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize symbol index");
+        return FALSE;
+    }
+    for (i = 0; i < capacity; i++) {
+        new_index[i] = EMPTY_SLOT;
+    }
+    safe_free((void**)&table->index);
+    table->index = new_index;
+    table->index_capacity = capacity;
+
+    return TRUE;
+}
+
+/*
+Function to double the hash index, and re-insert all stored symbols.
+Receives: SymbolTable *table - Table to re-index
+Returns: int - TRUE if resize succeeded, FALSE on memory error
+*/
+static int resize_symbol_index(SymbolTable *table) {
+    unsigned int i;
+
+    if (!allocate_index(table, table->index_capacity * 2))
+        return FALSE;
+
+    for (i = 0; i < table->count; i++) {
+        table->index[find_slot(table, table->symbols[i].name, strlen(table->symbols[i].name))] = i;
+    }
+    return TRUE;
+}
+
 /*
 Function to validate label syntax.
 Checks:
@@ -77,7 +144,7 @@ static int is_valid_syntax(const char *label) {
 }
 
 /*
-Function to check if label matches any reserved keywords.
+Function to check if label matches any reserved keywords, with a single keyword lookup.
 Checks:
 - Register names (r0-r7, PSW)
 - Instruction names
@@ -87,27 +154,26 @@ Receives: const char *label - Label to check
 Returns: int - TRUE if reserved word, FALSE otherwise
 */
 static int is_reserved_word(const char *label) {
-    if (IS_REGISTER_OR_PSW(label)) {
-        print_error("Label cannot be register (r0 - r7 / PSW)", label);
-        return TRUE;
-    }
-    if (IS_INSTRUCTION(label)) {
-        print_error("Label cannot be instruction (mov / cmp / add / ...)", label);
-        return TRUE;
-    }
-    if (IS_DIRECTIVE(label)) {
-        print_error("Label cannot be directive (.data / .string / .mat / .entry / .extern)", label);
-        return TRUE;
-    }
-    if (IS_MACRO_KEYWORD(label)) {
-        print_error("Label cannot be macro keyword (mcro / mcroend)", label);
-        return TRUE;
+    switch (get_keyword_class(label)) {
+        case KEYWORD_REGISTER:
+            print_error("Label cannot be register (r0 - r7 / PSW)", label);
+            return TRUE;
+        case KEYWORD_INSTRUCTION:
+            print_error("Label cannot be instruction (mov / cmp / add / ...)", label);
+            return TRUE;
+        case KEYWORD_DIRECTIVE:
+            print_error("Label cannot be directive (.data / .string / .mat / .entry / .extern)", label);
+            return TRUE;
+        case KEYWORD_MACRO:
+            print_error("Label cannot be macro keyword (mcro / mcroend)", label);
+            return TRUE;
+        default:
+            return FALSE;
     }
-    return FALSE;
 }
 
 /*
-Function to store a new symbol in the table.
+Function to store a new symbol in the table, and register it in the hash index.
 Receives: SymbolTable *table - Target symbol table
           const char *name - Symbol name
           int value - Associated numeric value
@@ -125,6 +191,7 @@ static void store_symbol(SymbolTable *table, const char *name, int value, int ty
     table->symbols[table->count].is_entry = (type == ENTRY_SYMBOL);
     table->symbols[table->count].is_extern = (type == EXTERNAL_SYMBOL);
 
+    table->index[find_slot(table, dest_name, strlen(dest_name))] = table->count;
     table->count++;
 }
 
@@ -168,15 +235,17 @@ static void extract_text_from_label(char *label) {
 /* Outer methods */
 /* ==================================================================== */
 /*
-Function to initialize the symbol table with default capacity.
+Function to initialize the symbol table & its hash index with default capacity.
 Receives: SymbolTable *table - Pointer to table structure to initialize
 Returns: int - TRUE if initialization succeeded, FALSE on memory error
 */
 int init_symbol_table(SymbolTable *table) {
-    table->symbols = malloc(INITIAL_SYMBOLS_CAPACITY * sizeof(Symbol));
+    table->index = NULL;
+    table->symbols = ALLOC(INITIAL_SYMBOLS_CAPACITY * sizeof(Symbol), ALLOC_SITE_SYMBOLS);
 
-    if (!table->symbols) {
+    if (!table->symbols || !allocate_index(table, INITIAL_SYMBOL_INDEX_CAPACITY)) {
         print_error(ERR_MEMORY_ALLOCATION, "Failed to initialize symbol table");
+        free_symbol_table(table);
         return FALSE;
     }
     table->count = 0;
@@ -191,33 +260,58 @@ Receives: SymbolTable *table - Table to deallocate
 */
 void free_symbol_table(SymbolTable *table) {
     safe_free((void**)&table->symbols);
+    safe_free((void**)&table->index);
 
     table->count = 0;
     table->capacity = 0;
+    table->index_capacity = 0;
+}
+
+/*
+Function to empty the symbol table for the next source, keeping its allocations.
+Receives: SymbolTable *table - Table to reset
+*/
+void reset_symbol_table(SymbolTable *table) {
+    unsigned int i;
+
+    for (i = 0; i < table->index_capacity; i++) {
+        table->index[i] = EMPTY_SLOT;
+    }
+    table->count = 0;
 }
 
 /*
-Function to locate a symbol by name in the table.
+Function to locate a symbol by name span in the table, through the hash index.
 Receives: SymbolTable *table - Table to search
-          const char *name - Symbol name to find
+          const char *name - Start of symbol name (not necessarily null terminated)
+          size_t length - Length of symbol name
 Returns: Symbol* - Pointer to found symbol or NULL
 */
-Symbol* find_symbol(SymbolTable *table, const char *name) {
-    int i;
+Symbol* find_symbol_span(SymbolTable *table, const char *name, size_t length) {
+    int position;
 
-    if (!table || !table->symbols || !name)
+    if (!table || !table->symbols || !table->index || !name)
         return NULL;
 
-    for (i = 0; i < table->count; i++) {
-        if (strcmp(table->symbols[i].name, name) == 0)
-            return &table->symbols[i];
-    }
-    return NULL;
+    position = table->index[find_slot(table, name, length)];
+
+    return (position == EMPTY_SLOT) ? NULL : &table->symbols[position];
+}
+
+/*
+Function to locate a symbol by name in the table, through the hash index.
+Receives: SymbolTable *table - Table to search
+          const char *name - Symbol name to find
+Returns: Symbol* - Pointer to found symbol or NULL
+*/
+Symbol* find_symbol(SymbolTable *table, const char *name) {
+    return name ? find_symbol_span(table, name, strlen(name)) : NULL;
 }
 
 /*
 Function to add a new symbol to the table.
 Handles memory allocation, conflict checking, automatic resizing.
+The hash index is kept at most half full, symbols array keeps insertion order.
 Receives: SymbolTable *table - Target symbol table
           const char *name - Symbol name
           int value - Numeric value
@@ -240,6 +334,10 @@ int add_symbol(SymbolTable *table, const char *name, int value, int type) {
         (!resize_symbol_table(table)))
         return FALSE;
 
+    if (((table->count + 1) * 2 > table->index_capacity) &&
+        (!resize_symbol_index(table)))
+        return FALSE;
+
     store_symbol(table, name, value, type);
 
     return TRUE;
@@ -303,12 +401,12 @@ int is_valid_label(char *label) {
 
 /*
 Function to check if first token in array is a label definition.
-Receives: char **tokens - Array of tokens
+Receives: const Token *tokens - Array of tokens
           int token_count - Number of tokens in array
 Returns: int - TRUE if first token contains label terminator, FALSE otherwise
 */
-int is_first_token_label(char **tokens, int token_count) {
-    return (token_count > 0 && strchr(tokens[0], LABEL_TERMINATOR));
+int is_first_token_label(const Token *tokens, int token_count) {
+    return (token_count > 0 && TOKEN_HAS_CHAR(tokens[0], LABEL_TERMINATOR));
 }
 
 /*
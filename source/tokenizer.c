@@ -8,89 +8,41 @@
 
 /* Inner STATIC methods */
 /* ==================================================================== */
-/*
-Function to expand the tokens array when capacity is reached.
-Receives: ParseState *state - Current parsing state structure
-Returns: int - TRUE if resize succeeded, FALSE on memory error
-*/
-static int resize_tokens_array(ParseState *state) {
-    char **new_tokens;
-    int new_capacity;
-
-    new_capacity = state->tokens_capacity * 2;
-    new_tokens = realloc(state->tokens, (new_capacity + 1) * sizeof(char *));
-
-    if (!new_tokens) {
-        print_error(ERR_MEMORY_ALLOCATION, "Failed to resize tokens array");
-        return FALSE;
-    }
-    state->tokens = new_tokens;
-    state->tokens_capacity = new_capacity;
-
-    return TRUE;
-}
-
 /*
 Function to finalize the current token being processed, and add it to tokens array.
 Receives: ParseState *state - Current parsing state structure
+          int end - Line position right after the last char of the token
 Returns: int - TRUE if token was successfully finalized, FALSE on error
 */
-static int finalize_token(ParseState *state) {
-    if ((state->token_index >= state->tokens_capacity) &&
-        (!resize_tokens_array(state)))
-        return FALSE;
-
-    state->current_token[state->char_index] = NULL_TERMINATOR;
-    state->tokens[state->token_index] = copy_string(state->current_token);
+static int finalize_token(ParseState *state, int end) {
+    state->tokens[state->token_index].start = state->line + state->token_start;
+    state->tokens[state->token_index].length = end - state->token_start;
 
-    if (!state->tokens[state->token_index]) {
-        print_error(ERR_MEMORY_ALLOCATION, NULL);
-        return FALSE;
-    }
     state->token_index++;
     (*state->token_count)++;
     state->in_token = 0;
-    state->char_index = 0;
 
     return TRUE;
 }
 
-/*
-Function to resize the current token buffer, if needed during character accumulation.
-Receives: char *current_token - Current token buffer
-          int char_index - Current position in token
-          int *current_token_size - Pointer to current size value
-Returns: char* - Resized buffer or NULL on failure
-*/
-static char *resize_token(char *current_token, int char_index, int *current_token_size) {
-    if (char_index >= *current_token_size - 1) {
-        *current_token_size *= 2;
-        current_token = realloc(current_token, *current_token_size);
-
-        if (!current_token) {
-            print_error(ERR_MEMORY_ALLOCATION, NULL);
-            return NULL;
-        }
-    }
-    return current_token;
-}
-
 /*
 Function to finalize the current token, if we're in the middle of processing one.
 Receives: ParseState *state - Current parsing state structure
+          int end - Line position right after the last char of the token
 Returns: int - TRUE if not in token or token finalized successfully
 */
-static int finalize_if_in_token(ParseState *state) {
-    return (!state->in_token || finalize_token(state));
+static int finalize_if_in_token(ParseState *state, int end) {
+    return (!state->in_token || finalize_token(state, end));
 }
 
 /*
 Function to handle comma character processing with validation.
 Receives: ParseState *state - Current parsing state structure
+          int position - Line position of the comma
 Returns: int - FALSE if illegal comma position, TRUE otherwise
 */
-static int handle_comma(ParseState *state) {
-    if (!finalize_if_in_token(state))
+static int handle_comma(ParseState *state, int position) {
+    if (!finalize_if_in_token(state, position))
         return FALSE;
 
     if ((state->token_index == 0) || (state->prev_was_comma)) {
@@ -103,40 +55,34 @@ static int handle_comma(ParseState *state) {
 }
 
 /*
-Function to process a regular character, adding it to current token.
+Function to process a regular character, extending the current token.
 Receives: ParseState *state - Current parsing state structure
-          char cha - Character to process
+          int position - Line position of the character
 Returns: int - TRUE if character processed successfully
 */
-static int handle_character(ParseState *state, char cha) {
+static int handle_character(ParseState *state, int position) {
     if (!state->in_token) {
         state->in_token = 1;
+        state->token_start = position;
         state->prev_was_comma = 0;
     }
-    state->current_token = resize_token(state->current_token, state->char_index, &state->current_token_size);
-
-    if (!state->current_token)
-        return FALSE;
-
-    state->current_token[state->char_index] = cha;
-    state->char_index++;
-
     return TRUE;
 }
 
 /*
 Function to handle strings, beginning and end.
 Receives: ParseState *state - Current parsing state structure
+          int position - Line position of the quote
 Returns: int - TRUE if quote processed successfully
 */
-static int handle_quote(ParseState *state) {
-    if (!handle_character(state, QUOTATION_CHAR))
+static int handle_quote(ParseState *state, int position) {
+    if (!handle_character(state, position))
         return FALSE;
 
     state->in_string = !state->in_string;
 
     if (!state->in_string)
-        return finalize_token(state);
+        return finalize_token(state, position + 1);
 
     return TRUE;
 }
@@ -144,116 +90,89 @@ static int handle_quote(ParseState *state) {
 /*
 Function to handle all character types of parsed tokens.
 Receives: ParseState *state - Current parsing state structure
-          char cha - Character to process
+          int position - Line position of the character to process
 Returns: int - TRUE if character processed successfully
 */
-static int process_character(ParseState *state, char cha) {
+static int process_character(ParseState *state, int position) {
+    char cha = state->line[position];
+
     if (state->in_string) {
         if (cha == QUOTATION_CHAR)
-            return handle_quote(state);
+            return handle_quote(state, position);
 
-        return handle_character(state, cha);
+        return handle_character(state, position);
     }
     if (isspace(cha))
-        return finalize_if_in_token(state);
+        return finalize_if_in_token(state, position);
 
     else if (cha == COMMA_CHAR)
-        return handle_comma(state);
+        return handle_comma(state, position);
 
     else if (cha == QUOTATION_CHAR)
-        return handle_quote(state);
+        return handle_quote(state, position);
 
     else
-        return handle_character(state, cha);
+        return handle_character(state, position);
 }
 
 /*
 Function to initialize parsing state structure before processing.
+The tokens array is bump-allocated from the arena at once: every token
+takes at least one char of the line, so tokens can't exceed the line length.
 Receives: ParseState *state - State structure to initialize
+          const char *line - Line to parse
+          size_t line_length - Length of the line to parse
+          Arena *arena - Line-scoped arena for tokens array
           int *token_count_ptr - Pointer to token counter
 Returns: int - TRUE if initialization succeeded
 */
-static int init_parsing(ParseState *state, int *token_count_ptr) {
+static int init_parsing(ParseState *state, const char *line, size_t line_length, Arena *arena, int *token_count_ptr) {
+    state->line = line;
     state->in_token = 0;
-    state->char_index = 0;
+    state->token_start = 0;
     state->token_index = 0;
-    state->current_token_size = INITIAL_TOKEN_SIZE;
-    state->tokens_capacity = INITIAL_TOKENS_CAPACITY;
     state->prev_was_comma = 0;
     state->in_string = 0;
     state->token_count = token_count_ptr;
     *state->token_count = 0;
 
-    state->current_token = malloc(state->current_token_size);
-    state->tokens = malloc((state->tokens_capacity + 1) * sizeof(char *)); 
+    state->tokens = arena_alloc(arena, (line_length + 1) * sizeof(Token));
 
-    if (!state->current_token || !state->tokens) {
+    if (!state->tokens) {
         print_error(ERR_MEMORY_ALLOCATION, NULL);
-
-        safe_free((void**)&state->current_token);
-        safe_free((void**)&state->tokens);
-
         return FALSE;
     }
     return TRUE;
 }
 
-/*
-Function to clean up allocated memory in parsing state structure.
-Receives: ParseState *state - State structure to clean up
-*/
-static void cleanup_parse_state(ParseState *state) {
-    safe_free((void**)&state->current_token);
-    free_tokens(state->tokens, state->token_index);
-}
-
 /* Outer methods */
 /* ==================================================================== */
-/*
-Function to free an array of tokens and all contained strings.
-Receives: char **tokens - Array of token strings to free
-          int token_count - Number of tokens in array
-*/
-void free_tokens(char **tokens, int token_count) {
-    int i;
-
-    if (!tokens)
-        return;
-
-    for (i = 0; i < token_count; i++) {
-        safe_free((void**)&tokens[i]);
-    }
-    safe_free((void**)&tokens);
-}
-
 /*
 Function to parse a line of input into an array of tokens.
-Receives: const char *line - Input line to parse
-          char ***tokens_ptr - Output pointer for tokens array
+Tokens are views into the line (no chars are copied), and stay valid as long as the line does.
+The tokens array lives in the arena, and is released by resetting it.
+Receives: const char *line - Start of input line to parse (not necessarily null terminated)
+          size_t line_length - Length of the line
+          Arena *arena - Line-scoped arena for tokens array
+          Token **tokens_ptr - Output pointer for tokens array
           int *token_count - Output pointer for token count
 Returns: int - TRUE if parsing succeeded, FALSE on error
 */
-int parse_tokens(const char *line, char ***tokens_ptr, int *token_count) {
-    const char *p = line;
+int parse_tokens(const char *line, size_t line_length, Arena *arena, Token **tokens_ptr, int *token_count) {
+    int position;
     ParseState state;
     *tokens_ptr = NULL; 
 
-    if (!init_parsing(&state, token_count))
+    if (!init_parsing(&state, line, line_length, arena, token_count))
         return FALSE;
 
-    while (*p) {
-        if (!process_character(&state, *p++)) {
-            cleanup_parse_state(&state);
+    for (position = 0; position < (int)line_length; position++) {
+        if (!process_character(&state, position))
             return FALSE;
-        }
     }
-    if (!finalize_if_in_token(&state)) {
-        cleanup_parse_state(&state);
+    if (!finalize_if_in_token(&state, position))
         return FALSE;
-    }
-    safe_free((void**)&state.current_token);
 
-    state.tokens[state.token_index] = NULL; 
     *tokens_ptr = state.tokens;
 
     return TRUE;
@@ -5,6 +5,8 @@
 
 #include "utils.h"
 #include "errors.h"
+#include "diagnostics.h"
+#include "alloc_tracking.h"
 
 /*
 Function to create a deep copy of a source string.
@@ -19,7 +21,7 @@ char *copy_string(const char *src) {
         return NULL;
 
     length = strlen(src);
-    copy = malloc(length + 1);
+    copy = ALLOC(length + 1, ALLOC_SITE_OTHER);
 
     if (copy)
         strcpy(copy, src);
@@ -47,8 +49,10 @@ int bounded_string_copy(char *dest, const char *src, size_t dest_size, const cha
         strncpy(dest, src, dest_size - 1);
         dest[dest_size - 1] = NULL_TERMINATOR;
 
-        if (context)
-            printf("Warning: String truncated in %s%c", context, NEWLINE);
+        if (context) {
+            print_message("Warning: String truncated in %s%c", context, NEWLINE);
+            record_diagnostic(DIAGNOSTIC_WARNING, "String truncated", context, -1, NO_LINE);
+        }
 
         return FALSE;
     }
@@ -98,15 +102,17 @@ void preprocess_line(char *line) {
 }
 
 /*
-Function to print an error message to stdout with optional context.
+Function to print an error message with optional context (see print_message).
 Receives: const char *message - Main error message
           const char *context - Additional context (optional)
 */
 void print_error(const char *message, const char *context) {
     if (context)
-        printf("Error: %s (%s)%c", message, context, NEWLINE);
+        print_message("Error: %s (%s)%c", message, context, NEWLINE);
     else
-        printf("Error: %s%c", message, NEWLINE);
+        print_message("Error: %s%c", message, NEWLINE);
+
+    record_diagnostic(DIAGNOSTIC_ERROR, message, context, -1, NO_LINE);
 }
 
 /*
@@ -117,9 +123,11 @@ Receives: const char *message - Main error message
 */
 void print_line_error(const char *message, const char *context, int line_num) {
     if (context)
-        printf("Error: %s (%s) at line %d%c", message, context, line_num, NEWLINE);
+        print_message("Error: %s (%s) at line %d%c", message, context, line_num, NEWLINE);
     else
-        printf("Error: %s at line %d%c", message, line_num, NEWLINE);
+        print_message("Error: %s at line %d%c", message, line_num, NEWLINE);
+
+    record_diagnostic(DIAGNOSTIC_ERROR, message, context, -1, line_num);
 }
 
 /*
@@ -130,9 +138,34 @@ Receives: const char *message - Warning message
 */
 void print_line_warning(const char *message, const char *context, int line_num) {
     if (context)
-        printf("Warning: %s (%s) at line %d%c", message, context, line_num, NEWLINE);
+        print_message("Warning: %s (%s) at line %d%c", message, context, line_num, NEWLINE);
     else
-        printf("Warning: %s at line %d%c", message, line_num, NEWLINE);
+        print_message("Warning: %s at line %d%c", message, line_num, NEWLINE);
+
+    record_diagnostic(DIAGNOSTIC_WARNING, message, context, -1, line_num);
+}
+
+/*
+Function to print an error message, with a (not null terminated) context span.
+Receives: const char *message - Main error message
+          const char *context - Start of context span
+          int length - Length of context span
+*/
+void print_span_error(const char *message, const char *context, int length) {
+    print_message("Error: %s (%.*s)%c", message, length, context, NEWLINE);
+    record_diagnostic(DIAGNOSTIC_ERROR, message, context, length, NO_LINE);
+}
+
+/*
+Function to print a line-specific error message, with a (not null terminated) context span.
+Receives: const char *message - Main error message
+          const char *context - Start of context span
+          int length - Length of context span
+          int line_num - Source line number where error occurred
+*/
+void print_line_span_error(const char *message, const char *context, int length, int line_num) {
+    print_message("Error: %s (%.*s) at line %d%c", message, length, context, line_num, NEWLINE);
+    record_diagnostic(DIAGNOSTIC_ERROR, message, context, length, line_num);
 }
 
 /*
@@ -141,7 +174,33 @@ Receives: void **ptr - Pointer to pointer that needs freeing
 */
 void safe_free(void **ptr) {
     if (ptr && *ptr) {
-        free(*ptr);
+        FREE(*ptr);
         *ptr = NULL;
     }
+}
+
+/*
+Function to compute a 32-bit FNV-1a hash of a string span, for hash table indexing.
+Receives: const char *str - Start of the span (not necessarily null terminated)
+          size_t length - Amount of chars to hash
+Returns: unsigned long - Hash value (fits in 32 bits)
+*/
+unsigned long hash_span(const char *str, size_t length) {
+    unsigned long hash = FNV_OFFSET_BASIS;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash = (hash * FNV_PRIME) & HASH_MASK;
+    }
+    return hash;
+}
+
+/*
+Function to compute a 32-bit FNV-1a hash of a string, for hash table indexing.
+Receives: const char *str - String to hash
+Returns: unsigned long - Hash value (fits in 32 bits)
+*/
+unsigned long hash_string(const char *str) {
+    return hash_span(str, strlen(str));
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "keywords.h"
+
+/*
+Generator of headers/keyword_slots.h, the perfect hash table of the reserved keywords (make keyword-slots).
+Builds the table from the keywords collection & keyword_hash of keywords.c, and prints the header to stdout.
+Fails if the instruction keywords no longer match instruction_set of instructions.c.
+*/
+
+#define SLOTS_PER_ROW 16
+
+/* App main method */
+/* ==================================================================== */
+/*
+Main entry point to the generator.
+Returns: int - 0 if the header was printed, 1 if the instruction keywords are stale or two keywords share a slot
+*/
+int main(void) {
+    signed char slots[KEYWORD_SLOTS];
+    int i;
+
+    if (!check_instruction_keywords()) {
+        fprintf(stderr, "Error: Instruction keywords differ from instruction_set (update keywords in source/keywords.c)%c", NEWLINE);
+        return 1;
+    }
+    if (!build_keyword_slots(slots)) {
+        fprintf(stderr, "Error: Keywords collide in the perfect hash (retune keyword_hash in source/keywords.c)%c", NEWLINE);
+        return 1;
+    }
+    printf("#ifndef KEYWORD_SLOTS_H%c#define KEYWORD_SLOTS_H%c%c", NEWLINE, NEWLINE, NEWLINE);
+    printf("#include \"keywords.h\"%c%c", NEWLINE, NEWLINE);
+    printf("/*%cPerfect hash table: keyword index per hash slot, -1 for empty slots.%c", NEWLINE, NEWLINE);
+    printf("Generated by tools/gen_keyword_slots.c (make keyword-slots), do not edit.%c*/%c", NEWLINE, NEWLINE);
+    printf("static const signed char keyword_slots[KEYWORD_SLOTS] = {");
+
+    for (i = 0; i < KEYWORD_SLOTS; i++) {
+        if ((i % SLOTS_PER_ROW) == 0)
+            printf("%c   ", NEWLINE);
+
+        printf(" %d%s", slots[i], (i + 1 < KEYWORD_SLOTS) ? "," : "");
+    }
+    printf("%c};%c%c#endif", NEWLINE, NEWLINE, NEWLINE);
+
+    return 0;
+}
\ No newline at end of file